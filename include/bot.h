@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdio.h>
+#include "game.h"
+
+// a line protocol for playing from another process. a command per line, answered by a line
+// `<result> <state> <mines> <rows> <cols>`, result being `ok` or `ignored` (a move `game_step` turned down), or by
+// `error <reason>`. the commands are
+//   open <row> <col>, flag <row> <col>, chord <row> <col>   make a move, see `game_step`
+//   new [classic | advanced | expert | <rows> <cols> <mines>]   starts over, on a board of the same size by default
+//   board   the answer is followed by a line per row, a character per cell: `.` hidden, `F` flagged, `?` questioned,
+//           `*` a revealed mine, `0` to `8` the mines around a revealed cell
+//   quit
+enum bot_reply {
+  BOT_IGNORED,  // nothing changed
+  BOT_MOVED,
+  BOT_STARTED,  // a new game, possibly on a board of another size
+  BOT_QUIT,     // asked to, at the end of the input, or the new game couldn't be created
+};
+
+// reads a command from `in`, runs it on `game` and answers it on `out`
+enum bot_reply bot_serve(struct game *restrict game, FILE *restrict in, FILE *restrict out);
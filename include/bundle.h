@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * @brief a resource decoded at build time. `pixels` holds `w * h` RGBA pixels. `path` is the path of the png it was
+ * made of, relative to the project root
+ */
+struct bundle_entry {
+  char const *path;
+  int w;
+  int h;
+  unsigned char const *pixels;
+};
+
+// generated by tools/bundler.c
+extern struct bundle_entry const bundle_entries[];
+extern size_t const bundle_entries_amount;
@@ -4,6 +4,8 @@
 #define RED 240, 0, 0
 #define BLACK 0, 0, 0
 #define GREY 120, 120, 120
+#define WHITE 255, 255, 255
+#define GREEN 0, 160, 0
 
 // numbers colors
 #define NUMERIC_BLUE 65, 105, 255
@@ -1,7 +1,12 @@
 #pragma once
 
-#include <time.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "board.h"
+#include "no_guess.h"
+
+#define NSEC_PER_SEC 1000000000ull
 
 enum game_state {
   STATE_INVALID,
@@ -10,22 +15,83 @@ enum game_state {
   STATE_LOST,
 };
 
+// a stopwatch over the monotonic clock, in nanoseconds
 struct game_clock {
-  time_t start;
-  time_t end;
+  uint64_t resumed;  // when the clock last started running
+  uint64_t elapsed;  // the time counted before `resumed`
+  bool running;
+};
+
+enum move_kind {
+  MOVE_REVEAL,
+  MOVE_MARK,
+  MOVE_CHORD,
+  MOVE_KIND_AMOUNT,
+};
+
+struct move {
+  uint64_t time;  // the game's elapsed time the move was made at
+  size_t row;
+  size_t col;
+  enum move_kind kind;
+};
+
+// a move on the cell at (row, col), whoever makes it: the mouse, the keyboard or a bot
+struct game_action {
+  enum move_kind kind;
+  size_t row;
+  size_t col;
+};
+
+struct move_log {
+  struct move *moves;
+  size_t size;
+  size_t capacity;
 };
 
 struct game {
   enum game_state state;
   struct game_clock clock;
+  struct move_log log;
   struct board board;
 
   int mines;
-  int prev_buttons;  // previous mouse button
+
+  // when set, restarts and resets deal boards that can be cleared without a guess and open their start cell. it's
+  // borrowed, see `no_guess_create`
+  struct no_guess *no_guess;
 };
 
 struct game game_create(enum difficulty difficulty);
 
+struct game game_create_custom(size_t rows, size_t cols, size_t mines);
+
+// restarts the game on a board of that difficulty. see `no_guess` above
 struct game game_restart(struct game *restrict game, enum difficulty difficulty);
 
+// restarts the game on a board of the same size and mine count. see `no_guess` above
+struct game game_reset(struct game *restrict game);
+
 void game_destroy(struct game *restrict game);
+
+// nanoseconds since an arbitrary point in the past, unaffected by changes of the wall clock
+uint64_t game_clock_now(void);
+
+// stops the game's clock. does nothing if it's already stopped
+void game_pause(struct game *restrict game);
+
+// starts the game's clock again. does nothing if it's already running
+void game_resume(struct game *restrict game);
+
+// the time the game has been played for so far, in nanoseconds
+uint64_t game_elapsed(struct game const *restrict game);
+
+// appends a move, stamped with the game's elapsed time, to the game's log. returns false if it couldn't grow the log
+bool game_record_move(struct game *restrict game, enum move_kind kind, size_t row, size_t col);
+
+// plays `action` and records it. opening a mine loses the game and opening the last safe cell wins it, either way every
+// mine is revealed. marking cycles an unrevealed cell's mark and keeps `mines` counting the flags down. chording opens
+// the neighbours of a revealed cell once it has as many flags around it as mines. returns false if the move was
+// ignored: the game is over, the cell is out of bounds, or the move doesn't apply to it. otherwise the board's changes
+// hold the cells the move revealed or marked, see `board_changes`
+bool game_step(struct game *restrict game, struct game_action action);
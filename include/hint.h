@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "board.h"
+
+/*
+  finds the safest cell to open on a thread of its own, so a long solve never holds a frame back. the game publishes
+  the board after every move, which cancels the hint in flight, and asks for hints on the latest board published. the
+  worker hands them back through a lock free ring with a single producer and a single consumer
+*/
+struct hints;
+
+struct hint {
+  uint64_t sequence;  // the version of the board it was found on
+  size_t row;
+  size_t col;
+  double mine;  // the chance of a mine under the cell, 0 if it's known to be safe
+};
+
+/* starts the worker. NULL if it couldn't */
+struct hints *hints_create(void);
+
+/* cancels the hint in flight and waits for the worker to stop */
+void hints_destroy(struct hints *restrict hints);
+
+/* to be called after every move on the thread asking for hints, before the board's changes are cleared. returns false
+ * if the board couldn't be published, hints are found on the last one published until it is */
+bool hints_publish(struct hints *restrict hints, struct board const *restrict board);
+
+/* asks for a hint on the board last published */
+void hints_request(struct hints *restrict hints);
+
+/* takes the hint found on the board last published, if there's one. hints found on earlier boards are dropped. it never
+ * blocks */
+bool hints_poll(struct hints *restrict hints, struct hint *restrict hint);
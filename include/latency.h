@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "game.h"
+#include "input.h"
+#include "window.h"
+
+// latencies are counted in buckets of powers of two nanoseconds, the last bucket holds all the longer ones
+#define LATENCY_BUCKETS 32
+
+// the moves waiting for the frame that shows them. the ones past it go untimed
+#define LATENCY_PENDING 256
+
+// what a move's latency is held against, a frame at 60hz
+#define LATENCY_FRAME (NSEC_PER_SEC / 60)
+
+struct latency_histogram {
+  size_t count;
+  size_t within_frame;  // moves shown within `LATENCY_FRAME`
+  uint64_t min;
+  uint64_t max;
+  uint64_t total;
+  size_t buckets[LATENCY_BUCKETS];  // bucket `i` holds latencies within [2^i, 2^(i + 1)) nanoseconds
+};
+
+// the time from reading an input event in the main loop to `tigrUpdate` presenting the first frame that shows the move
+// it made, per kind of move
+struct latency {
+  struct latency_histogram moves[MOVE_KIND_AMOUNT];
+
+  size_t pending_amount;
+  struct latency_pending {
+    enum move_kind kind;
+    uint64_t read;
+  } pending[LATENCY_PENDING];
+};
+
+// tags the moves `game` made since its log held `moves` moves, in response to an event read at `read`
+void latency_tag(struct latency *restrict latency, struct game const *restrict game, size_t moves, uint64_t read);
+
+// the frame showing every tagged move was presented at `presented`
+void latency_presented(struct latency *restrict latency, uint64_t presented);
+
+// prints a histogram per kind of move
+void latency_report(struct latency const *restrict latency, FILE *restrict out);
+
+// input made up for timing the game without anyone at the mouse
+struct latency_script {
+  size_t clicks;   // the clicks left to make
+  uint64_t state;  // picks the cells and buttons, a fixed seed replays the same clicks
+};
+
+// queues a click with a random button on a random visible cell, or starts a new game once it's over. returns false
+// once the script made all its clicks
+bool latency_script_step(struct latency_script *restrict script,
+                         struct window *restrict window,
+                         struct game const *restrict game,
+                         struct input_queue *restrict input);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define NO_GUESS_MAGIC "MSNG"
+#define NO_GUESS_VERSION 1
+
+// boards of more cells are always dealt at random, each worker would hold a board and a solver of their size
+#define NO_GUESS_CELLS (128 * 128)
+
+/*
+  deals boards that can be cleared without a guess from their middle cell, see `solver_clears`. worker threads, one per
+  processor, try seeds in parallel and keep a shelf of the seeds that passed for every board size asked for, so a deal
+  takes one off the shelf rather than waiting for a search. a search the shelf has no room left for is cancelled. the
+  shelves can be kept in a file from a run to the next
+*/
+struct no_guess;
+
+/**
+ * @brief the first bytes of the file the shelves are kept in, followed by `amount` entries. everything is stored in the
+ * host's byte order like a snapshot's
+ */
+struct no_guess_header {
+  char magic[4];
+  uint32_t version;
+  uint64_t amount;
+};
+
+struct no_guess_entry {
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t mines;
+  uint64_t seed;
+};
+
+/* starts the workers with the shelves kept at `path`, or empty ones if it's NULL or there's no (valid) file there.
+ * NULL if it couldn't */
+struct no_guess *no_guess_create(char const *restrict path);
+
+/* cancels the searches in flight, waits for the workers to stop and keeps the shelves at the path it was created
+ * with */
+void no_guess_destroy(struct no_guess *restrict no_guess);
+
+/* a seed for `board_reset_seeded` dealing a board of that size that can be cleared without a guess. if there's none on
+ * the shelf yet it waits for the workers a little, and returns false if they don't find one by then, if they gave up
+ * on the size or if it doesn't fit. the shelf fills up in the background either way */
+bool no_guess_deal(struct no_guess *restrict no_guess,
+                   size_t rows,
+                   size_t cols,
+                   size_t mines,
+                   uint64_t *restrict seed);
+
+/* whether boards of that size are searched at all, see `NO_GUESS_CELLS` */
+bool no_guess_fits(size_t rows, size_t cols);
+
+/* the cell the boards it deals are cleared from, a zero */
+void no_guess_start(size_t rows, size_t cols, size_t *restrict row, size_t *restrict col);
@@ -1,5 +1,6 @@
 #pragma once
 
+// assets are pushed in this order, so each id doubles as the asset_handle of its (first) asset
 enum asset_ids {
   ASSET_TILE = 0,
   ASSET_FLAG,
@@ -20,16 +21,26 @@ enum asset_ids {
   ASSET_SIX,
   ASSET_SEVEN,
   ASSET_EIGHT,
+  ASSET_CURSOR,  // outlines the cell the keyboard acts on
+  ASSET_HINT,    // rings the safest cell to open, once a hint is asked for
   ASSET_CLOCK,
   ASSET_MINES_COUNTER,
+  ASSET_GLYPH_ZERO,  // prebuilt glyphs the clock and the mines counter are composited from
+  ASSET_GLYPH_NINE = ASSET_GLYPH_ZERO + 9,
+  ASSET_GLYPH_COLON,
+  ASSET_GLYPH_MINUS,
   ASSET_EMPTY,
   ASSET_AMOUNT,
+  // the board assets (ASSET_TILE - ASSET_HINT) downscaled for each zoom level past the first. the copy of `id` for
+  // `zoom` has the id `ASSET_AMOUNT * zoom + id`
+  ASSET_ZOOMED = ASSET_AMOUNT,
 };
 
 enum panels {
   PANEL_NAVBAR,
   PANEL_STATS,
   PANEL_BOARD,
+  PANEL_MINIMAP,
   PANEL_MENU,
   PANEL_AMOUNT,
 };
@@ -45,7 +56,40 @@ enum panels_heights {
 // font
 #define FONT_PATH "resources/font/retron.png"
 
+// the game in progress is saved here on exit and resumed from here on start
+#define SNAPSHOT_PATH "minesweeper.snapshot"
+
+// when set, every frame that changes is recorded under the `$MINESWEEPER_CAPTURE` prefix. as numbered pngs, or as raw
+// rgba plus an index when `$MINESWEEPER_CAPTURE_FORMAT` is `raw`. see `capture_create`
+#define CAPTURE_ENV "MINESWEEPER_CAPTURE"
+#define CAPTURE_FORMAT_ENV "MINESWEEPER_CAPTURE_FORMAT"
+#define CAPTURE_LEVEL 1
+// frames buffered for the encoder before new ones are dropped
+#define CAPTURE_SLOTS 8
+
+// when set, the time from reading a click (or key) to showing the move it made is reported on exit to the file
+// `$MINESWEEPER_LATENCY` names, or to stdout if it's `-`
+#define LATENCY_ENV "MINESWEEPER_LATENCY"
+// when set, `$MINESWEEPER_SCRIPT` clicks on random cells play a classic game (or a custom one) instead of the mouse.
+// the game quits once they're made and reports the latency to stdout unless told otherwise
+#define SCRIPT_ENV "MINESWEEPER_SCRIPT"
+#define SCRIPT_SEED 0x5eed
+// when set, a bot plays through stdin and stdout instead of the mouse, see bot.h. the game is drawn every
+// `$MINESWEEPER_BOT` moves, or never opens a window if it's 0
+#define BOT_ENV "MINESWEEPER_BOT"
+// when set, new games are dealt boards that can be cleared without a guess, their start cell open. the seeds found are
+// kept in the file `$MINESWEEPER_NO_GUESS` names from a run to the next, unless it's empty. see no_guess.h
+#define NO_GUESS_ENV "MINESWEEPER_NO_GUESS"
+
 // margin
 #define LEFT_MARGIN 20
 #define RIGHT_MARGIN 20
 #define TILE_SIZE 20
+
+// the board is drawn with TILE_SIZE >> zoom pixel tiles, zoom being [0, ZOOM_LEVELS)
+#define ZOOM_LEVELS 3
+
+// the most pixels the minimap may take, its border included. it's shown in the bottom right corner of the board once
+// the board no longer fits the window
+#define MINIMAP_WIDTH 160
+#define MINIMAP_HEIGHT 90
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "tigr.h"
+
+// a directory laid out like resources/ (assets/..., font/...). pngs found there take precedence over the bundled ones
+#define RESOURCES_ENV "MINESWEEPER_RESOURCES"
+
+#define RESOURCES_PREFIX "resources/"
+
+/**
+ * @brief loads the resource at `path` (e.g. "resources/assets/tile"). looks in $MINESWEEPER_RESOURCES first, then in
+ * the resources bundled into the binary and finally decodes `path` relative to the working directory
+ */
+Tigr *resource_load(char const *path);
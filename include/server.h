@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+// the protocol `minesweeper-server` speaks over a unix domain socket. every connection plays a game of its own,
+// classic to begin with. a client sends fixed size requests and gets a response per request, in order. requests may
+// be pipelined. both ends share the machine, so every field is in its byte order
+
+// where the server listens unless it's given another path
+#define SERVER_SOCKET "minesweeper.sock"
+
+// cell indices are row major and share a word with the cell's code, which caps the size of a board
+#define SERVER_CODE_BITS 4
+#define SERVER_MAX_CELLS (UINT32_C(1) << (32 - SERVER_CODE_BITS))
+
+enum server_op {
+  SERVER_OPEN,   // (row, col)
+  SERVER_FLAG,   // (row, col), cycles the mark
+  SERVER_CHORD,  // (row, col)
+  SERVER_NEW,    // (rows, cols, mines), all of them 0 for another board of the same size
+  SERVER_OPS,
+};
+
+struct server_request {
+  uint8_t op;  // an `enum server_op`
+  uint8_t reserved[3];
+  uint32_t args[3];
+};
+
+enum server_status {
+  SERVER_OK,
+  SERVER_IGNORED,  // the move doesn't apply, see `game_step`
+  SERVER_ERROR,    // an unknown op or a board that can't be created
+};
+
+// followed by `cells` updates, a `uint32_t` each: the index of a cell that changed since the last response shifted
+// left by SERVER_CODE_BITS, or'ed with its `enum server_cell`. a new game hides every cell without listing them
+struct server_response {
+  uint8_t status;  // an `enum server_status`
+  uint8_t state;   // an `enum game_state`
+  uint16_t reserved;
+  int32_t mines;  // the mines left to flag
+  uint32_t rows;
+  uint32_t cols;
+  uint32_t cells;
+};
+
+enum server_cell {
+  SERVER_CELL_ZERO,  // a revealed cell, `SERVER_CELL_ZERO + n` with n mines around it
+  SERVER_CELL_MINE = 9,
+  SERVER_CELL_FLAG,
+  SERVER_CELL_QUESTION,
+  SERVER_CELL_HIDDEN,
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "game.h"
+
+#define SNAPSHOT_MAGIC "MSSN"
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_PLANES 4
+#define SNAPSHOT_WORD_BITS 64
+
+/**
+ * @brief the first bytes of a snapshot. it's followed by `SNAPSHOT_PLANES` row major bitsets, each row padded to
+ * a whole amount of `SNAPSHOT_WORD_BITS` bit words: the mines, the revealed cells and the low and high bits of the
+ * marks (see `board_pack`).
+ * everything is stored in the host's byte order - a snapshot written by a host of the other byte order fails the
+ * version check
+ */
+struct snapshot_header {
+  char magic[4];
+  uint32_t version;
+
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t mines;
+  uint64_t seed;
+
+  uint64_t elapsed;  // nanoseconds
+  int32_t mines_left;
+  uint32_t difficulty;
+};
+
+/**
+ * @brief writes `game` to `path` with a single write. returns false on failure, in which case `path` may be truncated
+ */
+bool snapshot_save(struct game const *restrict game, char const *restrict path);
+
+/**
+ * @brief restores the game saved at `path` with a single read. its state is `STATE_INVALID` if there's no (valid)
+ * snapshot at `path`
+ */
+struct game snapshot_load(char const *restrict path);
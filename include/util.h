@@ -5,6 +5,7 @@
 #include "assets.h"
 #include "board.h"
 #include "game.h"
+#include "input.h"
 #include "mouse_event.h"
 #include "panel.h"
 #include "tigr.h"
@@ -16,8 +17,6 @@ struct assets_manager *create_assets(struct assets_manager *restrict am, TigrFon
 
 struct window *create_window(struct game *restrict game, struct assets_manager *restrict am, TigrFont *restrict font);
 
-void reveal_mines(struct board *restrict board);
-
 void draw_window(struct window *restrict window,
                  struct game *restrict game,
                  struct assets_manager *restrict am,
@@ -29,10 +28,42 @@ void on_mouse_click(struct window *restrict window,
                     TigrFont *restrict font,
                     struct mouse_event mouse_event);
 
+/**
+ * @brief catches the window up with a game started elsewhere than the window, possibly on a board of another size
+ */
+void on_game_replaced(struct window *restrict window,
+                      struct game *restrict game,
+                      struct assets_manager *restrict am,
+                      TigrFont *restrict font);
+
+/**
+ * @brief moves the cursor (arrows, page up/down, home), plays the cell under it (space/enter opens, f flags, c chords)
+ * and zooms (-/+) the board. the viewport follows the cursor. f2 starts a new game, h asks for the safest cell to open
+ */
+void on_key(struct window *restrict window,
+            struct game *restrict game,
+            struct assets_manager *restrict am,
+            TigrFont *restrict font,
+            int key);
+
+/**
+ * @brief reacts to a single press or release, see `struct input_queue`
+ */
+void on_input(struct window *restrict window,
+              struct game *restrict game,
+              struct assets_manager *restrict am,
+              TigrFont *restrict font,
+              struct input_event const *restrict event);
+
 void on_mouse_hover(struct window *restrict window,
                     struct game *restrict game,
                     struct assets_manager *restrict am,
                     TigrFont *restrict font,
                     struct mouse_event mouse_event);
 
+/**
+ * @brief stops the thread finding hints, if one was ever asked for
+ */
+void destroy_hints(void);
+
 void alert(TigrFont *restrict font, char const *fmt, ...);
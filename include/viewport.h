@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief the part of the board that is drawn. the board panel only ever holds `rows x cols` components, one per
+ * visible cell, which are rebound to other cells as one scrolls. zooming out shrinks the cells (`viewport_cell_size`)
+ * so more of them fit
+ */
+struct viewport {
+  size_t board_rows;
+  size_t board_cols;
+
+  unsigned width;  // the pixels available to the board
+  unsigned height;
+  unsigned zoom;  // [0, ZOOM_LEVELS)
+
+  size_t row;  // the board cell drawn at the top left corner
+  size_t col;
+  size_t rows;  // the amount of board cells drawn
+  size_t cols;
+};
+
+/**
+ * @brief a viewport onto the top left corner of a `board_rows x board_cols` board, fitting within `width x height`
+ * pixels
+ */
+struct viewport viewport_create(size_t board_rows, size_t board_cols, unsigned width, unsigned height, unsigned zoom);
+
+/**
+ * @brief the width (and height) of a cell in pixels
+ */
+unsigned viewport_cell_size(struct viewport const *restrict viewport);
+
+/**
+ * @brief moves the viewport by `rows` and `cols` cells, clamped to the board. returns whether it moved
+ */
+bool viewport_scroll(struct viewport *restrict viewport, ptrdiff_t rows, ptrdiff_t cols);
+
+/**
+ * @brief changes the zoom level while keeping the cell at the center of the viewport (roughly) in place. one can't zoom
+ * out once the whole board is visible. returns whether the level changed, in which case the amount of visible cells
+ * likely changed as well
+ */
+bool viewport_zoom(struct viewport *restrict viewport, unsigned zoom);
+
+/**
+ * @brief maps the index of a visible cell (row major within the viewport) to its board coordinates. returns false if
+ * there's no such visible cell
+ */
+bool viewport_cell(struct viewport const *restrict viewport, size_t idx, size_t *restrict row, size_t *restrict col);
@@ -0,0 +1,56 @@
+#include "arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALIGNMENT sizeof(union arena_align)
+
+size_t arena_footprint(size_t size) {
+  if (size > SIZE_MAX - (ALIGNMENT - 1)) return SIZE_MAX;  // overflow
+
+  return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+struct arena *arena_create(size_t capacity) {
+  capacity = arena_footprint(capacity);
+  if (capacity > SIZE_MAX - sizeof(struct arena)) return NULL;  // overflow
+
+  struct arena *arena = malloc(sizeof *arena + capacity);
+  if (!arena) return NULL;
+
+  *arena = (struct arena){.capacity = capacity, .size = 0};
+  return arena;
+}
+
+void arena_destroy(struct arena *restrict arena) {
+  if (!arena) return;
+
+  free(arena);
+}
+
+void *arena_alloc(struct arena *restrict arena, size_t size) {
+  if (!arena) return NULL;
+
+  size_t footprint = arena_footprint(size);
+  if (footprint > arena->capacity - arena->size) return NULL;
+
+  void *memory = (unsigned char *)arena->memory + arena->size;
+  arena->size += footprint;
+  return memory;
+}
+
+void *arena_calloc(struct arena *restrict arena, size_t count, size_t size) {
+  if (size && count > SIZE_MAX / size) return NULL;  // overflow
+
+  void *memory = arena_alloc(arena, count * size);
+  if (!memory) return NULL;
+
+  memset(memory, 0, count * size);
+  return memory;
+}
+
+void arena_reset(struct arena *restrict arena) {
+  if (!arena) return;
+
+  arena->size = 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+
+// every allocation is aligned for any of these
+union arena_align {
+  long double ld;
+  long long ll;
+  void *ptr;
+  void (*fn)(void);
+};
+
+/**
+ * @brief a fixed size bump allocator. allocations are carved out of a single block and are only ever released all at
+ * once, by destroying (or resetting) the arena. pointers handed out remain valid until then
+ */
+struct arena {
+  size_t capacity;
+  size_t size;
+  union arena_align memory[];
+};
+
+/**
+ * @brief creates an arena capable of holding `capacity` bytes (including alignment padding)
+ */
+struct arena *arena_create(size_t capacity);
+
+/**
+ * @brief frees the arena and everything allocated from it
+ */
+void arena_destroy(struct arena *restrict arena);
+
+/**
+ * @brief returns `size` bytes of uninitialized memory or NULL if the arena is exhausted
+ */
+void *arena_alloc(struct arena *restrict arena, size_t size);
+
+/**
+ * @brief same as `arena_alloc` for `count` elements of `size` bytes each, zeroed
+ */
+void *arena_calloc(struct arena *restrict arena, size_t count, size_t size);
+
+/**
+ * @brief releases all allocations at once. the memory is kept for reuse
+ */
+void arena_reset(struct arena *restrict arena);
+
+/**
+ * @brief the amount of bytes `size` occupies once allocated from an arena. used to compute an arena's capacity
+ * upfront
+ */
+size_t arena_footprint(size_t size);
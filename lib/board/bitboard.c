@@ -0,0 +1,482 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board.h"
+#include "board_common.h"
+
+/*
+  the bitboard engine. the board is a set of row major bitsets, each row padded to `board_row_words`, the first ones
+  laid out exactly like `board_pack`'s. the zero plane holds the cells with no mine on or around them, which is all
+  opening a region needs: the region is dilated within the zero plane a word (64 cells) at a time, then the ring of
+  cells around it is revealed
+*/
+
+enum plane {
+  PLANE_MINES,
+  PLANE_REVEALED,
+  PLANE_MARK_LOW,
+  PLANE_MARK_HIGH,
+  PLANE_ZERO,
+  PLANE_REGION,  // the region `board_open` is growing, zeroed in between calls
+  PLANE_AMOUNT,
+  PLANE_PACKED = PLANE_ZERO,  // the amount of planes `board_pack` writes
+};
+
+static size_t plane_size(struct board const *restrict board) {
+  return board->rows * board_row_words(board);
+}
+
+static uint64_t *row_of(struct board const *restrict board, enum plane plane, size_t row) {
+  return &board->bits[plane * plane_size(board) + row * board_row_words(board)];
+}
+
+static uint64_t *word_of(struct board const *restrict board, enum plane plane, size_t row, size_t col) {
+  return &row_of(board, plane, row)[col / BOARD_WORD_BITS];
+}
+
+static uint64_t bit(size_t col) {
+  return (uint64_t)1 << col % BOARD_WORD_BITS;
+}
+
+static bool test(struct board const *restrict board, enum plane plane, size_t row, size_t col) {
+  return *word_of(board, plane, row, col) & bit(col);
+}
+
+static enum mark mark_of(struct board const *restrict board, size_t row, size_t col) {
+  return test(board, PLANE_MARK_LOW, row, col) | test(board, PLANE_MARK_HIGH, row, col) << 1;
+}
+
+// the bits of a row's word that stand for cells, the last word of a row is padded
+static uint64_t word_mask(struct board const *restrict board, size_t word) {
+  size_t rest = board->cols % BOARD_WORD_BITS;
+  if (word + 1 < board_row_words(board) || !rest) return ~(uint64_t)0;
+
+  return ((uint64_t)1 << rest) - 1;
+}
+
+// the cells of a row's word along with their left and right neighbours
+static uint64_t spread(uint64_t const *restrict words, size_t word, size_t stride) {
+  return board_bits_left(words, word) | words[word] | board_bits_right(words, word, stride);
+}
+
+// the cells that aren't mines and have no mines around them
+static void set_zero_cells(struct board *restrict board) {
+  size_t stride = board_row_words(board);
+
+  for (size_t row = 0; row < board->rows; row++) {
+    uint64_t const *mines = row_of(board, PLANE_MINES, row);
+    uint64_t *zero = row_of(board, PLANE_ZERO, row);
+
+    for (size_t word = 0; word < stride; word++) {
+      uint64_t near = spread(mines, word, stride);
+      if (row) near |= spread(mines - stride, word, stride);
+      if (row + 1 < board->rows) near |= spread(mines + stride, word, stride);
+
+      zero[word] = ~near & word_mask(board, word);
+    }
+  }
+}
+
+bool board_create_custom(struct board *restrict board, size_t rows, size_t cols, size_t mines) {
+  if (!board) return false;
+
+  if (!board_valid_size(rows, cols, mines)) {
+    *board = (struct board){0};
+    return false;
+  }
+
+  size_t words = rows * ((cols + BOARD_WORD_BITS - 1) / BOARD_WORD_BITS) * PLANE_AMOUNT;
+  uint64_t *bits = calloc(words, sizeof *bits);
+  if (!bits) {
+    *board = (struct board){0};
+    return false;
+  }
+
+  struct density density;
+  if (!density_create(&density, rows, cols)) {
+    free(bits);
+    *board = (struct board){0};
+    return false;
+  }
+
+  *board = (struct board){.difficulty = MS_CUSTOM,
+                          .rows = rows,
+                          .cols = cols,
+                          .mines = mines,
+                          .revealed_cells = 0,
+                          .capacity = words,
+                          .bits = bits,
+                          .density = density};
+  return true;
+}
+
+static bool board_resize(struct board *restrict board, size_t rows, size_t cols, size_t mines) {
+  if (!board_valid_size(rows, cols, mines)) return false;
+
+  if (rows * ((cols + BOARD_WORD_BITS - 1) / BOARD_WORD_BITS) * PLANE_AMOUNT <= board->capacity) {
+    struct density density;
+    if (!density_create(&density, rows, cols)) return false;
+
+    density_destroy(&board->density);
+    board->density = density;
+    board->rows = rows;
+    board->cols = cols;
+    board->mines = mines;
+    return true;
+  }
+
+  board_destroy(board);
+  return board_create_custom(board, rows, cols, mines);
+}
+
+void board_destroy(struct board *restrict board) {
+  if (!board || !board->bits) return;
+
+  free(board->bits);
+  free(board->delta.changes);
+  density_destroy(&board->density);
+}
+
+// deals the mines in the same order as the cell per byte engine, a seed yields the same board on either
+bool generate_mines(struct board *restrict board) {
+  if (!board || !board->bits) return false;
+
+  uint64_t state = board->seed;
+  size_t cells = board->rows * board->cols;
+  size_t i = 0;
+  while (i < board->mines) {
+    size_t idx = board_random_below(&state, cells);
+    uint64_t *word = word_of(board, PLANE_MINES, idx / board->cols, idx % board->cols);
+
+    if (!(*word & bit(idx % board->cols))) {
+      *word |= bit(idx % board->cols);
+      i++;
+    }
+  }
+
+  return true;
+}
+
+bool board_reset_seeded(struct board *restrict board, uint64_t seed) {
+  if (!board || !board->bits) return false;
+
+  board->seed = seed;
+
+  memset(board->bits, 0, sizeof *board->bits * plane_size(board) * PLANE_AMOUNT);
+  board->revealed_cells = 0;
+  density_clear(&board->density);
+  board_discard_changes(board);
+
+  if (!generate_mines(board)) return false;
+  set_zero_cells(board);
+
+  return true;
+}
+
+bool board_init_custom(struct board *restrict board, size_t rows, size_t cols, size_t mines) {
+  if (!board || !board->bits) return false;
+
+  // board changed size / mines
+  if (rows != board->rows || cols != board->cols || mines != board->mines) {
+    if (!board_resize(board, rows, cols, mines)) { return false; }
+  }
+
+  board->difficulty = MS_CUSTOM;
+  return board_reset(board);
+}
+
+void board_reveal_cell(struct board *restrict board, size_t row, size_t col) {
+  if (!board || !board->bits) return;
+
+  if (row >= board->rows || col >= board->cols) return;
+  if (test(board, PLANE_REVEALED, row, col)) return;
+
+  density_update(&board->density, row, col, 1, mark_of(board, row, col) == MARK_MINE ? -1 : 0);
+
+  *word_of(board, PLANE_REVEALED, row, col) |= bit(col);
+  *word_of(board, PLANE_MARK_LOW, row, col) &= ~bit(col);
+  *word_of(board, PLANE_MARK_HIGH, row, col) &= ~bit(col);
+  board->revealed_cells++;
+  board_record(board, row * board->cols + col, board_cell(board, row, col));
+}
+
+enum mark board_mark_cell(struct board *restrict board, size_t row, size_t col) {
+  if (!board || !board->bits) return MARK_NONE;
+
+  if (row >= board->rows || col >= board->cols) return MARK_NONE;
+
+  enum mark prev = mark_of(board, row, col);
+  if (test(board, PLANE_REVEALED, row, col)) return prev;
+
+  enum mark mark = (prev + 1) % MARK_AMOUNT;
+  density_update(&board->density, row, col, 0, (mark == MARK_MINE) - (prev == MARK_MINE));
+
+  uint64_t *low = word_of(board, PLANE_MARK_LOW, row, col);
+  uint64_t *high = word_of(board, PLANE_MARK_HIGH, row, col);
+  *low = (mark & 1) ? *low | bit(col) : *low & ~bit(col);
+  *high = (mark & 2) ? *high | bit(col) : *high & ~bit(col);
+  board_record(board, row * board->cols + col, board_cell(board, row, col));
+  return mark;
+}
+
+void board_pack(struct board const *restrict board, uint64_t *restrict bits) {
+  if (!board || !board->bits || !bits) return;
+
+  memcpy(bits, board->bits, sizeof *bits * plane_size(board) * PLANE_PACKED);
+}
+
+bool board_unpack(struct board *restrict board, uint64_t const *restrict bits) {
+  if (!board || !board->bits || !bits || !board_planes_valid(board, bits)) return false;
+
+  memcpy(board->bits, bits, sizeof *bits * plane_size(board) * PLANE_PACKED);
+  set_zero_cells(board);
+  board_count_planes(board, board->bits);
+  return true;
+}
+
+// adds the cells of `cells` (a row's word) onto the density's level 0. a block is a byte wide, `density_propagate`
+// has to follow
+static void count_revealed(struct board *restrict board, size_t row, size_t word, uint64_t cells) {
+  struct density_level *base = &board->density.level[0];
+  uint32_t *blocks = &base->revealed[(row >> DENSITY_BLOCK_SHIFT) * base->cols + word * (BOARD_WORD_BITS / OCTET)];
+
+  for (size_t byte = 0; cells; byte++, cells >>= OCTET) blocks[byte] += board_popcount(cells & 0xff);
+}
+
+// the mines around the cell at (row, col), `mines` being its row of the mines plane
+static unsigned mines_around(struct board const *restrict board,
+                             uint64_t const *restrict mines,
+                             size_t row,
+                             size_t col) {
+  size_t stride = board_row_words(board);
+  unsigned adjacent_mines = 0;
+
+  // out of bounds neighbours wrap around and are rejected by the bounds check
+  for (size_t next_col = col - 1; next_col != col + 2; next_col++) {
+    if (next_col >= board->cols) continue;
+
+    uint64_t mask = bit(next_col);
+    size_t word = next_col / BOARD_WORD_BITS;
+    adjacent_mines += (row && (mines[word - stride] & mask)) + ((mines[word] & mask) != 0) +
+                      (row + 1 < board->rows && (mines[word + stride] & mask));
+  }
+  return adjacent_mines;
+}
+
+// records the revealed cells of `cells` (a row's word) as they are now. most of a region is zero cells, which have no
+// mines around them to count
+static void record_word(struct board *restrict board, size_t row, size_t word, uint64_t cells) {
+  uint64_t const *mines = row_of(board, PLANE_MINES, row);
+  uint64_t zero = row_of(board, PLANE_ZERO, row)[word];
+  uint64_t low = row_of(board, PLANE_MARK_LOW, row)[word];
+  uint64_t high = row_of(board, PLANE_MARK_HIGH, row)[word];
+
+  for (; cells && !board->delta.stale; cells &= cells - 1) {
+    uint64_t lowest = cells & (~cells + 1);
+    size_t col = word * BOARD_WORD_BITS + board_popcount(lowest - 1);
+
+    struct cell cell = {.mine = (mines[word] & lowest) != 0,
+                        .revealed = true,
+                        .mark = ((low & lowest) != 0) | ((high & lowest) != 0) << 1};
+    if (!cell.mine && !(zero & lowest)) cell.adjacent_mines = mines_around(board, mines, row, col);
+    board_record(board, row * board->cols + col, cell);
+  }
+}
+
+void board_reveal_mines(struct board *restrict board) {
+  if (!board || !board->bits) return;
+
+  size_t stride = board_row_words(board);
+  for (size_t row = 0; row < board->rows; row++) {
+    uint64_t const *mines = row_of(board, PLANE_MINES, row);
+    uint64_t *revealed = row_of(board, PLANE_REVEALED, row);
+
+    for (size_t word = 0; word < stride; word++) {
+      uint64_t shown = mines[word] & ~revealed[word];
+      if (!shown) continue;
+
+      revealed[word] |= shown;
+      count_revealed(board, row, word, shown);
+      record_word(board, row, word, shown);
+    }
+  }
+
+  density_propagate(&board->density);
+}
+
+struct cell board_cell(struct board const *restrict board, size_t row, size_t col) {
+  if (!board || !board->bits) return (struct cell){0};
+  if (row >= board->rows || col >= board->cols) return (struct cell){0};
+
+  struct cell cell = {.mine = test(board, PLANE_MINES, row, col),
+                      .revealed = test(board, PLANE_REVEALED, row, col),
+                      .mark = mark_of(board, row, col)};
+  if (cell.mine) return cell;
+
+  uint64_t const *mines = row_of(board, PLANE_MINES, row);
+  cell.adjacent_mines = mines_around(board, mines, row, col);
+  return cell;
+}
+
+// the cells of a row a region may grow into: unrevealed, unflagged zero cells
+static void open_cells(struct board const *restrict board, size_t row, uint64_t *restrict open) {
+  uint64_t const *zero = row_of(board, PLANE_ZERO, row);
+  uint64_t const *revealed = row_of(board, PLANE_REVEALED, row);
+  uint64_t const *low = row_of(board, PLANE_MARK_LOW, row);
+  uint64_t const *high = row_of(board, PLANE_MARK_HIGH, row);
+
+  size_t stride = board_row_words(board);
+  for (size_t word = 0; word < stride; word++) open[word] = zero[word] & ~revealed[word] & ~(low[word] & ~high[word]);
+}
+
+/*
+  grows every set bit of `seed` into the whole run of set bits of `open` it lies in. upwards, adding the seed onto the
+  runs carries it up to the run's end. downwards, the seed is smeared by doubling shifts through the run
+*/
+static void fill_runs(uint64_t *restrict seed, uint64_t const *restrict open, size_t stride) {
+  uint64_t carry = 0;
+  for (size_t word = 0; word < stride; word++) {
+    uint64_t sum = open[word] + seed[word];
+    uint64_t carried = sum + carry;
+    carry = (sum < open[word]) | (carried < sum);
+
+    seed[word] |= (carried ^ open[word]) & open[word];
+  }
+
+  uint64_t borrow = 0;
+  for (size_t word = stride; word-- > 0;) {
+    uint64_t run = open[word];
+    uint64_t filled = seed[word] | (borrow & run);
+
+    for (unsigned shift = 1; shift < BOARD_WORD_BITS; shift *= 2) {
+      filled |= run & filled >> shift;
+      run &= run >> shift;
+    }
+
+    seed[word] = filled;
+    borrow = (filled & 1) ? (uint64_t)1 << (BOARD_WORD_BITS - 1) : 0;
+  }
+}
+
+// grows the region's row `row` by the cells next to `prev`, the region's row before it. returns whether it grew
+static bool grow_row(struct board *restrict board,
+                     size_t row,
+                     uint64_t const *restrict prev,
+                     uint64_t *restrict seed,
+                     uint64_t *restrict open) {
+  size_t stride = board_row_words(board);
+  uint64_t *region = row_of(board, PLANE_REGION, row);
+
+  open_cells(board, row, open);
+
+  bool grew = false;
+  for (size_t word = 0; word < stride; word++) {
+    seed[word] = (region[word] | spread(prev, word, stride)) & open[word];
+    grew |= seed[word] != region[word];
+  }
+
+  // the region's rows are whole runs already, nothing new to fill
+  if (!grew) return false;
+
+  fill_runs(seed, open, stride);
+  memcpy(region, seed, sizeof *region * stride);
+  return true;
+}
+
+/*
+  sweeps over the region's rows [top, bottom] downwards (or upwards) and past them for as long as it keeps growing.
+  every row takes in the cells next to the row before it. returns whether the region grew
+*/
+static bool sweep(struct board *restrict board, size_t *top, size_t *bottom, bool down, uint64_t *restrict scratch) {
+  size_t stride = board_row_words(board);
+  uint64_t const *empty = scratch + stride * 2;
+
+  bool grew = false;
+  for (size_t row = down ? *top : *bottom; row < board->rows; row = down ? row + 1 : row - 1) {
+    bool first = down ? row == 0 : row + 1 == board->rows;
+    uint64_t const *prev = first ? empty : row_of(board, PLANE_REGION, down ? row - 1 : row + 1);
+
+    bool row_grew = grow_row(board, row, prev, scratch, scratch + stride);
+    grew |= row_grew;
+
+    if (row >= *top && row <= *bottom) continue;
+    if (!row_grew) break;
+
+    if (down) *bottom = row;
+    else *top = row;
+  }
+
+  return grew;
+}
+
+// reveals the region and the ring of cells around it, flagged cells excepted, then clears the region
+static void reveal_region(struct board *restrict board, size_t top, size_t bottom, uint64_t const *restrict empty) {
+  size_t stride = board_row_words(board);
+  size_t first = top ? top - 1 : 0;
+  size_t last = bottom + 1 < board->rows ? bottom + 1 : bottom;
+
+  for (size_t row = first; row <= last; row++) {
+    uint64_t const *curr = row_of(board, PLANE_REGION, row);
+    uint64_t const *above = row ? curr - stride : empty;
+    uint64_t const *below = row + 1 < board->rows ? curr + stride : empty;
+
+    uint64_t *revealed = row_of(board, PLANE_REVEALED, row);
+    uint64_t *low = row_of(board, PLANE_MARK_LOW, row);
+    uint64_t *high = row_of(board, PLANE_MARK_HIGH, row);
+
+    for (size_t word = 0; word < stride; word++) {
+      uint64_t around = spread(above, word, stride) | spread(curr, word, stride) | spread(below, word, stride);
+      uint64_t opened = around & word_mask(board, word) & ~revealed[word] & ~(low[word] & ~high[word]);
+      if (!opened) continue;
+
+      // zero cells have no mines around them, the ring holds none
+      revealed[word] |= opened;
+      low[word] &= ~opened;
+      high[word] &= ~opened;
+      board->revealed_cells += board_popcount(opened);
+      count_revealed(board, row, word, opened);
+      record_word(board, row, word, opened);
+    }
+  }
+
+  memset(row_of(board, PLANE_REGION, top), 0, sizeof *board->bits * stride * (bottom - top + 1));
+  density_propagate_rows(&board->density, first, last);
+}
+
+/*
+  the region starts as the zero cell and is swept down and up, a row at a time, until neither sweep grows it. every row
+  costs a handful of operations per word and the sweeps only span the region's rows, so a region takes a few passes
+  over its own rows whatever its size
+*/
+void board_open(struct board *restrict board, size_t row, size_t col) {
+  if (!board || !board->bits) return;
+  if (row >= board->rows || col >= board->cols) return;
+
+  if (test(board, PLANE_REVEALED, row, col) || mark_of(board, row, col) == MARK_MINE) return;
+  if (!test(board, PLANE_ZERO, row, col)) {
+    board_reveal_cell(board, row, col);
+    return;
+  }
+
+  // the seed, the open cells and an empty row
+  size_t stride = board_row_words(board);
+  uint64_t *scratch = calloc(stride * 3, sizeof *scratch);
+  if (!scratch) return;
+
+  // the zero cell's run within its row
+  uint64_t *region = row_of(board, PLANE_REGION, row);
+  open_cells(board, row, scratch + stride);
+  region[col / BOARD_WORD_BITS] = bit(col);
+  fill_runs(region, scratch + stride, stride);
+
+  size_t top = row;
+  size_t bottom = row;
+  bool grew = true;
+  while (grew) {
+    grew = sweep(board, &top, &bottom, true, scratch);
+    grew = sweep(board, &top, &bottom, false, scratch) || grew;
+  }
+
+  reveal_region(board, top, bottom, scratch + stride * 2);
+  free(scratch);
+}
@@ -1,58 +1,55 @@
 #include "board.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
+#include "board_common.h"
 
-/*generates a random value between [min, max) */
-static int rng(int min, int max) {
-  int range = max - (min + 1);
+/* the cell per byte engine */
 
-  double rand_val = rand() / (1.0 + RAND_MAX);
-  return (int)(rand_val * range + min);
-}
-
-static struct cell cell(struct cell *cells, size_t row, size_t col, size_t rows_bound, size_t cols_bound) {
-  // the cell at (row, col) is a mine
-  if (cells[row * cols_bound + col].mine) return cells[row * cols_bound + col];
-
-  size_t prev_row = row - 1;
-  size_t last_row = row + 1;
-  size_t prev_col = col - 1;
-  size_t last_col = col + 1;
-
-  if (row == 0) { prev_row = row; }
-  if (row == rows_bound - 1) { last_row = row; }
+/* the sum of the mines in the 3 cells vertically centered on each cell of `row` */
+static void vertical_sums(struct board const *restrict board, size_t row, unsigned char *restrict sums) {
+  struct cell const *curr = &board->cells[row * board->cols];
+  struct cell const *above = row ? curr - board->cols : NULL;
+  struct cell const *below = row + 1 < board->rows ? curr + board->cols : NULL;
 
-  if (col == 0) { prev_col = col; }
-  if (col == cols_bound - 1) { last_col = col; }
-
-  size_t adjacent_mines = 0;
-  for (size_t curr_row = prev_row; curr_row <= last_row; curr_row++) {
-    for (size_t curr_col = prev_col; curr_col <= last_col; curr_col++) {
-      if (cells[curr_row * cols_bound + curr_col].mine) adjacent_mines++;
-    }
+  for (size_t col = 0; col < board->cols; col++) {
+    sums[col] = curr[col].mine + (above ? above[col].mine : 0) + (below ? below[col].mine : 0);
   }
-
-  return (struct cell){.adjacent_mines = adjacent_mines};
 }
 
+/* counts the mines around every cell that isn't a mine itself. 3 vertical sums are added per cell rather than
+ * visiting all 8 neighbours */
 static bool set_cells_values(struct board *restrict board) {
   if (!board || !board->cells) return false;
 
-  for (size_t row = 0; row < board_rows(board); row++) {
-    for (size_t col = 0; col < board_cols(board); col++) {
-      board->cells[row * board_cols(board) + col] = cell(board->cells, row, col, board_rows(board), board_cols(board));
+  unsigned char *sums = malloc(board->cols + 2);
+  if (!sums) return false;
+
+  // sums[0] and sums[cols + 1] pad the edges
+  sums[0] = 0;
+  sums[board->cols + 1] = 0;
+  for (size_t row = 0; row < board->rows; row++) {
+    vertical_sums(board, row, sums + 1);
+
+    struct cell *cells = &board->cells[row * board->cols];
+    for (size_t col = 0; col < board->cols; col++) {
+      if (cells[col].mine) continue;
+
+      cells[col].adjacent_mines = sums[col] + sums[col + 1] + sums[col + 2];
     }
   }
 
+  free(sums);
   return true;
 }
 
-bool board_create(struct board *restrict board, enum difficulty difficulty) {
+bool board_create_custom(struct board *restrict board, size_t rows, size_t cols, size_t mines) {
   if (!board) return false;
 
-  size_t rows = (difficulty >> OCTET * 2) & 0xff;
-  size_t cols = (difficulty >> OCTET) & 0xff;
+  if (!board_valid_size(rows, cols, mines)) {
+    *board = (struct board){0};
+    return false;
+  }
 
   struct cell *cells = malloc(sizeof *cells * rows * cols);
   if (!cells) {
@@ -60,27 +57,62 @@ bool board_create(struct board *restrict board, enum difficulty difficulty) {
     return false;
   }
 
-  *board = (struct board){.difficulty = difficulty, .revealed_cells = 0, .cells = cells};
+  struct density density;
+  if (!density_create(&density, rows, cols)) {
+    free(cells);
+    *board = (struct board){0};
+    return false;
+  }
+
+  *board = (struct board){.difficulty = MS_CUSTOM,
+                          .rows = rows,
+                          .cols = cols,
+                          .mines = mines,
+                          .revealed_cells = 0,
+                          .capacity = rows * cols,
+                          .cells = cells,
+                          .density = density};
   return true;
 }
 
+static bool board_resize(struct board *restrict board, size_t rows, size_t cols, size_t mines) {
+  if (!board_valid_size(rows, cols, mines)) return false;
+
+  if (rows * cols <= board->capacity) {
+    struct density density;
+    if (!density_create(&density, rows, cols)) return false;
+
+    density_destroy(&board->density);
+    board->density = density;
+    board->rows = rows;
+    board->cols = cols;
+    board->mines = mines;
+    return true;
+  }
+
+  board_destroy(board);
+  return board_create_custom(board, rows, cols, mines);
+}
+
 void board_destroy(struct board *restrict board) {
   if (!board || !board->cells) return;
 
   free(board->cells);
+  free(board->delta.changes);
+  density_destroy(&board->density);
 }
 
 bool generate_mines(struct board *restrict board) {
   if (!board || !board->cells) return false;
 
-  int total_mines = board_mines(board);
-  int i = 0;
-  while (i < total_mines) {
-    size_t row = rng(0, board_rows(board));
-    size_t col = rng(0, board_cols(board));
+  uint64_t state = board->seed;
+  size_t cells = board->rows * board->cols;
+  size_t i = 0;
+  while (i < board->mines) {
+    size_t idx = board_random_below(&state, cells);
 
-    if (!board->cells[row * board_cols(board) + col].mine) {
-      board->cells[row * board_cols(board) + col] = (struct cell){.mine = true};
+    if (!board->cells[idx].mine) {
+      board->cells[idx] = (struct cell){.mine = true};
       i++;
     }
   }
@@ -88,19 +120,16 @@ bool generate_mines(struct board *restrict board) {
   return true;
 }
 
-bool board_init(struct board *restrict board, enum difficulty difficulty) {
+bool board_reset_seeded(struct board *restrict board, uint64_t seed) {
   if (!board || !board->cells) return false;
 
-  // board changed size / mines
-  if (difficulty != board->difficulty) {
-    board_destroy(board);
-    if (!board_create(board, difficulty)) { return false; }
-  }
+  board->seed = seed;
 
-  // board remains the same
   // reset all cells
-  memset(board->cells, 0, sizeof *board->cells * board_rows(board) * board_cols(board));
+  memset(board->cells, 0, sizeof *board->cells * board->rows * board->cols);
   board->revealed_cells = 0;
+  density_clear(&board->density);
+  board_discard_changes(board);
 
   if (!generate_mines(board)) return false;
   if (!set_cells_values(board)) return false;
@@ -108,41 +137,320 @@ bool board_init(struct board *restrict board, enum difficulty difficulty) {
   return true;
 }
 
-unsigned board_mines(struct board const *restrict board) {
-  if (!board) return 0;
-  return board->difficulty & 0xff;
+bool board_init_custom(struct board *restrict board, size_t rows, size_t cols, size_t mines) {
+  if (!board || !board->cells) return false;
+
+  // board changed size / mines
+  if (rows != board->rows || cols != board->cols || mines != board->mines) {
+    if (!board_resize(board, rows, cols, mines)) { return false; }
+  }
+
+  board->difficulty = MS_CUSTOM;
+  return board_reset(board);
 }
 
-size_t board_rows(struct board const *restrict board) {
-  if (!board) return 0;
+void board_reveal_cell(struct board *restrict board, size_t row, size_t col) {
+  if (!board) return;
+
+  if (row >= board->rows || col >= board->cols) return;
+
+  struct cell *cell = &board->cells[row * board->cols + col];
+  if (cell->revealed) return;
 
-  return (board->difficulty >> OCTET) & 0xff;
+  density_update(&board->density, row, col, 1, cell->mark == MARK_MINE ? -1 : 0);
+
+  cell->revealed = true;
+  cell->mark = MARK_NONE;
+  board->revealed_cells++;
+  board_record(board, row * board->cols + col, *cell);
 }
 
-size_t board_cols(struct board const *restrict board) {
-  if (!board) return 0;
+enum mark board_mark_cell(struct board *restrict board, size_t row, size_t col) {
+  if (!board) return MARK_NONE;
+
+  if (row >= board->rows || col >= board->cols) return MARK_NONE;
 
-  return (board->difficulty >> OCTET * 2) & 0xff;
+  struct cell *cell = &board->cells[row * board->cols + col];
+  if (cell->revealed) return cell->mark;
+
+  enum mark mark = (cell->mark + 1) % MARK_AMOUNT;
+  density_update(&board->density, row, col, 0, (mark == MARK_MINE) - (cell->mark == MARK_MINE));
+
+  cell->mark = mark;
+  board_record(board, row * board->cols + col, *cell);
+  return mark;
 }
 
-bool board_revealed_cells(struct board *restrict board) {
-  if (!board) return false;
-  return board->revealed_cells == board_rows(board) * board_cols(board) - board_mines(board);
+void board_pack(struct board const *restrict board, uint64_t *restrict bits) {
+  if (!board || !board->cells || !bits) return;
+
+  size_t stride = board_row_words(board);
+  size_t plane = board->rows * stride;
+  for (size_t row = 0; row < board->rows; row++) {
+    struct cell const *cells = &board->cells[row * board->cols];
+    uint64_t *words = &bits[row * stride];
+
+    for (size_t col = 0; col < board->cols; col++) {
+      uint64_t bit = (uint64_t)1 << col % BOARD_WORD_BITS;
+      uint64_t *word = &words[col / BOARD_WORD_BITS];
+
+      if (cells[col].mine) word[0] |= bit;
+      if (cells[col].revealed) word[plane] |= bit;
+      if (cells[col].mark & 1) word[plane * 2] |= bit;
+      if (cells[col].mark & 2) word[plane * 3] |= bit;
+    }
+  }
 }
 
-void board_reveal_cell(struct board *restrict board, size_t row, size_t col) {
-  if (!board) return;
+// the cell a byte of 8 planes stands for: mine, revealed, the low and high mark bits, then the 4 bits of the adjacent
+// mines, lowest bit first
+static struct cell cell_of(unsigned char byte) {
+  return (struct cell){.mine = byte & 1, .revealed = byte >> 1 & 1, .mark = byte >> 2 & 3, .adjacent_mines = byte >> 4};
+}
 
-  if (row >= board_rows(board) || col >= board_cols(board)) return;
+// whether the compiler lays cells out exactly like the byte of planes above. bitfields are laid out however it sees
+// fit, so one asks it
+static bool planes_layout(void) {
+  if (sizeof(struct cell) != 1) return false;
 
-  board->cells[row * board_cols(board) + col].revealed = true;
-  board->cells[row * board_cols(board) + col].mark = MARK_NONE;
-  board->revealed_cells++;
+  for (unsigned byte = 0; byte < 256; byte++) {
+    struct cell cell = cell_of(byte);
+
+    unsigned char laid_out = 0;
+    memcpy(&laid_out, &cell, 1);
+    if (laid_out != byte) return false;
+  }
+
+  return true;
 }
 
-struct cell *board_cell(struct board *restrict board, size_t row, size_t col) {
-  if (!board || !board->cells) return NULL;
-  if (row >= board_rows(board) || col >= board_cols(board)) return NULL;
+// swaps the bytes of `a` masked by `mask` shifted up by `shift` with the bytes of `b` masked by `mask`
+static void swap_bytes(uint64_t *restrict a, uint64_t *restrict b, unsigned shift, uint64_t mask) {
+  uint64_t swap = (*a >> shift ^ *b) & mask;
+  *a ^= swap << shift;
+  *b ^= swap;
+}
+
+// transposes an 8x8 matrix of bytes held by 8 words, byte i of word j becomes byte j of word i
+static void transpose_bytes(uint64_t *restrict words) {
+  swap_bytes(&words[0], &words[4], 32, 0x00000000ffffffffu);
+  swap_bytes(&words[1], &words[5], 32, 0x00000000ffffffffu);
+  swap_bytes(&words[2], &words[6], 32, 0x00000000ffffffffu);
+  swap_bytes(&words[3], &words[7], 32, 0x00000000ffffffffu);
+
+  swap_bytes(&words[0], &words[2], 16, 0x0000ffff0000ffffu);
+  swap_bytes(&words[1], &words[3], 16, 0x0000ffff0000ffffu);
+  swap_bytes(&words[4], &words[6], 16, 0x0000ffff0000ffffu);
+  swap_bytes(&words[5], &words[7], 16, 0x0000ffff0000ffffu);
+
+  swap_bytes(&words[0], &words[1], 8, 0x00ff00ff00ff00ffu);
+  swap_bytes(&words[2], &words[3], 8, 0x00ff00ff00ff00ffu);
+  swap_bytes(&words[4], &words[5], 8, 0x00ff00ff00ff00ffu);
+  swap_bytes(&words[6], &words[7], 8, 0x00ff00ff00ff00ffu);
+}
+
+// transposes an 8x8 matrix of bits held by a word, bit i of byte j becomes bit j of byte i
+static uint64_t transpose_bits(uint64_t word) {
+  uint64_t swap = (word ^ word >> 7) & 0x00aa00aa00aa00aau;
+  word ^= swap ^ swap << 7;
+  swap = (word ^ word >> 14) & 0x0000cccc0000ccccu;
+  word ^= swap ^ swap << 14;
+  swap = (word ^ word >> 28) & 0x00000000f0f0f0f0u;
+  word ^= swap ^ swap << 28;
+  return word;
+}
+
+// a full adder over 64 lanes
+static uint64_t add(uint64_t *restrict carry, uint64_t a, uint64_t b, uint64_t c) {
+  uint64_t partial = a ^ b;
+  *carry = (a & b) | (partial & c);
+  return partial ^ c;
+}
+
+// counts the set bits of 8 planes lane wise into 4 bit sliced planes
+static void count_planes(uint64_t const *restrict planes, uint64_t *restrict sum) {
+  uint64_t twos[4];
+  uint64_t ones = add(&twos[0], planes[0], planes[1], planes[2]);
+  uint64_t more_ones = add(&twos[1], planes[3], planes[4], planes[5]);
+  ones = add(&twos[2], ones, more_ones, planes[6]);
+
+  sum[0] = ones ^ planes[7];
+  twos[3] = ones & planes[7];
+
+  uint64_t fours[2];
+  uint64_t partial = add(&fours[0], twos[0], twos[1], twos[2]);
+  sum[1] = partial ^ twos[3];
+  fours[1] = partial & twos[3];
+
+  sum[2] = fours[0] ^ fours[1];
+  sum[3] = fours[0] & fours[1];
+}
+
+static bool little_endian(void) {
+  uint64_t one = 1;
+  unsigned char first = 0;
+  memcpy(&first, &one, 1);
+  return first;
+}
+
+/*
+  64 cells at a time: the mines around them are counted by adding up the 8 shifted neighbouring words into bit sliced
+  planes, the 8 planes are then transposed into the cells' bytes
+*/
+static void unpack_cells(struct cell *restrict cells,
+                         size_t rows,
+                         size_t cols,
+                         uint64_t const *restrict bits,
+                         uint64_t const *restrict empty) {
+  size_t stride = (cols + BOARD_WORD_BITS - 1) / BOARD_WORD_BITS;
+  size_t plane = rows * stride;
+
+  // 8 cells are stored straight from a word if the compiler lays them out as the planes are ordered
+  bool whole_words = planes_layout() && little_endian();
+
+  for (size_t row = 0; row < rows; row++) {
+    uint64_t const *mines = &bits[row * stride];
+    uint64_t const *above = row ? mines - stride : empty;
+    uint64_t const *below = row + 1 < rows ? mines + stride : empty;
+
+    for (size_t word = 0; word < stride; word++) {
+      uint64_t const neighbours[] = {board_bits_left(above, word),
+                                     above[word],
+                                     board_bits_right(above, word, stride),
+                                     board_bits_left(mines, word),
+                                     board_bits_right(mines, word, stride),
+                                     board_bits_left(below, word),
+                                     below[word],
+                                     board_bits_right(below, word, stride)};
+      uint64_t sum[4];
+      count_planes(neighbours, sum);
+
+      // the planes of a cell's byte. once transposed, word i holds the planes of cells [8i, 8i + 8) byte by byte and
+      // transposing its bits yields the cells' bytes
+      uint64_t mine = mines[word];
+      uint64_t planes[] = {mine,
+                           mines[word + plane],
+                           mines[word + plane * 2],
+                           mines[word + plane * 3],
+                           sum[0] & ~mine,  // mines don't count their neighbours
+                           sum[1] & ~mine,
+                           sum[2] & ~mine,
+                           sum[3] & ~mine};
+      transpose_bytes(planes);
+
+      size_t first = word * BOARD_WORD_BITS;
+      size_t count = cols - first < BOARD_WORD_BITS ? cols - first : BOARD_WORD_BITS;
+      struct cell *curr = &cells[row * cols + first];
+      for (size_t byte = 0; byte * OCTET < count; byte++) {
+        size_t shift = byte * OCTET;
+        uint64_t packed = transpose_bits(planes[byte]);
+
+        size_t amount = count - shift < OCTET ? count - shift : OCTET;
+        if (whole_words && amount == OCTET) {
+          memcpy(&curr[shift], &packed, sizeof packed);
+          continue;
+        }
+
+        for (size_t i = 0; i < amount; i++) {
+          curr[shift + i] = cell_of(packed >> i * OCTET & 0xff);
+        }
+      }
+    }
+  }
+}
+
+bool board_unpack(struct board *restrict board, uint64_t const *restrict bits) {
+  if (!board || !board->cells || !bits || !board_planes_valid(board, bits)) return false;
+
+  uint64_t *empty = calloc(board_row_words(board), sizeof *empty);  // the rows past the edges
+  if (!empty) return false;
+
+  unpack_cells(board->cells, board->rows, board->cols, bits, empty);
+  board_count_planes(board, bits);
+
+  free(empty);
+  return true;
+}
+
+void board_reveal_mines(struct board *restrict board) {
+  if (!board || !board->cells) return;
+
+  for (size_t row = 0; row < board->rows; row++) {
+    for (size_t col = 0; col < board->cols; col++) {
+      struct cell *cell = &board->cells[row * board->cols + col];
+      if (!cell->mine || cell->revealed) continue;
+
+      density_update(&board->density, row, col, 1, 0);
+      cell->revealed = true;
+      board_record(board, row * board->cols + col, *cell);
+    }
+  }
+}
+
+struct cell board_cell(struct board const *restrict board, size_t row, size_t col) {
+  if (!board || !board->cells) return (struct cell){0};
+  if (row >= board->rows || col >= board->cols) return (struct cell){0};
+
+  return board->cells[row * board->cols + col];
+}
+
+// the zero cells whose neighbours are yet to be revealed (row major indices)
+struct stack {
+  size_t size;
+  size_t capacity;
+  size_t *cells;
+};
+
+static bool stack_push(struct stack *restrict stack, size_t cell) {
+  if (stack->size == stack->capacity) {
+    size_t capacity = stack->capacity ? stack->capacity * 2 : 64;
+
+    size_t *cells = realloc(stack->cells, sizeof *cells * capacity);
+    if (!cells) return false;
+
+    stack->cells = cells;
+    stack->capacity = capacity;
+  }
+
+  stack->cells[stack->size++] = cell;
+  return true;
+}
+
+/*
+  a depth first flood fill over an explicit stack rather than a recursion - the region of a huge board would blow the
+  call stack. every zero cell reveals its neighbours and is pushed, so it only ever holds unvisited zero cells
+*/
+void board_open(struct board *restrict board, size_t row, size_t col) {
+  if (!board || !board->cells) return;
+  if (row >= board->rows || col >= board->cols) return;
+
+  struct cell const *start = &board->cells[row * board->cols + col];
+  if (start->revealed || start->mark == MARK_MINE) return;
+
+  board_reveal_cell(board, row, col);
+  if (start->mine || start->adjacent_mines) return;
+
+  struct stack stack = {0};
+  stack_push(&stack, row * board->cols + col);
+  while (stack.size) {
+    size_t curr = stack.cells[--stack.size];
+    size_t curr_row = curr / board->cols;
+    size_t curr_col = curr % board->cols;
+
+    // out of bounds neighbours wrap around and are rejected by the bounds check
+    for (size_t next_row = curr_row - 1; next_row != curr_row + 2; next_row++) {
+      for (size_t next_col = curr_col - 1; next_col != curr_col + 2; next_col++) {
+        if (next_row >= board->rows || next_col >= board->cols) continue;
+
+        struct cell const *cell = &board->cells[next_row * board->cols + next_col];
+        if (cell->revealed || cell->mark == MARK_MINE) continue;
+
+        board_reveal_cell(board, next_row, next_col);
+        if (!cell->adjacent_mines && !stack_push(&stack, next_row * board->cols + next_col)) goto cleanup;
+      }
+    }
+  }
 
-  return &board->cells[row * board_cols(board) + col];
+cleanup:
+  free(stack.cells);
 }
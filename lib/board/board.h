@@ -2,7 +2,8 @@
 
 #include <stdbool.h>
 #include <stddef.h>
-#include <time.h>
+#include <stdint.h>
+#include "density.h"
 
 #define OCTET 8
 
@@ -13,16 +14,39 @@ enum mark {
   MARK_AMOUNT,
 };
 
+// a cell fits in a single byte so huge custom boards remain affordable. mark holds an `enum mark`
 struct cell {
-  bool mine;
-  enum mark mark;
-  bool revealed;
-  size_t adjacent_mines;
+  bool mine : 1;
+  bool revealed : 1;
+  unsigned char mark : 2;
+  unsigned char adjacent_mines : 4;
+};
+
+// a cell revealed or marked since the board's changes were last cleared
+struct board_change {
+  size_t index;      // row major
+  struct cell cell;  // what it changed to
+};
+
+/*
+  the cells revealed or marked since `board_clear_changes`, in the order they changed, so callers apply a move in
+  O(changes) rather than rescanning the board. `stale` is set whenever they don't tell the whole story: the board was
+  reset or unpacked, or they outgrew their cap (a 64th of the cells, so a huge flood fill doesn't double the board's
+  memory). the whole board has to be rescanned then
+*/
+struct board_delta {
+  bool stale;
+  uint64_t epoch;  // bumped whenever recorded changes are dropped, so whoever follows them can tell if it missed some
+  size_t size;
+  size_t capacity;
+  struct board_change *changes;
 };
 
 // difficulty packed values accross bytes, each value gets its own byte.
-// obviously - the system must have sizeof(int) == 4. col | rows | number of mines
+// obviously - the system must have sizeof(int) == 4. col | rows | number of mines. boards of any other size are
+// MS_CUSTOM
 enum difficulty {
+  MS_CUSTOM = 0,
   MS_CLASSIC = 9 << OCTET * 2 | 9 << OCTET | 10,
   MS_ADVANCED = 16 << OCTET * 2 | 16 << OCTET | 40,
   MS_EXPERT = 30 << OCTET * 2 | 16 << OCTET | 99,
@@ -32,21 +56,49 @@ enum difficulty {
 struct board {
   enum difficulty difficulty;
 
+  size_t rows;
+  size_t cols;
+  size_t mines;
+  uint64_t seed;  // the mines were dealt from
+
   size_t revealed_cells;
 
+  size_t capacity;  // the amount of storage allocated. switching to a smaller difficulty reuses it
+#ifdef BOARD_BITBOARD
+  uint64_t *bits;  // row major bitsets, see bitboard.c
+#else
   struct cell *cells;
+#endif
+
+  struct density density;  // kept up to date by the functions below. cells must not be revealed or marked otherwise
+  struct board_delta delta;  // likewise
 };
 
 /* difficulty _must_ be one of the enum values above. otherwise - its potential UB */
 bool board_create(struct board *restrict board, enum difficulty difficulty);
 
+/* a MS_CUSTOM board. fails unless there's at least one cell and fewer mines than cells */
+bool board_create_custom(struct board *restrict board, size_t rows, size_t cols, size_t mines);
+
+/* whether a board of that size can be allocated and played, see `DENSITY_MAX_CELLS` */
+bool board_valid_size(size_t rows, size_t cols, size_t mines);
+
 void board_destroy(struct board *restrict board);
 
 bool generate_mines(struct board *restrict board);
 
 bool board_init(struct board *restrict board, enum difficulty difficulty);
 
-unsigned board_mines(struct board const *restrict board);
+bool board_init_custom(struct board *restrict board, size_t rows, size_t cols, size_t mines);
+
+/* deals a new set of mines on a board of the same size */
+bool board_reset(struct board *restrict board);
+
+/* same as `board_reset` but the mines are dealt from `seed`. the same seed on a board of the same size yields the same
+ * mines */
+bool board_reset_seeded(struct board *restrict board, uint64_t seed);
+
+size_t board_mines(struct board const *restrict board);
 
 size_t board_rows(struct board const *restrict board);
 
@@ -54,6 +106,36 @@ size_t board_cols(struct board const *restrict board);
 
 bool board_revealed_cells(struct board *restrict board);
 
+/* reveals a cell (once) and clears its mark */
 void board_reveal_cell(struct board *restrict board, size_t row, size_t col);
 
-struct cell *board_cell(struct board *restrict board, size_t row, size_t col);
+/* cycles the mark of an unrevealed cell: none -> mine -> question -> none. returns the new mark */
+enum mark board_mark_cell(struct board *restrict board, size_t row, size_t col);
+
+/* the amount of 64 bit words a row takes in the bitsets of `board_pack` */
+size_t board_row_words(struct board const *restrict board);
+
+/* writes the mines, the revealed cells and the low and high bits of the marks as 4 consecutive row major bitsets, each
+ * row padded to `board_row_words`. `bits` must hold 4 * rows * `board_row_words` zeroed words */
+void board_pack(struct board const *restrict board, uint64_t *restrict bits);
+
+/* the inverse of `board_pack` on a board of the same size. everything else (adjacent mines, revealed cells and the
+ * density) is recomputed from the bitsets. returns false, leaving the board as it was, if they couldn't have been
+ * packed from a board of its size and mines (see `board_planes_valid`) or if it ran out of memory */
+bool board_unpack(struct board *restrict board, uint64_t const *restrict bits);
+
+/* the changes since they were last cleared, see `struct board_delta` */
+struct board_delta const *board_changes(struct board const *restrict board);
+
+/* empties the changes, their storage is kept for the next ones */
+void board_clear_changes(struct board *restrict board);
+
+/* reveals every mine, to be called once the game is over. doesn't count towards the revealed cells */
+void board_reveal_mines(struct board *restrict board);
+
+/* a copy of the cell at (row, col), a blank cell if it's out of bounds. the engines don't necessarily store cells */
+struct cell board_cell(struct board const *restrict board, size_t row, size_t col);
+
+/* reveals the cell at (row, col) unless it's revealed or flagged. a zero cell opens its whole region of zero cells and
+ * the ring of numbered cells around it, flagged cells excepted */
+void board_open(struct board *restrict board, size_t row, size_t col);
@@ -0,0 +1,212 @@
+#include "board_common.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+enum board_common_size {
+  CHANGES_CAPACITY = 64,  // the changes' first allocation
+  CHANGES_MIN = 1024,     // changes a board of any size may hold
+  CHANGES_RATIO = 64,     // ...or a cell in that many, whichever is more
+};
+
+/* small, fast and good enough to deal mines, and unlike rand() it's seedable per board */
+uint64_t board_next_random(uint64_t *restrict state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15u);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+  return z ^ (z >> 31);
+}
+
+size_t board_random_below(uint64_t *restrict state, size_t bound) {
+  return (size_t)(board_next_random(state) % bound);
+}
+
+/* a different seed on every call, and on every run */
+static uint64_t fresh_seed(void) {
+  static uint64_t counter = 0;
+
+  uint64_t state = (uint64_t)time(NULL) ^ (uint64_t)clock() << 32 ^ counter++;
+  return board_next_random(&state);
+}
+
+static size_t difficulty_rows(enum difficulty difficulty) {
+  return (difficulty >> OCTET) & 0xff;
+}
+
+static size_t difficulty_cols(enum difficulty difficulty) {
+  return (difficulty >> OCTET * 2) & 0xff;
+}
+
+static size_t difficulty_mines(enum difficulty difficulty) {
+  return difficulty & 0xff;
+}
+
+/* capped at a byte per cell whatever the engine, and at what the density's counts hold */
+bool board_valid_size(size_t rows, size_t cols, size_t mines) {
+  if (!rows || !cols) return false;
+  if (rows > SIZE_MAX / sizeof(struct cell) / cols) return false;
+  if (rows > DENSITY_MAX_CELLS / cols) return false;
+
+  return mines < rows * cols;
+}
+
+bool board_create(struct board *restrict board, enum difficulty difficulty) {
+  size_t rows = difficulty_rows(difficulty);
+  size_t cols = difficulty_cols(difficulty);
+  size_t mines = difficulty_mines(difficulty);
+
+  if (!board_create_custom(board, rows, cols, mines)) return false;
+
+  board->difficulty = difficulty;
+  return true;
+}
+
+bool board_reset(struct board *restrict board) {
+  return board_reset_seeded(board, fresh_seed());
+}
+
+bool board_init(struct board *restrict board, enum difficulty difficulty) {
+  size_t rows = difficulty_rows(difficulty);
+  size_t cols = difficulty_cols(difficulty);
+  size_t mines = difficulty_mines(difficulty);
+
+  if (!board_init_custom(board, rows, cols, mines)) return false;
+
+  board->difficulty = difficulty;
+  return true;
+}
+
+size_t board_mines(struct board const *restrict board) {
+  if (!board) return 0;
+  return board->mines;
+}
+
+size_t board_rows(struct board const *restrict board) {
+  if (!board) return 0;
+
+  return board->rows;
+}
+
+size_t board_cols(struct board const *restrict board) {
+  if (!board) return 0;
+
+  return board->cols;
+}
+
+bool board_revealed_cells(struct board *restrict board) {
+  if (!board) return false;
+  return board->revealed_cells == board->rows * board->cols - board->mines;
+}
+
+size_t board_row_words(struct board const *restrict board) {
+  if (!board) return 0;
+
+  return (board->cols + BOARD_WORD_BITS - 1) / BOARD_WORD_BITS;
+}
+
+struct board_delta const *board_changes(struct board const *restrict board) {
+  if (!board) return NULL;
+
+  return &board->delta;
+}
+
+void board_clear_changes(struct board *restrict board) {
+  if (!board) return;
+
+  // clearing nothing loses nothing, a reader that followed the changes so far still does
+  if (!board->delta.size && !board->delta.stale) return;
+
+  board->delta.size = 0;
+  board->delta.stale = false;
+  board->delta.epoch++;
+}
+
+void board_discard_changes(struct board *restrict board) {
+  if (!board) return;
+
+  board->delta.size = 0;
+  board->delta.stale = true;
+  board->delta.epoch++;
+}
+
+bool board_grow_changes(struct board *restrict board) {
+  struct board_delta *delta = &board->delta;
+
+  size_t cap = board->rows * board->cols / CHANGES_RATIO;
+  if (cap < CHANGES_MIN) cap = CHANGES_MIN;
+
+  size_t capacity = delta->capacity ? delta->capacity * 2 : CHANGES_CAPACITY;
+  if (capacity > cap) capacity = cap;
+  if (capacity <= delta->size) {
+    board_discard_changes(board);
+    return false;
+  }
+
+  struct board_change *changes = realloc(delta->changes, capacity * sizeof *changes);
+  if (!changes) {
+    board_discard_changes(board);
+    return false;
+  }
+
+  delta->changes = changes;
+  delta->capacity = capacity;
+  return true;
+}
+
+bool board_planes_valid(struct board const *restrict board, uint64_t const *restrict bits) {
+  size_t stride = board_row_words(board);
+  size_t plane = board->rows * stride;
+  uint64_t last = board->cols % BOARD_WORD_BITS ? ((uint64_t)1 << board->cols % BOARD_WORD_BITS) - 1 : ~(uint64_t)0;
+
+  size_t mines = 0;
+  for (size_t row = 0; row < board->rows; row++) {
+    for (size_t word = row * stride; word < (row + 1) * stride; word++) {
+      uint64_t mine = bits[word];
+      uint64_t revealed = bits[word + plane];
+      uint64_t low = bits[word + plane * 2];
+      uint64_t high = bits[word + plane * 3];
+
+      // the padding past the last column would count as mines around it
+      uint64_t padding = word == (row + 1) * stride - 1 ? ~last : 0;
+      if ((mine | revealed | low | high) & padding) return false;
+      if (low & high || revealed & (low | high)) return false;
+
+      mines += board_popcount(mine);
+    }
+  }
+  return mines == board->mines;
+}
+
+// a popcount per byte of the planes. this assumes the density's blocks are a multiple of 8 cells wide
+void board_count_planes(struct board *restrict board, uint64_t const *restrict bits) {
+  size_t stride = board_row_words(board);
+  size_t plane = board->rows * stride;
+
+  board->revealed_cells = 0;
+  density_clear(&board->density);
+  board_discard_changes(board);
+
+  for (size_t row = 0; row < board->rows; row++) {
+    for (size_t word = row * stride; word < (row + 1) * stride; word++) {
+      uint64_t mine = bits[word];
+      uint64_t revealed = bits[word + plane];
+      uint64_t flagged = bits[word + plane * 2] & ~bits[word + plane * 3];  // MARK_MINE
+      if (!revealed && !flagged) continue;
+
+      // revealed mines are only ever shown once the game is over, they don't count
+      board->revealed_cells += board_popcount(revealed & ~mine);
+
+      size_t first = (word - row * stride) * BOARD_WORD_BITS;
+      for (size_t byte = 0; byte < sizeof revealed; byte++) {
+        unsigned revealed_byte = revealed >> byte * OCTET & 0xff;
+        unsigned flagged_byte = flagged >> byte * OCTET & 0xff;
+        if (!revealed_byte && !flagged_byte) continue;
+
+        density_update_base(
+          &board->density, row, first + byte * OCTET, board_popcount(revealed_byte), board_popcount(flagged_byte));
+      }
+    }
+  }
+
+  density_propagate(&board->density);
+}
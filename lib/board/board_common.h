@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "board.h"
+
+/*
+  the parts of the board both engines share - board.c stores a cell per byte, bitboard.c stores row major bitsets. only
+  one of them is built, see MS_BITBOARD
+*/
+
+#define BOARD_WORD_BITS 64
+
+/* splitmix64 */
+uint64_t board_next_random(uint64_t *restrict state);
+
+/* a random value between [0, bound) */
+size_t board_random_below(uint64_t *restrict state, size_t bound);
+
+/* empties the changes and marks them stale, every cell has to be rescanned */
+void board_discard_changes(struct board *restrict board);
+
+/* makes room for another change, or marks the changes stale if there can't be any. see `board_record` */
+bool board_grow_changes(struct board *restrict board);
+
+/* the word helpers below sit in every inner loop of both engines, hence inline */
+
+static inline unsigned board_popcount(uint64_t word) {
+  word = word - (word >> 1 & 0x5555555555555555u);
+  word = (word & 0x3333333333333333u) + (word >> 2 & 0x3333333333333333u);
+  word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fu;
+  return (unsigned)(word * 0x0101010101010101u >> 56);
+}
+
+/* a row of bits shifted so that bit i holds the cell at i - 1 (left) or i + 1 (right) */
+static inline uint64_t board_bits_left(uint64_t const *restrict words, size_t word) {
+  return words[word] << 1 | (word ? words[word - 1] >> (BOARD_WORD_BITS - 1) : 0);
+}
+
+static inline uint64_t board_bits_right(uint64_t const *restrict words, size_t word, size_t stride) {
+  return words[word] >> 1 | (word + 1 < stride ? words[word + 1] << (BOARD_WORD_BITS - 1) : 0);
+}
+
+/* whether the bitsets of `board_pack` could have been packed from `board`: no bit set past the last column of a row, no
+ * mark on a revealed cell nor one past `MARK_QUESTION`, and as many mines as the board holds */
+bool board_planes_valid(struct board const *restrict board, uint64_t const *restrict bits);
+
+/* recomputes the revealed cells and the density from the mines, revealed and mark bitsets of `board_pack` */
+void board_count_planes(struct board *restrict board, uint64_t const *restrict bits);
+
+/* appends a change to the board's delta. it's made on every cell a move reveals, hence inline */
+static inline void board_record(struct board *restrict board, size_t index, struct cell cell) {
+  struct board_delta *delta = &board->delta;
+  if (delta->stale) return;
+  if (delta->size == delta->capacity && !board_grow_changes(board)) return;
+
+  delta->changes[delta->size++] = (struct board_change){.index = index, .cell = cell};
+}
@@ -0,0 +1,124 @@
+#include "density.h"
+#include <stdlib.h>
+#include <string.h>
+
+static size_t blocks(size_t cells, size_t level) {
+  return ((cells - 1) >> (DENSITY_BLOCK_SHIFT + level)) + 1;
+}
+
+bool density_create(struct density *restrict density, size_t rows, size_t cols) {
+  if (!density) return false;
+
+  *density = (struct density){0};
+  if (!rows || !cols || rows > DENSITY_MAX_CELLS / cols) return false;
+
+  // levels up to (and including) a single block
+  size_t total = 0;
+  for (size_t level = 0; level < DENSITY_MAX_LEVELS; level++) {
+    density->level[level] = (struct density_level){.rows = blocks(rows, level), .cols = blocks(cols, level)};
+    density->levels++;
+    total += density->level[level].rows * density->level[level].cols;
+
+    if (density->level[level].rows == 1 && density->level[level].cols == 1) break;
+  }
+
+  density->counts = calloc(total * 2, sizeof *density->counts);
+  if (!density->counts) {
+    *density = (struct density){0};
+    return false;
+  }
+
+  uint32_t *curr = density->counts;
+  for (size_t level = 0; level < density->levels; level++) {
+    size_t size = density->level[level].rows * density->level[level].cols;
+
+    density->level[level].revealed = curr;
+    density->level[level].flagged = curr + size;
+    curr += size * 2;
+  }
+
+  return true;
+}
+
+void density_destroy(struct density *restrict density) {
+  if (!density) return;
+
+  free(density->counts);
+  *density = (struct density){0};
+}
+
+void density_clear(struct density *restrict density) {
+  if (!density || !density->counts) return;
+
+  struct density_level const *last = &density->level[density->levels - 1];
+  size_t total = (size_t)(last->flagged + last->rows * last->cols - density->counts);
+  memset(density->counts, 0, sizeof *density->counts * total);
+}
+
+void density_update(struct density *restrict density, size_t row, size_t col, int revealed, int flagged) {
+  if (!density || !density->counts) return;
+
+  for (size_t level = 0; level < density->levels; level++) {
+    struct density_level *curr = &density->level[level];
+    size_t shift = DENSITY_BLOCK_SHIFT + level;
+    size_t idx = (row >> shift) * curr->cols + (col >> shift);
+
+    curr->revealed[idx] += revealed;
+    curr->flagged[idx] += flagged;
+  }
+}
+
+void density_update_base(struct density *restrict density, size_t row, size_t col, int revealed, int flagged) {
+  if (!density || !density->counts) return;
+
+  struct density_level *base = &density->level[0];
+  size_t idx = (row >> DENSITY_BLOCK_SHIFT) * base->cols + (col >> DENSITY_BLOCK_SHIFT);
+
+  base->revealed[idx] += revealed;
+  base->flagged[idx] += flagged;
+}
+
+void density_propagate(struct density *restrict density) {
+  density_propagate_rows(density, 0, SIZE_MAX);
+}
+
+void density_propagate_rows(struct density *restrict density, size_t first, size_t last) {
+  if (!density || !density->counts || first > last) return;
+
+  for (size_t level = 1; level < density->levels; level++) {
+    struct density_level const *below = &density->level[level - 1];
+    struct density_level *curr = &density->level[level];
+
+    size_t shift = DENSITY_BLOCK_SHIFT + level;
+    size_t top = first >> shift;
+    if (top >= curr->rows) return;
+    size_t bottom = (last >> shift) < curr->rows ? last >> shift : curr->rows - 1;
+
+    size_t size = (bottom - top + 1) * curr->cols;
+    memset(&curr->revealed[top * curr->cols], 0, sizeof *curr->revealed * size);
+    memset(&curr->flagged[top * curr->cols], 0, sizeof *curr->flagged * size);
+
+    // each block sums the (up to) 2x2 blocks beneath it
+    size_t end = bottom * 2 + 2 < below->rows ? bottom * 2 + 2 : below->rows;
+    for (size_t row = top * 2; row < end; row++) {
+      for (size_t col = 0; col < below->cols; col++) {
+        curr->revealed[(row / 2) * curr->cols + col / 2] += below->revealed[row * below->cols + col];
+        curr->flagged[(row / 2) * curr->cols + col / 2] += below->flagged[row * below->cols + col];
+      }
+    }
+  }
+}
+
+size_t density_fitting_level(struct density const *restrict density, size_t rows, size_t cols) {
+  if (!density || !density->levels) return 0;
+
+  for (size_t level = 0; level < density->levels; level++) {
+    if (density->level[level].rows <= rows && density->level[level].cols <= cols) return level;
+  }
+
+  return density->levels - 1;
+}
+
+size_t density_block_size(size_t level) {
+  return (size_t)1 << (DENSITY_BLOCK_SHIFT + level);
+}
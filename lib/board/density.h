@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// level 0 blocks are (1 << DENSITY_BLOCK_SHIFT) cells wide and tall, each level above halves the amount of blocks
+#define DENSITY_BLOCK_SHIFT 3
+#define DENSITY_MAX_LEVELS 32
+// the most cells a board may have, a block's counts are 32 bits wide
+#define DENSITY_MAX_CELLS UINT32_MAX
+
+struct density_level {
+  size_t rows;  // the amount of blocks
+  size_t cols;
+
+  uint32_t *revealed;  // the amount of revealed cells within each block, row major
+  uint32_t *flagged;   // the amount of cells marked as mines within each block, row major
+};
+
+/*
+  a mip pyramid of per block aggregates of a board. every change of a cell is added onto the block holding it at every
+  level, so keeping it up to date costs O(levels) per changed cell and reading it never rescans the board. the counts
+  are 32 bits wide which caps the board at `DENSITY_MAX_CELLS`
+*/
+struct density {
+  size_t levels;
+  struct density_level level[DENSITY_MAX_LEVELS];
+
+  uint32_t *counts;  // all levels are carved out of a single allocation
+};
+
+bool density_create(struct density *restrict density, size_t rows, size_t cols);
+
+void density_destroy(struct density *restrict density);
+
+/* zeroes all the counts */
+void density_clear(struct density *restrict density);
+
+/* adds `revealed` and `flagged` (either may be negative) onto the blocks holding the cell at (row, col) */
+void density_update(struct density *restrict density, size_t row, size_t col, int revealed, int flagged);
+
+/* same as `density_update` but only adds onto level 0. one has to `density_propagate` afterwards */
+void density_update_base(struct density *restrict density, size_t row, size_t col, int revealed, int flagged);
+
+/* recomputes all levels past the first from level 0 */
+void density_propagate(struct density *restrict density);
+
+/* same as `density_propagate` but only recomputes the blocks over the cell rows [first, last] */
+void density_propagate_rows(struct density *restrict density, size_t first, size_t last);
+
+/* the finest level whose blocks fit within `rows x cols`, or the coarsest one if none does */
+size_t density_fitting_level(struct density const *restrict density, size_t rows, size_t cols);
+
+/* the width (and height) in cells of a block at `level` */
+size_t density_block_size(size_t level);
@@ -0,0 +1,862 @@
+#include "solver.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum solver_local_size {
+  SOLVER_NEIGHBOURS = 8,
+  SOLVER_COMPONENT = 256,    // the most cells of a component whose arrangements are counted, larger ones are estimated
+  SOLVER_COMPONENTS = 32,    // the most components weighed against each other, more are weighed against the density
+  SOLVER_NODES = 1 << 22,    // the arrangements tried per solve, the components left once they're spent are estimated
+  SOLVER_CANCEL_EVERY = 4096,  // arrangements tried between two calls to `cancel`
+};
+
+// what the solver knows of a cell, revealed numbers are kept as they are
+enum view {
+  VIEW_HIDDEN = 9,
+  VIEW_MARKED,  // hidden as well, but marked by the player so it can't be opened as it is
+  VIEW_MINE,    // revealed, the game is lost
+};
+
+// a hidden cell next to a revealed number
+struct var {
+  size_t cell;
+  size_t component;
+  double mine;        // the chance of a mine, once counted
+  signed char value;  // -1 until deduced, then the amount of mines under the cell
+  unsigned char constraints_amount;
+  size_t constraints[SOLVER_NEIGHBOURS];
+};
+
+// a revealed number and the vars around it
+struct constraint {
+  int mines;    // the mines left among the vars not deduced yet
+  int unknown;  // the amount of those vars
+  bool queued;
+  unsigned char vars_amount;
+  size_t vars[SOLVER_NEIGHBOURS];
+};
+
+// vars connected through the numbers they share, counted as a whole
+struct component {
+  size_t first;  // into `order`
+  size_t size;
+  size_t counts;  // into `counts`, the arrangements per amount of mines and then as many per var, when it's weighed
+  bool estimated;
+};
+
+struct solver {
+  size_t rows;
+  size_t cols;
+  size_t mines;
+  size_t hidden;
+  size_t known_mines;  // revealed ones
+
+  unsigned char *view;
+  size_t view_capacity;
+
+  struct var *vars;
+  size_t vars_amount;
+  size_t vars_capacity;
+
+  struct constraint *constraints;
+  size_t constraints_amount;
+  size_t constraints_capacity;
+
+  size_t *queue;  // the constraints to settle, as many as there are
+  size_t queued;
+  size_t queue_capacity;
+
+  size_t *order;  // the vars not deduced, a component after the other
+  size_t order_capacity;
+
+  size_t *stack;  // the cells left to open, see `open`
+  size_t stack_capacity;
+
+  struct component *components;
+  size_t components_amount;
+  size_t components_capacity;
+
+  double *counts;
+  size_t counts_amount;
+  size_t counts_capacity;
+
+  // per amount of mines, as many as there are vars plus one each. all four are carved out of `numbers`
+  double *numbers;
+  size_t numbers_capacity;
+  double *total;
+  double *others;
+  double *scratch;
+  double *ways;  // see `weigh_together`
+
+  double weights[SOLVER_COMPONENT + 1];
+
+  size_t nodes;
+  bool cancelled;
+  solver_cancel cancel;
+  void *context;
+};
+
+// makes room for `amount` items of `size` bytes, at least twice as many as before. returns NULL if it can't, `items`
+// are left as they were then
+static void *reserve(void *items, size_t *restrict capacity, size_t amount, size_t size) {
+  if (amount <= *capacity) return items;
+
+  size_t grown_capacity = *capacity > amount / 2 ? *capacity * 2 : amount;
+  if (grown_capacity > SIZE_MAX / size) return NULL;
+
+  void *grown = realloc(items, grown_capacity * size);
+  if (grown) *capacity = grown_capacity;
+  return grown;
+}
+
+static bool cancelled(struct solver *restrict solver) {
+  if (!solver->cancelled && solver->cancel) solver->cancelled = solver->cancel(solver->context);
+  return solver->cancelled;
+}
+
+static bool is_hidden(unsigned char view) {
+  return view == VIEW_HIDDEN || view == VIEW_MARKED;
+}
+
+static bool is_number(unsigned char view) {
+  return view < VIEW_HIDDEN;
+}
+
+// the cells around `cell`, within the board
+static size_t around(struct solver const *restrict solver, size_t cell, size_t *restrict cells) {
+  size_t row = cell / solver->cols;
+  size_t col = cell % solver->cols;
+
+  size_t amount = 0;
+  for (size_t r = row ? row - 1 : 0; r <= row + 1 && r < solver->rows; r++) {
+    for (size_t c = col ? col - 1 : 0; c <= col + 1 && c < solver->cols; c++) {
+      if (r != row || c != col) cells[amount++] = r * solver->cols + c;
+    }
+  }
+  return amount;
+}
+
+static bool load(struct solver *restrict solver, struct board_version const *restrict version) {
+  size_t cells = version->rows * version->cols;
+  unsigned char *view = reserve(solver->view, &solver->view_capacity, cells, sizeof *view);
+  if (!view) return false;
+  solver->view = view;
+
+  solver->rows = version->rows;
+  solver->cols = version->cols;
+  solver->mines = version->mines;
+  solver->hidden = 0;
+  solver->known_mines = 0;
+
+  for (size_t row = 0; row < version->rows; row++) {
+    for (size_t col = 0; col < version->cols; col++) {
+      struct cell cell = board_version_cell(version, row, col);
+
+      unsigned char known = cell.mark == MARK_NONE ? VIEW_HIDDEN : VIEW_MARKED;
+      if (cell.revealed) known = cell.mine ? VIEW_MINE : cell.adjacent_mines;
+      view[row * version->cols + col] = known;
+
+      solver->hidden += is_hidden(known);
+      solver->known_mines += known == VIEW_MINE;
+    }
+  }
+  return true;
+}
+
+// a board of that size none of the cells of which are revealed yet
+static bool load_hidden(struct solver *restrict solver, struct board const *restrict board) {
+  size_t cells = board_rows(board) * board_cols(board);
+  unsigned char *view = reserve(solver->view, &solver->view_capacity, cells, sizeof *view);
+  if (!view) return false;
+  solver->view = view;
+
+  solver->rows = board_rows(board);
+  solver->cols = board_cols(board);
+  solver->mines = board_mines(board);
+  solver->hidden = cells;
+  solver->known_mines = 0;
+  memset(view, VIEW_HIDDEN, cells);
+  return true;
+}
+
+// reveals `cell` as `board` holds it, and the cells around it as long as they're zeros. false if it's a mine
+static bool open(struct solver *restrict solver, struct board const *restrict board, size_t cell) {
+  if (!is_hidden(solver->view[cell])) return true;
+
+  struct cell truth = board_cell(board, cell / solver->cols, cell % solver->cols);
+  if (truth.mine) return false;
+
+  solver->view[cell] = truth.adjacent_mines;
+  solver->hidden--;
+  if (truth.adjacent_mines) return true;
+
+  // the zeros whose neighbours are left to reveal. cells are revealed as they're found, so each zero is pushed once at
+  // most and the stack only grows as large as the edge of the region opened so far
+  size_t neighbours[SOLVER_NEIGHBOURS];
+  size_t size = 0;
+  size_t *stack = reserve(solver->stack, &solver->stack_capacity, 1, sizeof *stack);
+  if (!stack) return true;
+  solver->stack = stack;
+  solver->stack[size++] = cell;
+
+  while (size) {
+    size_t amount = around(solver, solver->stack[--size], neighbours);
+    for (size_t i = 0; i < amount; i++) {
+      if (!is_hidden(solver->view[neighbours[i]])) continue;
+
+      // the neighbours of a zero are never mines
+      truth = board_cell(board, neighbours[i] / solver->cols, neighbours[i] % solver->cols);
+      if (!truth.adjacent_mines) {
+        // a zero that can't be pushed stays hidden, the next round finds it safe all the same
+        stack = reserve(solver->stack, &solver->stack_capacity, size + 1, sizeof *stack);
+        if (!stack) continue;
+
+        solver->stack = stack;
+        solver->stack[size++] = neighbours[i];
+      }
+      solver->view[neighbours[i]] = truth.adjacent_mines;
+      solver->hidden--;
+    }
+  }
+  return true;
+}
+
+static int compare_cells(void const *key, void const *var) {
+  size_t cell = *(size_t const *)key;
+  size_t other = ((struct var const *)var)->cell;
+  return (cell > other) - (cell < other);
+}
+
+// the var of `cell`, or `vars_amount` if it isn't one. vars are collected in row major order
+static size_t find_var(struct solver const *restrict solver, size_t cell) {
+  struct var const *var = bsearch(&cell, solver->vars, solver->vars_amount, sizeof *solver->vars, compare_cells);
+  return var ? (size_t)(var - solver->vars) : solver->vars_amount;
+}
+
+static bool collect(struct solver *restrict solver) {
+  size_t cells = solver->rows * solver->cols;
+  size_t neighbours[SOLVER_NEIGHBOURS];
+
+  solver->vars_amount = 0;
+  for (size_t cell = 0; cell < cells; cell++) {
+    if (!is_hidden(solver->view[cell])) continue;
+
+    size_t amount = around(solver, cell, neighbours);
+    size_t i = 0;
+    while (i < amount && !is_number(solver->view[neighbours[i]])) i++;
+    if (i == amount) continue;
+
+    struct var *vars = reserve(solver->vars, &solver->vars_capacity, solver->vars_amount + 1, sizeof *vars);
+    if (!vars) return false;
+    solver->vars = vars;
+
+    vars[solver->vars_amount++] = (struct var){.cell = cell, .value = -1};
+  }
+
+  solver->constraints_amount = 0;
+  for (size_t cell = 0; cell < cells; cell++) {
+    if (!is_number(solver->view[cell])) continue;
+
+    struct constraint constraint = {.mines = solver->view[cell]};
+    size_t amount = around(solver, cell, neighbours);
+    for (size_t i = 0; i < amount; i++) {
+      unsigned char view = solver->view[neighbours[i]];
+      if (view == VIEW_MINE) constraint.mines--;
+      if (is_hidden(view)) constraint.vars[constraint.vars_amount++] = find_var(solver, neighbours[i]);
+    }
+    if (!constraint.vars_amount) continue;
+
+    constraint.unknown = constraint.vars_amount;
+    struct constraint *constraints =
+      reserve(solver->constraints, &solver->constraints_capacity, solver->constraints_amount + 1, sizeof *constraints);
+    if (!constraints) return false;
+    solver->constraints = constraints;
+
+    for (size_t i = 0; i < constraint.vars_amount; i++) {
+      struct var *var = &solver->vars[constraint.vars[i]];
+      var->constraints[var->constraints_amount++] = solver->constraints_amount;
+    }
+    solver->constraints[solver->constraints_amount++] = constraint;
+  }
+
+  size_t *queue = reserve(solver->queue, &solver->queue_capacity, solver->constraints_amount + 1, sizeof *queue);
+  if (!queue) return false;
+  solver->queue = queue;
+
+  size_t *order = reserve(solver->order, &solver->order_capacity, solver->vars_amount + 1, sizeof *order);
+  if (!order) return false;
+  solver->order = order;
+
+  // the amounts of mines run from 0 to as many as there are vars
+  size_t amounts = solver->vars_amount + 1;
+  double *numbers = reserve(solver->numbers, &solver->numbers_capacity, amounts * 4, sizeof *numbers);
+  if (!numbers) return false;
+  solver->numbers = numbers;
+  solver->total = numbers;
+  solver->others = numbers + amounts;
+  solver->scratch = numbers + amounts * 2;
+  solver->ways = numbers + amounts * 3;
+  return true;
+}
+
+static void enqueue(struct solver *restrict solver, size_t constraint) {
+  if (solver->constraints[constraint].queued) return;
+
+  solver->constraints[constraint].queued = true;
+  solver->queue[solver->queued++] = constraint;
+}
+
+// sets a var and tells whether its numbers still allow it
+static bool set(struct solver *restrict solver, size_t index, signed char value) {
+  struct var *var = &solver->vars[index];
+  var->value = value;
+
+  bool allowed = true;
+  for (size_t i = 0; i < var->constraints_amount; i++) {
+    struct constraint *constraint = &solver->constraints[var->constraints[i]];
+    constraint->unknown--;
+    constraint->mines -= value;
+    allowed = allowed && constraint->mines >= 0 && constraint->mines <= constraint->unknown;
+  }
+  return allowed;
+}
+
+static void unset(struct solver *restrict solver, size_t index) {
+  struct var *var = &solver->vars[index];
+  for (size_t i = 0; i < var->constraints_amount; i++) {
+    struct constraint *constraint = &solver->constraints[var->constraints[i]];
+    constraint->unknown++;
+    constraint->mines += var->value;
+  }
+  var->value = -1;
+}
+
+static bool deduce(struct solver *restrict solver, size_t index, signed char value) {
+  if (!set(solver, index, value)) return false;
+
+  struct var const *var = &solver->vars[index];
+  for (size_t i = 0; i < var->constraints_amount; i++) enqueue(solver, var->constraints[i]);
+  return true;
+}
+
+// a number with no mines left around it clears its other vars, one with as many mines left as vars mines them all
+static bool propagate(struct solver *restrict solver) {
+  while (solver->queued) {
+    struct constraint *constraint = &solver->constraints[solver->queue[--solver->queued]];
+    constraint->queued = false;
+    if (!constraint->unknown) continue;
+    if (constraint->mines && constraint->mines != constraint->unknown) continue;
+
+    signed char value = constraint->mines ? 1 : 0;
+    for (size_t i = 0; i < constraint->vars_amount; i++) {
+      if (solver->vars[constraint->vars[i]].value < 0 && !deduce(solver, constraint->vars[i], value)) return false;
+    }
+  }
+  return true;
+}
+
+static bool holds(struct constraint const *restrict constraint, size_t var) {
+  for (size_t i = 0; i < constraint->vars_amount; i++) {
+    if (constraint->vars[i] == var) return true;
+  }
+  return false;
+}
+
+// when the vars of `inner` left are among those of `outer`, the rest of `outer` holds the difference of their mines
+static bool subtract(struct solver *restrict solver, size_t inner, size_t outer) {
+  struct constraint const *a = &solver->constraints[inner];
+  struct constraint const *b = &solver->constraints[outer];
+  if (!a->unknown || a->unknown >= b->unknown) return true;
+
+  for (size_t i = 0; i < a->vars_amount; i++) {
+    if (solver->vars[a->vars[i]].value < 0 && !holds(b, a->vars[i])) return true;
+  }
+
+  int mines = b->mines - a->mines;
+  int rest = b->unknown - a->unknown;
+  if (mines && mines != rest) return true;
+
+  for (size_t i = 0; i < b->vars_amount; i++) {
+    size_t var = b->vars[i];
+    if (solver->vars[var].value >= 0 || holds(a, var)) continue;
+    if (!deduce(solver, var, mines ? 1 : 0)) return false;
+  }
+  return true;
+}
+
+static bool settle(struct solver *restrict solver) {
+  solver->queued = 0;
+  for (size_t i = 0; i < solver->constraints_amount; i++) enqueue(solver, i);
+  if (!propagate(solver)) return false;
+
+  // pairs of numbers sharing a var, until they tell nothing more
+  for (bool changed = true; changed;) {
+    if (cancelled(solver)) return false;
+
+    changed = false;
+    for (size_t i = 0; i < solver->constraints_amount; i++) {
+      struct constraint const *constraint = &solver->constraints[i];
+      if (!constraint->unknown) continue;
+
+      for (size_t j = 0; j < constraint->vars_amount; j++) {
+        struct var const *var = &solver->vars[constraint->vars[j]];
+        if (var->value >= 0) continue;
+
+        for (size_t k = 0; k < var->constraints_amount; k++) {
+          if (var->constraints[k] == i) continue;
+          if (!subtract(solver, i, var->constraints[k])) return false;
+        }
+      }
+
+      changed = changed || solver->queued;
+      if (!propagate(solver)) return false;
+    }
+  }
+  return true;
+}
+
+// labels the vars left a component at a time, each in breadth first order so arrangements fail early
+static bool split(struct solver *restrict solver) {
+  size_t const none = SIZE_MAX;
+  for (size_t i = 0; i < solver->vars_amount; i++) solver->vars[i].component = none;
+
+  solver->components_amount = 0;
+  size_t end = 0;
+  for (size_t seed = 0; seed < solver->vars_amount; seed++) {
+    if (solver->vars[seed].value >= 0 || solver->vars[seed].component != none) continue;
+
+    struct component *components =
+      reserve(solver->components, &solver->components_capacity, solver->components_amount + 1, sizeof *components);
+    if (!components) return false;
+    solver->components = components;
+
+    size_t id = solver->components_amount++;
+    solver->components[id] = (struct component){.first = end};
+
+    solver->vars[seed].component = id;
+    solver->order[end++] = seed;
+    for (size_t next = solver->components[id].first; next < end; next++) {
+      struct var const *var = &solver->vars[solver->order[next]];
+      for (size_t i = 0; i < var->constraints_amount; i++) {
+        struct constraint const *constraint = &solver->constraints[var->constraints[i]];
+        for (size_t j = 0; j < constraint->vars_amount; j++) {
+          struct var *other = &solver->vars[constraint->vars[j]];
+          if (other->value >= 0 || other->component != none) continue;
+
+          other->component = id;
+          solver->order[end++] = constraint->vars[j];
+        }
+      }
+    }
+    solver->components[id].size = end - solver->components[id].first;
+  }
+  return true;
+}
+
+// counts the arrangements of the component's vars from `depth` on, per amount of mines and per var
+static void arrange(struct solver *restrict solver,
+                    size_t const *restrict vars,
+                    size_t size,
+                    size_t depth,
+                    size_t mines,
+                    double *restrict counts) {
+  if (depth == size) {
+    counts[mines]++;
+    for (size_t i = 0; i < size; i++) {
+      if (solver->vars[vars[i]].value) counts[(size + 1) * (i + 1) + mines]++;
+    }
+    return;
+  }
+
+  for (signed char value = 0; value < 2; value++) {
+    if (solver->nodes >= SOLVER_NODES) return;
+    if (++solver->nodes % SOLVER_CANCEL_EVERY == 0 && cancelled(solver)) return;
+
+    if (set(solver, vars[depth], value)) arrange(solver, vars, size, depth + 1, mines + value, counts);
+    unset(solver, vars[depth]);
+  }
+}
+
+// the chance of a mine from the numbers around the var alone
+static void estimate(struct solver *restrict solver, struct component const *restrict component) {
+  for (size_t i = 0; i < component->size; i++) {
+    struct var *var = &solver->vars[solver->order[component->first + i]];
+
+    double mine = 0;
+    for (size_t j = 0; j < var->constraints_amount; j++) {
+      struct constraint const *constraint = &solver->constraints[var->constraints[j]];
+      mine += (double)constraint->mines / constraint->unknown;
+    }
+    var->mine = mine / var->constraints_amount;
+  }
+}
+
+// counts every component small enough while the budget lasts, the others are estimated
+static bool count(struct solver *restrict solver) {
+  solver->counts_amount = 0;
+  for (size_t id = 0; id < solver->components_amount; id++) {
+    struct component *component = &solver->components[id];
+    size_t size = component->size;
+
+    component->estimated = size > SOLVER_COMPONENT || solver->nodes >= SOLVER_NODES;
+    if (component->estimated) {
+      estimate(solver, component);
+      continue;
+    }
+
+    size_t amount = (size + 1) * (size + 1);
+    double *all = reserve(solver->counts, &solver->counts_capacity, solver->counts_amount + amount, sizeof *all);
+    if (!all) return false;
+    solver->counts = all;
+
+    component->counts = solver->counts_amount;
+    solver->counts_amount += amount;
+
+    double *counts = solver->counts + component->counts;
+    memset(counts, 0, amount * sizeof *counts);
+    arrange(solver, solver->order + component->first, size, 0, 0, counts);
+    if (solver->cancelled) return false;
+
+    // ran out of budget halfway through
+    if (solver->nodes >= SOLVER_NODES) {
+      component->estimated = true;
+      estimate(solver, component);
+    }
+  }
+  return true;
+}
+
+// `into` = `a` * `b` as polynomials, rescaled so its largest coefficient is 1 - only the ratios matter
+static size_t convolve(double *restrict into,
+                       double const *restrict a,
+                       size_t a_size,
+                       double const *restrict b,
+                       size_t b_size) {
+  size_t size = a_size + b_size - 1;
+  memset(into, 0, size * sizeof *into);
+  for (size_t i = 0; i < a_size; i++) {
+    for (size_t j = 0; j < b_size; j++) into[i + j] += a[i] * b[j];
+  }
+
+  double max = 0;
+  for (size_t i = 0; i < size; i++) max = into[i] > max ? into[i] : max;
+  for (size_t i = 0; max > 0 && i < size; i++) into[i] /= max;
+  return size;
+}
+
+// the chance of a mine under every var of a counted component given the weight of each amount of mines in it
+static void weigh(struct solver *restrict solver, struct component const *restrict component, double const *weights) {
+  size_t size = component->size;
+  double const *counts = solver->counts + component->counts;
+
+  double total = 0;
+  for (size_t k = 0; k <= size; k++) total += counts[k] * weights[k];
+
+  // no amount of mines in the component fits with the others, its arrangements are taken as they are
+  bool unweighted = !(total > 0);
+  if (unweighted) {
+    for (size_t k = 0; k <= size; k++) total += counts[k];
+  }
+
+  for (size_t i = 0; i < size; i++) {
+    double mines = 0;
+    for (size_t k = 0; k <= size; k++) mines += counts[(size + 1) * (i + 1) + k] * (unweighted ? 1 : weights[k]);
+    solver->vars[solver->order[component->first + i]].mine = total > 0 ? mines / total : 0.5;
+  }
+}
+
+// the product of the counted components' arrangements but `skip`, per amount of mines
+static size_t product(struct solver *restrict solver, size_t skip, double *restrict into) {
+  double *from = solver->scratch;
+  into[0] = 1;
+  size_t size = 1;
+
+  for (size_t id = 0; id < solver->components_amount; id++) {
+    struct component const *component = &solver->components[id];
+    if (id == skip || component->estimated) continue;
+
+    memcpy(from, into, size * sizeof *from);
+    size = convolve(into, from, size, solver->counts + component->counts, component->size + 1);
+  }
+  return size;
+}
+
+/*
+  the mines left past the counted components go into the estimated ones and the cells next to no number, the interior.
+  an amount m of them in the interior can be dealt in C(interior, m) ways. returns the chance of a mine in the interior
+*/
+static double weigh_together(struct solver *restrict solver, size_t interior, double left) {
+  size_t mines = left > 0 ? (size_t)(left + 0.5) : 0;
+
+  // ways[t] is log C(interior, mines - t) for t mines next to the numbers, up to a constant as only their ratios
+  // matter. C(n, k - 1) = C(n, k) * k / (n - k + 1), lgamma would do but isn't thread safe
+  size_t first = mines > interior ? mines - interior : 0;
+  if (first <= solver->vars_amount) solver->ways[first] = 0;
+  for (size_t t = first + 1; t <= solver->vars_amount && t <= mines; t++) {
+    size_t k = mines - t + 1;
+    solver->ways[t] = solver->ways[t - 1] + log((double)k / (double)(interior - k + 1));
+  }
+
+  for (size_t id = 0; id < solver->components_amount; id++) {
+    struct component const *component = &solver->components[id];
+    if (component->estimated) continue;
+
+    size_t others = product(solver, id, solver->others);
+
+    // weights[k], k mines in the component, is the sum over the others' arrangements of the ways left for the interior
+    double *weights = solver->weights;
+    double max = -INFINITY;
+    for (size_t k = 0; k <= component->size; k++) {
+      for (size_t m = 0; m < others; m++) {
+        if (k + m > mines || mines - k - m > interior || !solver->others[m]) continue;
+        double weight = solver->ways[k + m];
+        max = weight > max ? weight : max;
+      }
+    }
+    for (size_t k = 0; k <= component->size; k++) {
+      weights[k] = 0;
+      for (size_t m = 0; m < others; m++) {
+        if (k + m > mines || mines - k - m > interior || !solver->others[m]) continue;
+        weights[k] += solver->others[m] * exp(solver->ways[k + m] - max);
+      }
+    }
+    weigh(solver, component, weights);
+  }
+
+  if (!interior) return 1;
+
+  size_t size = product(solver, SIZE_MAX, solver->total);
+  double max = -INFINITY;
+  for (size_t m = 0; m < size; m++) {
+    if (m > mines || mines - m > interior || !solver->total[m]) continue;
+    double weight = solver->ways[m];
+    max = weight > max ? weight : max;
+  }
+
+  double all = 0;
+  double inside = 0;
+  for (size_t m = 0; m < size; m++) {
+    if (m > mines || mines - m > interior || !solver->total[m]) continue;
+    double weight = solver->total[m] * exp(solver->ways[m] - max);
+    all += weight;
+    inside += weight * (double)(mines - m) / interior;
+  }
+  return all > 0 ? inside / all : left / interior;
+}
+
+// too many components to weigh against each other, each is weighed against the density of the mines left instead
+static double weigh_apart(struct solver *restrict solver, size_t interior, double left, size_t unknown) {
+  double const least = 1e-9;
+  double density = unknown ? left / unknown : 0;
+  density = density < least ? least : density > 1 - least ? 1 - least : density;
+
+  // a mine more is as much likelier as the odds of a cell holding one. the largest weight is 1
+  double odds = log(density / (1 - density));
+  for (size_t id = 0; id < solver->components_amount; id++) {
+    struct component const *component = &solver->components[id];
+    if (component->estimated) continue;
+
+    double *weights = solver->weights;
+    double max = odds > 0 ? odds * (double)component->size : 0;
+    for (size_t k = 0; k <= component->size; k++) weights[k] = exp(odds * (double)k - max);
+    weigh(solver, component, weights);
+  }
+
+  if (!interior) return 1;
+
+  double expected = 0;
+  for (size_t i = 0; i < solver->vars_amount; i++) {
+    struct var const *var = &solver->vars[i];
+    if (var->value < 0 && !solver->components[var->component].estimated) expected += var->mine;
+  }
+  double mine = (left - expected) / interior;
+  return mine < 0 ? 0 : mine > 1 ? 1 : mine;
+}
+
+// an interior cell to open, a corner one rather as it's the likeliest to open a region. SIZE_MAX if there's none
+static size_t pick_interior(struct solver const *restrict solver) {
+  size_t last_row = (solver->rows - 1) * solver->cols;
+  size_t const corners[] = {0, solver->cols - 1, last_row, last_row + solver->cols - 1};
+  for (size_t i = 0; i < sizeof corners / sizeof *corners; i++) {
+    size_t cell = corners[i];
+    if (solver->view[cell] == VIEW_HIDDEN && find_var(solver, cell) == solver->vars_amount) return cell;
+  }
+
+  for (size_t cell = 0; cell < solver->rows * solver->cols; cell++) {
+    if (solver->view[cell] == VIEW_HIDDEN && find_var(solver, cell) == solver->vars_amount) return cell;
+  }
+  return SIZE_MAX;
+}
+
+static bool probabilities(struct solver *restrict solver, double *restrict interior_mine) {
+  if (!split(solver) || !count(solver)) return false;
+
+  // the mines left once the known ones and those the estimated components likely hold are taken out, and the cells
+  // they're left to
+  double left = (double)solver->mines - (double)solver->known_mines;
+  size_t unknown = 0;
+  for (size_t i = 0; i < solver->vars_amount; i++) {
+    struct var const *var = &solver->vars[i];
+    if (var->value > 0) left--;
+    if (var->value >= 0) continue;
+
+    if (solver->components[var->component].estimated) {
+      left -= var->mine;
+    } else {
+      unknown++;
+    }
+  }
+
+  size_t interior = solver->hidden - solver->vars_amount;
+  *interior_mine = solver->components_amount <= SOLVER_COMPONENTS
+                     ? weigh_together(solver, interior, left)
+                     : weigh_apart(solver, interior, left, unknown + interior);
+  return true;
+}
+
+static void begin(struct solver *restrict solver, solver_cancel cancel, void *context) {
+  solver->nodes = 0;
+  solver->cancelled = false;
+  solver->cancel = cancel;
+  solver->context = context;
+}
+
+// opens the cells the numbers prove safe, or marks the mines they prove. how many cells it settled, none when the
+// numbers prove nothing
+static size_t open_safe(struct solver *restrict solver, struct board const *restrict board) {
+  size_t opened = 0;
+  for (size_t i = 0; i < solver->vars_amount; i++) {
+    struct var const *var = &solver->vars[i];
+    if (var->value < 0) continue;
+
+    // the mines are marked so the next rounds leave them out
+    if (var->value) {
+      solver->view[var->cell] = VIEW_MINE;
+      solver->hidden--;
+      solver->known_mines++;
+    } else {
+      open(solver, board, var->cell);
+    }
+    opened++;
+  }
+  if (opened) return opened;
+
+  double interior_mine = 1;
+  if (!probabilities(solver, &interior_mine)) return 0;
+
+  // only counted arrangements prove anything, estimated ones don't
+  bool counted = true;
+  for (size_t i = 0; i < solver->vars_amount; i++) {
+    struct var const *var = &solver->vars[i];
+    if (var->value >= 0) continue;
+
+    if (solver->components[var->component].estimated) {
+      counted = false;
+    } else if (var->mine == 0) {
+      open(solver, board, var->cell);
+      opened++;
+    }
+  }
+  if (opened || !counted || interior_mine != 0) return opened;
+
+  // the numbers hold every mine left, the interior is safe
+  size_t cells = solver->rows * solver->cols;
+  for (size_t cell = 0; cell < cells; cell++) {
+    if (solver->view[cell] != VIEW_HIDDEN || find_var(solver, cell) != solver->vars_amount) continue;
+
+    open(solver, board, cell);
+    opened++;
+  }
+  return opened;
+}
+
+struct solver *solver_create(void) {
+  return calloc(1, sizeof(struct solver));
+}
+
+void solver_destroy(struct solver *restrict solver) {
+  if (!solver) return;
+
+  free(solver->view);
+  free(solver->vars);
+  free(solver->constraints);
+  free(solver->queue);
+  free(solver->order);
+  free(solver->stack);
+  free(solver->components);
+  free(solver->counts);
+  free(solver->numbers);
+  free(solver);
+}
+
+bool solver_hint(struct solver *restrict solver,
+                 struct board_version const *restrict version,
+                 solver_cancel cancel,
+                 void *context,
+                 struct solver_hint *restrict hint) {
+  if (!solver || !version || !hint || !version->rows || !version->cols) return false;
+
+  begin(solver, cancel, context);
+
+  if (!load(solver, version) || cancelled(solver)) return false;
+  if (!collect(solver) || cancelled(solver)) return false;
+
+  // numbers that contradict each other, there's nothing to tell
+  if (!settle(solver)) return false;
+
+  size_t best = SIZE_MAX;
+  double mine = 2;
+  for (size_t i = 0; i < solver->vars_amount; i++) {
+    struct var const *var = &solver->vars[i];
+    if (var->value || solver->view[var->cell] == VIEW_MARKED) continue;
+
+    best = var->cell;
+    mine = 0;
+    break;
+  }
+
+  if (best == SIZE_MAX) {
+    double interior_mine = 1;
+    if (!probabilities(solver, &interior_mine)) return false;
+
+    for (size_t i = 0; i < solver->vars_amount; i++) {
+      struct var const *var = &solver->vars[i];
+      if (var->value >= 0 || solver->view[var->cell] == VIEW_MARKED || var->mine >= mine) continue;
+
+      best = var->cell;
+      mine = var->mine;
+    }
+
+    size_t interior = interior_mine < mine ? pick_interior(solver) : SIZE_MAX;
+    if (interior != SIZE_MAX) {
+      best = interior;
+      mine = interior_mine;
+    }
+  }
+  if (best == SIZE_MAX) return false;
+
+  *hint = (struct solver_hint){.row = best / solver->cols, .col = best % solver->cols, .mine = mine};
+  return true;
+}
+
+bool solver_clears(struct solver *restrict solver,
+                   struct board const *restrict board,
+                   size_t row,
+                   size_t col,
+                   solver_cancel cancel,
+                   void *context) {
+  if (!solver || !board || row >= board_rows(board) || col >= board_cols(board)) return false;
+
+  begin(solver, cancel, context);
+  if (!load_hidden(solver, board) || !open(solver, board, row * solver->cols + col)) return false;
+
+  // each round counts from the cells opened by the last, with a budget of its own
+  while (solver->hidden > solver->mines - solver->known_mines) {
+    solver->nodes = 0;
+    if (cancelled(solver) || !collect(solver) || !settle(solver)) return false;
+    if (!open_safe(solver, board)) return false;
+  }
+  return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "version.h"
+
+/*
+  tells what it can of the hidden cells of a board from what a player sees of it. the cells the numbers settle are
+  deduced first, alone and pairwise. the chance of a mine under the others is counted over every arrangement of mines
+  the numbers allow, each weighted by the ways the mines left can be dealt into the cells no number touches. large
+  arrangements are estimated from the numbers around their cells. marks are the player's guesses, they aren't trusted
+*/
+struct solver;
+
+struct solver_hint {
+  size_t row;
+  size_t col;
+  double mine;  // the chance of a mine under the cell, 0 if it's known to be safe
+};
+
+// asked every so often during a solve, which gives up once it returns true
+typedef bool (*solver_cancel)(void *context);
+
+/* the solver keeps its storage from a solve to the next */
+struct solver *solver_create(void);
+
+void solver_destroy(struct solver *restrict solver);
+
+/* the hidden unmarked cell of `version` least likely to hide a mine. returns false if there's none, if `cancel` (which
+ * may be NULL) gave up or if the solver ran out of memory */
+bool solver_hint(struct solver *restrict solver,
+                 struct board_version const *restrict version,
+                 solver_cancel cancel,
+                 void *context,
+                 struct solver_hint *restrict hint);
+
+/* whether `board` can be cleared without a guess from the cell at (row, col): opening it and then only the cells the
+ * numbers prove safe opens every cell but the mines. false as well if `cancel` (which may be NULL) gave up or if the
+ * solver ran out of memory */
+bool solver_clears(struct solver *restrict solver,
+                   struct board const *restrict board,
+                   size_t row,
+                   size_t col,
+                   solver_cancel cancel,
+                   void *context);
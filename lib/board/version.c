@@ -0,0 +1,277 @@
+#include "version.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
+
+enum version_local_size {
+  CHUNK_CELLS = 4096,  // a chunk holds as many whole rows as fit, a single one at least
+};
+
+// only the publishing thread counts the references to a chunk, readers never touch them
+struct board_chunk {
+  size_t references;
+  struct cell cells[];
+};
+
+struct board_versions {
+  struct board_version *latest;  // written by the publisher alone
+  uint64_t sequence;             // the latest's, readable without holding it
+
+  // how far into the board's changes the latest version goes
+  uint64_t epoch;
+  size_t changes;
+
+  struct board_version *retired;  // superseded versions, freed once no reader holds them
+
+  size_t readers;
+  struct board_version *hazards[];  // the version each reader holds
+};
+
+/*
+  what the threads share is accessed sequentially consistent. a reader announces the version it takes before checking
+  it's still the latest, the publisher replaces the latest before looking for announced versions. either the reader
+  sees the new version and tries again, or the publisher sees the announcement and keeps the version
+*/
+#ifdef _MSC_VER
+static struct board_version *load_version(struct board_version *volatile *slot) {
+  return InterlockedCompareExchangePointer((PVOID volatile *)slot, NULL, NULL);
+}
+
+static void store_version(struct board_version *volatile *slot, struct board_version *version) {
+  InterlockedExchangePointer((PVOID volatile *)slot, version);
+}
+
+static uint64_t load_sequence(uint64_t volatile *sequence) {
+  return (uint64_t)InterlockedCompareExchange64((LONG64 volatile *)sequence, 0, 0);
+}
+
+static void store_sequence(uint64_t volatile *sequence, uint64_t value) {
+  InterlockedExchange64((LONG64 volatile *)sequence, (LONG64)value);
+}
+#else
+static struct board_version *load_version(struct board_version *volatile *slot) {
+  return __atomic_load_n(slot, __ATOMIC_SEQ_CST);
+}
+
+static void store_version(struct board_version *volatile *slot, struct board_version *version) {
+  __atomic_store_n(slot, version, __ATOMIC_SEQ_CST);
+}
+
+static uint64_t load_sequence(uint64_t volatile *sequence) {
+  return __atomic_load_n(sequence, __ATOMIC_SEQ_CST);
+}
+
+static void store_sequence(uint64_t volatile *sequence, uint64_t value) {
+  __atomic_store_n(sequence, value, __ATOMIC_SEQ_CST);
+}
+#endif
+
+// what a player sees of a cell
+static struct cell visible(struct cell cell) {
+  return cell.revealed ? cell : (struct cell){.mark = cell.mark};
+}
+
+static size_t chunk_size(struct board_version const *restrict version, size_t chunk) {
+  size_t first = chunk * version->chunk_rows;
+  size_t rows = version->rows - first < version->chunk_rows ? version->rows - first : version->chunk_rows;
+  return rows * version->cols;
+}
+
+static struct board_chunk *chunk_create(size_t cells) {
+  struct board_chunk *chunk = malloc(sizeof *chunk + cells * sizeof *chunk->cells);
+  if (!chunk) return NULL;
+
+  chunk->references = 1;
+  return chunk;
+}
+
+static void chunk_release(struct board_chunk *restrict chunk) {
+  if (chunk && !--chunk->references) free(chunk);
+}
+
+// a version of the board's size without any chunks yet
+static struct board_version *version_create(struct board const *restrict board, uint64_t sequence) {
+  size_t rows = board_rows(board);
+  size_t cols = board_cols(board);
+  size_t chunk_rows = cols < CHUNK_CELLS ? CHUNK_CELLS / cols : 1;
+  size_t chunks_amount = (rows + chunk_rows - 1) / chunk_rows;
+
+  struct board_version *version = calloc(1, sizeof *version + chunks_amount * sizeof *version->chunks);
+  if (!version) return NULL;
+
+  version->sequence = sequence;
+  version->rows = rows;
+  version->cols = cols;
+  version->mines = board_mines(board);
+  version->revealed_cells = board->revealed_cells;
+  version->chunk_rows = chunk_rows;
+  version->chunks_amount = chunks_amount;
+  return version;
+}
+
+static void version_free(struct board_version *restrict version) {
+  for (size_t chunk = 0; chunk < version->chunks_amount; chunk++) chunk_release(version->chunks[chunk]);
+  free(version);
+}
+
+static bool copy_board(struct board_version *restrict version, struct board const *restrict board) {
+  for (size_t chunk = 0; chunk < version->chunks_amount; chunk++) {
+    struct board_chunk *copy = chunk_create(chunk_size(version, chunk));
+    if (!copy) return false;
+    version->chunks[chunk] = copy;
+
+    size_t first = chunk * version->chunk_rows;
+    size_t rows = chunk_size(version, chunk) / version->cols;
+    for (size_t row = 0; row < rows; row++) {
+      struct cell *cells = &copy->cells[row * version->cols];
+      for (size_t col = 0; col < version->cols; col++) cells[col] = visible(board_cell(board, first + row, col));
+    }
+  }
+  return true;
+}
+
+// shares the chunks of `prev` and copies those the changes from `first` on touch before applying them
+static bool apply_changes(struct board_version *restrict version,
+                          struct board_version *restrict prev,
+                          struct board_delta const *restrict delta,
+                          size_t first) {
+  for (size_t chunk = 0; chunk < version->chunks_amount; chunk++) {
+    version->chunks[chunk] = prev->chunks[chunk];
+    version->chunks[chunk]->references++;
+  }
+
+  size_t per_chunk = version->chunk_rows * version->cols;
+  for (size_t i = first; i < delta->size; i++) {
+    size_t index = delta->changes[i].index;
+    size_t chunk = index / per_chunk;
+
+    struct board_chunk *target = version->chunks[chunk];
+    if (target == prev->chunks[chunk]) {
+      struct board_chunk *copy = chunk_create(chunk_size(version, chunk));
+      if (!copy) return false;
+
+      memcpy(copy->cells, target->cells, chunk_size(version, chunk) * sizeof *copy->cells);
+      chunk_release(target);
+      version->chunks[chunk] = target = copy;
+    }
+
+    target->cells[index % per_chunk] = visible(delta->changes[i].cell);
+  }
+  return true;
+}
+
+static bool held(struct board_versions *restrict versions, struct board_version const *restrict version) {
+  for (size_t reader = 0; reader < versions->readers; reader++) {
+    if (load_version(&versions->hazards[reader]) == version) return true;
+  }
+  return false;
+}
+
+// frees the superseded versions no reader holds anymore
+static void reclaim(struct board_versions *restrict versions) {
+  struct board_version **link = &versions->retired;
+  while (*link) {
+    struct board_version *version = *link;
+    if (held(versions, version)) {
+      link = &version->retired;
+      continue;
+    }
+
+    *link = version->retired;
+    version_free(version);
+  }
+}
+
+struct board_versions *board_versions_create(size_t readers) {
+  if (readers > (SIZE_MAX - sizeof(struct board_versions)) / sizeof(struct board_version *)) return NULL;
+
+  struct board_versions *versions = calloc(1, sizeof *versions + readers * sizeof *versions->hazards);
+  if (!versions) return NULL;
+
+  versions->readers = readers;
+  return versions;
+}
+
+void board_versions_destroy(struct board_versions *restrict versions) {
+  if (!versions) return;
+
+  for (struct board_version *version = versions->retired, *next; version; version = next) {
+    next = version->retired;
+    version_free(version);
+  }
+  if (versions->latest) version_free(versions->latest);
+  free(versions);
+}
+
+bool board_publish(struct board_versions *restrict versions, struct board const *restrict board) {
+  if (!versions || !board) return false;
+
+  struct board_version *prev = versions->latest;
+  struct board_delta const *delta = board_changes(board);
+
+  // the version before this one has either seen part of the same changes, or all of those before the last clear
+  bool same = delta->epoch == versions->epoch && delta->size >= versions->changes;
+  bool next = delta->epoch == versions->epoch + 1;
+  bool follows = prev && !delta->stale && (same || next) && prev->rows == board_rows(board) &&
+                 prev->cols == board_cols(board) && prev->mines == board_mines(board);
+
+  // nothing happened since
+  if (follows && same && delta->size == versions->changes && prev->revealed_cells == board->revealed_cells) {
+    return true;
+  }
+
+  struct board_version *version = version_create(board, prev ? prev->sequence + 1 : 1);
+  if (!version) return false;
+
+  size_t first = same ? versions->changes : 0;
+  bool copied = follows ? apply_changes(version, prev, delta, first) : copy_board(version, board);
+  if (!copied) {
+    version_free(version);
+    return false;
+  }
+
+  versions->epoch = delta->epoch;
+  versions->changes = delta->size;
+  store_version(&versions->latest, version);
+  store_sequence(&versions->sequence, version->sequence);
+
+  if (prev) {
+    prev->retired = versions->retired;
+    versions->retired = prev;
+  }
+  reclaim(versions);
+  return true;
+}
+
+struct board_version const *board_version_acquire(struct board_versions *restrict versions, size_t reader) {
+  if (!versions || reader >= versions->readers) return NULL;
+
+  // retries for as long as the publisher replaces the version in between
+  for (;;) {
+    struct board_version *version = load_version(&versions->latest);
+    store_version(&versions->hazards[reader], version);
+    if (load_version(&versions->latest) == version) return version;
+  }
+}
+
+void board_version_release(struct board_versions *restrict versions, size_t reader) {
+  if (!versions || reader >= versions->readers) return;
+
+  store_version(&versions->hazards[reader], NULL);
+}
+
+uint64_t board_versions_sequence(struct board_versions *restrict versions) {
+  if (!versions) return 0;
+
+  return load_sequence(&versions->sequence);
+}
+
+struct cell board_version_cell(struct board_version const *restrict version, size_t row, size_t col) {
+  if (!version || row >= version->rows || col >= version->cols) return (struct cell){0};
+
+  struct board_chunk const *chunk = version->chunks[row / version->chunk_rows];
+  return chunk->cells[(row % version->chunk_rows) * version->cols + col];
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "board.h"
+
+/*
+  immutable versions of a board, to read it on other threads while it's being played. the thread making the moves
+  publishes a version after each of them and any amount of readers take the latest one without locking.
+
+  a version holds what a player sees (hidden cells keep their mark alone) in chunks of whole rows. a version shares
+  every chunk the moves since the last one didn't touch with it, so publishing costs the changed chunks, found through
+  the board's changes, rather than the board. when the changes are stale the whole board is copied
+*/
+struct board_version {
+  uint64_t sequence;  // the first version published is 1
+
+  size_t rows;
+  size_t cols;
+  size_t mines;
+  size_t revealed_cells;
+
+  struct board_version *retired;  // the next version waiting for its readers to let go of it
+
+  size_t chunk_rows;  // the rows a chunk holds, the last one may hold fewer
+  size_t chunks_amount;
+  struct board_chunk *chunks[];
+};
+
+struct board_versions;
+
+/* `readers` is the amount of threads that may hold a version at once, each with its own slot */
+struct board_versions *board_versions_create(size_t readers);
+
+/* releases every version. no reader may hold one anymore */
+void board_versions_destroy(struct board_versions *restrict versions);
+
+/* publishes the board as it is now. it must be called from a single thread, before the changes the board made since
+ * the last version are cleared. returns false if the version couldn't be allocated, the last one stays published */
+bool board_publish(struct board_versions *restrict versions, struct board const *restrict board);
+
+/* the latest version, or NULL if there's none yet. it stays valid until `reader` releases it or acquires another one */
+struct board_version const *board_version_acquire(struct board_versions *restrict versions, size_t reader);
+
+void board_version_release(struct board_versions *restrict versions, size_t reader);
+
+/* the sequence of the latest version. a reader tells its version is outdated when it no longer matches */
+uint64_t board_versions_sequence(struct board_versions *restrict versions);
+
+/* the cell at (row, col) as the player saw it, a blank cell if it's out of bounds */
+struct cell board_version_cell(struct board_version const *restrict version, size_t row, size_t col);
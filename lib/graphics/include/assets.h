@@ -2,17 +2,27 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include "tigr.h"
 
 /**
- * @brief represent an asset. an asset has an id and an immutable bitmap. ref_count represent the number of 'things'
- * holding the asset. do note that that number _isn't_ accurate and shouldn't be relied upon. multiple components might
- * 'borrow' an asset only to be destroyed afterwards without calling `asset_return`. this number however can be relied
- * opun if one is looking for an asset 'free' (an asset no one holds yet)
+ * @brief refers to an asset held by an assets_manager - its index. handles remain valid as long as no asset is popped or
+ * removed from the manager
+ */
+typedef uint16_t asset_handle;
+
+#define ASSET_HANDLE_NONE UINT16_MAX
+
+/**
+ * @brief represent an asset. an asset has an id and a bitmap. ref_count represent the number of 'things' holding the
+ * asset, as tracked by `am_acquire` and `am_release`. components acquire the assets pushed onto them and release them
+ * once popped, cleared or destroyed. blit_kind tells how the bitmap may be drawn (see `enum TIGRBlitKind`), it's
+ * computed once the asset is created and must be refreshed (`am_refresh`) whenever one draws onto the bitmap
  */
 struct asset {
   int id;
   unsigned ref_count;
+  unsigned char blit_kind;
   Tigr *bmp;
 };
 
@@ -26,12 +36,22 @@ struct assets_manager {
   struct asset assets[];
 };
 
+/**
+ * @brief loads the bitmap an asset is identified by. returns NULL on failure
+ */
+typedef Tigr *(*asset_loader)(char const *path);
+
 /**
  * @brief creates an assets_manage with/without assets. if `count` isn't `0` expects a list of `char const *` (paths to
  * `count` assets)
  */
 struct assets_manager *am_create(size_t count, ...);
 
+/**
+ * @brief same as `am_create` but resolves each path through `loader` rather than decoding a png from the disk
+ */
+struct assets_manager *am_create_with(asset_loader loader, size_t count, ...);
+
 /**
  * @brief destroys an asset_manager and all of its asset. this should be the _only_ way to free assets
  */
@@ -53,20 +73,48 @@ void am_pop(struct assets_manager *restrict assets_manager);
 void am_remove(struct assets_manager *restrict assets_manager, int id);
 
 /**
- * @brief returns a ptr to the desired asset or NULL. said asset must not be free'd
+ * @brief returns the handle of the first asset with the id `id` or `ASSET_HANDLE_NONE`
+ */
+asset_handle am_find(struct assets_manager const *restrict assets_manager, int id);
+
+/**
+ * @brief returns the handle of the first asset with the id `id` no one holds (its `ref_count` is 0) or
+ * `ASSET_HANDLE_NONE`
  */
-struct asset *am_get(struct assets_manager *restrict assets_manager, int id);
+asset_handle am_find_free(struct assets_manager const *restrict assets_manager, int id);
 
-struct asset *am_get_at(struct assets_manager *restrict assets_manager, unsigned index);
+/**
+ * @brief returns a ptr to the asset `handle` refers to or NULL. said asset must not be free'd
+ */
+struct asset *am_get(struct assets_manager *restrict assets_manager, asset_handle handle);
 
 /**
- * @brief returns the first asset with id `id` whos `ref_count` is 0
+ * @brief returns the bitmap of the asset `handle` refers to or NULL
  */
-struct asset *am_get_free(struct assets_manager *restrict assets_manager, int id);
+Tigr *am_bitmap(struct assets_manager const *restrict assets_manager, asset_handle handle);
 
-void am_return(struct assets_manager *restrict assets_manager, struct asset *restrict asset);
+/**
+ * @brief recomputes the `blit_kind` of the asset `handle` refers to. call after drawing onto its bitmap
+ */
+void am_refresh(struct assets_manager *restrict assets_manager, asset_handle handle);
+
+/**
+ * @brief marks the asset `handle` refers to as held by one more 'thing'
+ */
+void am_acquire(struct assets_manager *restrict assets_manager, asset_handle handle);
+
+/**
+ * @brief undoes `am_acquire`
+ */
+void am_release(struct assets_manager *restrict assets_manager, asset_handle handle);
+
+/**
+ * @brief the amount of bytes held by the assets_manager, the assets' bitmaps included
+ */
+size_t am_memory_usage(struct assets_manager const *restrict assets_manager);
 
 /**
- * @brief creates an asset. if id is -1 - the assets_manager will assign it with its own 'unique' id
+ * @brief creates an asset and classifies its bitmap. if id is -1 - the assets_manager will assign it with its own
+ * 'unique' id
  */
 struct asset asset_create(int id, Tigr *restrict bmp);
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "tigr.h"
+
+enum capture_format {
+  CAPTURE_PNG,  // `<prefix>000000.png`, `<prefix>000001.png`, ...
+  CAPTURE_RAW,  // every frame appended to `<prefix>frames.rgba`, described by a line of `<prefix>frames.index`
+};
+
+/**
+ * @brief records frames in the background. frames are copied into a ring of preallocated slots and written out by an
+ * encoder thread, so recording never waits on the disk. when the encoder falls behind and the ring fills up, new
+ * frames are dropped rather than waited for
+ */
+struct capture;
+
+/**
+ * @brief the amount of frames handed to a capture so far
+ */
+struct capture_stats {
+  size_t queued;
+  size_t dropped;  // the ring was full
+  size_t written;
+  size_t failed;  // the encoder couldn't write them
+};
+
+/**
+ * @brief starts a capture of frames up to `width` x `height` pixels, buffering up to `slots` of them. `level` is the
+ * png compression level, see `tigrSaveImageLevel`. returns NULL if the slots, the output or the encoder thread can't
+ * be created
+ */
+struct capture *capture_create(char const *restrict prefix,
+                               enum capture_format format,
+                               int level,
+                               unsigned width,
+                               unsigned height,
+                               size_t slots);
+
+/**
+ * @brief queues a copy of `bmp`. returns false if it was dropped. frames are numbered in the order they're handed in,
+ * dropped ones included, so they leave a gap in the sequence
+ */
+bool capture_frame(struct capture *restrict capture, Tigr const *restrict bmp);
+
+struct capture_stats capture_stats(struct capture *restrict capture);
+
+/**
+ * @brief writes out the frames still queued, stops the encoder and releases the capture
+ */
+void capture_destroy(struct capture *restrict capture);
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 #include "alignment.h"
 #include "assets.h"
 #include "tigr.h"
 
+// the amount of assets a component holds without allocating. 4 handles take as much room as the ptr to spilled ones
+#define COMPONENT_INLINE_ASSETS 4
+
 /**
- * @brief a 'virtual entity' which represent a graphical component. a component holds 'assets'. all assets are blit
- * together on the panel when one calls `panel_draw`
+ * @brief a 'virtual entity' which represent a graphical component. a component holds handles to assets owned by an
+ * assets_manager. all assets are blit together on the panel when one calls `panel_draw`
  */
 struct component {
   unsigned id;
@@ -16,49 +20,84 @@ struct component {
   unsigned y_offset;
   enum alignment alignment;
 
-  size_t capacity;
-  size_t size;
-  struct asset assets[];
+  bool fixed;  // constructed in place by `component_emplace`. never spills to the heap and isn't freed on its own
+
+  unsigned short capacity;
+  unsigned short size;
+  union {
+    asset_handle local[COMPONENT_INLINE_ASSETS];
+    asset_handle *heap;  // once the component outgrows `local`. see `capacity`
+  } assets;
 };
 
 /**
- * @brief creates a component. if count isn't 0 expects a list of struct asset *
+ * @brief creates a component. if count isn't 0 expects a list of `asset_handle`s, each acquired from `assets_manager`
  */
 struct component *component_create(unsigned id,
                                    unsigned x_offset,
                                    unsigned y_offset,
                                    enum alignment alignment,
+                                   struct assets_manager *restrict assets_manager,
                                    size_t count,
                                    ...);
 
 /**
- * @brief destroys a component. _doesn't_ destroy the assets a component holds
+ * @brief constructs an empty component in `component`. such a component holds at most `COMPONENT_INLINE_ASSETS` assets
+ * and must not be passed to `component_destroy` - its memory belongs to whoever provided it
  */
-void component_destroy(struct component *restrict component);
+struct component *component_emplace(struct component *restrict component,
+                                    unsigned id,
+                                    unsigned x_offset,
+                                    unsigned y_offset,
+                                    enum alignment alignment);
 
 /**
- * @brief adds an asset to a component
+ * @brief destroys a component and releases the assets it holds. _doesn't_ destroy said assets
  */
-struct component *component_push(struct component *restrict component, struct asset *restrict asset);
+void component_destroy(struct component *restrict component, struct assets_manager *restrict assets_manager);
 
 /**
- * @brief pops the last asset from the component
+ * @brief adds an asset to a component and acquires it
  */
-void component_pop(struct component *restrict component);
+struct component *component_push(struct component *restrict component,
+                                 struct assets_manager *restrict assets_manager,
+                                 asset_handle asset);
 
 /**
- * @brief removes an asset with the id `id` from a component
+ * @brief pops the last asset from the component and releases it
  */
-void component_remove(struct component *restrict component, int id);
+void component_pop(struct component *restrict component, struct assets_manager *restrict assets_manager);
 
-void component_clear(struct component *restrict component);
+/**
+ * @brief removes the asset `asset` from a component and releases it
+ */
+void component_remove(struct component *restrict component,
+                      struct assets_manager *restrict assets_manager,
+                      asset_handle asset);
+
+/**
+ * @brief releases all the assets a component holds
+ */
+void component_clear(struct component *restrict component, struct assets_manager *restrict assets_manager);
+
+/**
+ * @brief returns the handle of the `idx`th asset a component holds or `ASSET_HANDLE_NONE`
+ */
+asset_handle component_asset_at(struct component const *restrict component, size_t idx);
+
+/**
+ * @brief the amount of bytes the component occupies, including assets storage spilled to the heap
+ */
+size_t component_memory_usage(struct component const *restrict component);
 
 /**
  * @brief returns the max width of a bitmap a component holds
  */
-unsigned component_width(struct component const *restrict component);
+unsigned component_width(struct component const *restrict component,
+                         struct assets_manager const *restrict assets_manager);
 
 /**
  * @brief returns the max height of a bitmap a component holds
  */
-unsigned component_height(struct component const *restrict component);
+unsigned component_height(struct component const *restrict component,
+                          struct assets_manager const *restrict assets_manager);
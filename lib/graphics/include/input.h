@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "mouse_event.h"
+#include "tigr.h"
+
+// the amount of events a queue holds. the ones past it are left with tigr until the queue is drained
+#define INPUT_QUEUE_CAPACITY 64
+
+enum input_kind {
+  INPUT_PRESS,
+  INPUT_RELEASE,
+  INPUT_KEY_DOWN,  // repeats while the key is held, if the platform repeats keys
+  INPUT_KEY_UP,
+};
+
+/**
+ * @brief a mouse button or a key going down or up
+ */
+struct input_event {
+  enum input_kind kind;
+  struct mouse_event mouse;  // the button that went down or up and where the mouse was. `MOUSE_NONE` for keys
+  int key;                   // the `TKey` or character of key events
+  unsigned long time;        // milliseconds from an arbitrary origin. 0 if the platform doesn't report events
+};
+
+/**
+ * @brief the input of a window in the order it happened, so that presses between two frames aren't lost. where the
+ * platform doesn't report events they're made up from the input tigr polls once a frame, which catches one change
+ * per button and key a frame
+ */
+struct input_queue {
+  size_t head;
+  size_t count;
+
+  bool polled;     // the platform doesn't report events
+  int buttons;     // the buttons held as of the last made up events
+  char keys[256];  // the keys held as of the last made up events
+
+  struct input_event events[INPUT_QUEUE_CAPACITY];
+};
+
+/**
+ * @brief queues the input that happened since the last poll
+ */
+void input_poll(struct input_queue *restrict queue, Tigr *restrict window);
+
+/**
+ * @brief queues an event that didn't come from the window, say a scripted one. returns false if the queue is full
+ */
+bool input_push(struct input_queue *restrict queue, struct input_event event);
+
+/**
+ * @brief pops the oldest queued event. returns false if there are none
+ */
+bool input_next(struct input_queue *restrict queue, struct input_event *restrict event);
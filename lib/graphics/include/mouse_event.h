@@ -31,6 +31,6 @@ struct mouse_event {
 };
 
 /**
- * @brief processes _one_ mouse event. isn't capable to process multiple key presses
+ * @brief processes _one_ mouse event. isn't capable to process multiple key presses, `struct input_queue` is
  */
 struct mouse_event mouse_event_create(unsigned x, unsigned y, unsigned buttons);
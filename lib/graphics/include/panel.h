@@ -2,10 +2,25 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include "alignment.h"
+#include "arena.h"
 #include "component.h"
 #include "tigr.h"
 
+// the amount of draws a grid cell holding translucent assets counts as changed for after its assets change
+#define GRID_SETTLE_DRAWS 8
+
+/**
+ * @brief a rectangle on a panel's bitmap. empty when its width or height is 0
+ */
+struct panel_rect {
+  unsigned x;
+  unsigned y;
+  unsigned width;
+  unsigned height;
+};
+
 /**
  * @brief represents a panel. a panel is a graphical entity with its own bitmap one can draw on. the panel may hold
  * multiple components, all of which will be drawn on the panel when one calls `panel_draw.
@@ -21,6 +36,24 @@ struct panel {
 
   Tigr *bmp;
 
+  bool drawn;                // whether the panel was on its window when the window was last drawn. see `window_draw`
+  struct panel_rect damage;  // the part of `bmp` the last `panel_draw` changed
+
+  struct arena *arena;  // NULL unless created by `panel_create_grid`, in which case it holds the panel itself
+
+  // set by `panel_create_grid`, zeroed otherwise
+  struct {
+    size_t rows;
+    size_t cols;
+    unsigned cell_width;
+    unsigned cell_height;
+    struct component *cells;  // row major, `components` points into it
+    Tigr **layer;             // scratch. the bitmaps of one layer of assets across all cells, filled on every draw
+    unsigned char *kinds;     // scratch. the blit kinds of said bitmaps
+    uint64_t *signatures;     // the handles each cell held when last drawn. see `COMPONENT_INLINE_ASSETS`
+    unsigned char *settle;    // the amount of draws each cell still counts as changed for
+  } grid;
+
   size_t components_amount;
   struct component *components[];
 };
@@ -37,20 +70,37 @@ struct panel *panel_create(unsigned id,
                            size_t components,
                            ...);
 
+/**
+ * @brief creates a panel holding a `rows x cols` grid of components, each `cell_width x cell_height` and left aligned.
+ * component ids are their row major index. every component starts with `asset` (unless `ASSET_HANDLE_NONE`) and holds
+ * at most `COMPONENT_INLINE_ASSETS`. the panel and all its components are carved out of a single allocation, one can't
+ * `panel_add` to it
+ */
+struct panel *panel_create_grid(unsigned id,
+                                unsigned x_offset,
+                                unsigned y_offset,
+                                enum alignment alignment,
+                                size_t rows,
+                                size_t cols,
+                                unsigned cell_width,
+                                unsigned cell_height,
+                                struct assets_manager *restrict assets_manager,
+                                asset_handle asset);
+
 /**
  * @brief adds one or more components to a panel. expects struct component *
  */
 struct panel *panel_add(struct panel *restrict panel, size_t components, ...);
 
 /**
- * @brief destroys a panel and all of its components
+ * @brief destroys a panel and all of its components, releasing the assets they hold back to `assets_manager`
  */
-void panel_destroy(struct panel *restrict panel);
+void panel_destroy(struct panel *restrict panel, struct assets_manager *restrict assets_manager);
 
 /**
- * @brief draws all the components a panel holds
+ * @brief draws all the components a panel holds. their assets are looked up in `assets_manager`
  */
-void panel_draw(struct panel *restrict panel, float alpha);
+void panel_draw(struct panel *restrict panel, struct assets_manager const *restrict assets_manager, float alpha);
 
 /**
  * @brief clears the panel from all its assets to a color
@@ -60,6 +110,15 @@ void panel_clear(struct panel *restrict panel, TPixel color);
 /**
  * @brief returns the component occuping the coodinates (x, y). if no such component exists - returns NULL
  */
-struct component *panel_get_component(struct panel *restrict panel, unsigned x, unsigned y);
+struct component *panel_get_component(struct panel *restrict panel,
+                                      struct assets_manager const *restrict assets_manager,
+                                      unsigned x,
+                                      unsigned y);
 
 struct component *panel_component_at(struct panel *restrict panel, size_t idx);
+
+/**
+ * @brief returns the amount of bytes held by the panel (its bitmap included) excluding its components. the components'
+ * share is added onto `components_usage` if it isn't NULL
+ */
+size_t panel_memory_usage(struct panel const *restrict panel, size_t *restrict components_usage);
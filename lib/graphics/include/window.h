@@ -1,6 +1,9 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
+#include "assets.h"
+#include "capture.h"
 #include "panel.h"
 #include "tigr.h"
 
@@ -10,11 +13,23 @@
  */
 struct window {
   Tigr *window;
+  struct capture *capture;  // NULL unless recording
 
   size_t panels_amount;
   struct panel *panels[];
 };
 
+/**
+ * @brief the amount of bytes held by a window, broken down by what holds them
+ */
+struct memory_usage {
+  size_t window;      // the window itself and its bitmap
+  size_t panels;      // panels and their bitmaps
+  size_t components;  // components, including assets storage spilled to the heap
+  size_t assets;      // the assets manager and its bitmaps
+  size_t total;
+};
+
 /**
  * @brief creates a window with/without panels. if `panels` isn't 0 - expects a list of `struct panel *`
  */
@@ -36,14 +51,20 @@ struct window *window_push(struct window *restrict window, size_t panels, ...);
 struct panel *window_pop(struct window *restrict window);
 
 /**
- * @brief destroys the window and all of its panels
+ * @brief destroys the window and all of its panels, releasing the assets they hold back to `assets_manager`
+ */
+void window_destroy(struct window *restrict window, struct assets_manager *restrict assets_manager);
+
+/**
+ * @brief draws all the panels onto the window. their assets are looked up in `assets_manager`
  */
-void window_destroy(struct window *restrict window);
+void window_draw(struct window *restrict window, struct assets_manager const *restrict assets_manager, float alpha);
 
 /**
- * @brief draws all the panels onto the window
+ * @brief hands every frame `window_draw` changes anything in to `capture`, which the window takes ownership of. a
+ * NULL `capture` stops recording
  */
-void window_draw(struct window *restrict window, float alpha);
+void window_capture(struct window *restrict window, struct capture *restrict capture);
 
 /**
  * @brief clears the window to a color
@@ -60,7 +81,10 @@ struct panel *window_get_panel(struct window *restrict window, unsigned x, unsig
 /**
  * @brief get a component based on its x, y values
  */
-struct component *window_get_component(struct window *restrict window, unsigned x, unsigned y);
+struct component *window_get_component(struct window *restrict window,
+                                       struct assets_manager const *restrict assets_manager,
+                                       unsigned x,
+                                       unsigned y);
 
 /**
  * @brief get the left most x value of a panel
@@ -71,3 +95,10 @@ unsigned window_x_panel(struct window const *restrict window, struct panel const
  * @brief get the top most y value of a panel
  */
 unsigned window_y_panel(struct panel const *restrict panel);
+
+/**
+ * @brief reports the memory held by the window, its panels and their components. the assets the components refer to
+ * are owned by `assets_manager`, which may be NULL if one isn't interested in them
+ */
+struct memory_usage window_memory_usage(struct window const *restrict window,
+                                        struct assets_manager const *restrict assets_manager);
@@ -11,8 +11,8 @@ static void asset_destroy(struct asset *restrict asset) {
   tigrFree(asset->bmp);
 }
 
-struct assets_manager *am_create(size_t count, ...) {
-  if (!count) return NULL;
+static struct assets_manager *am_vcreate(asset_loader loader, size_t count, va_list args) {
+  if (!count || !loader) return NULL;
 
   size_t capacity = INIT_CAPACITY;
   if (count > capacity) { capacity = count; }
@@ -22,21 +22,37 @@ struct assets_manager *am_create(size_t count, ...) {
 
   *assets = (struct assets_manager){.capacity = capacity, .size = count};
 
-  va_list args;
-  va_start(args, count);
-
   int id = 0;
   for (size_t i = 0; i < count; i++) {
     char const *asset_path = va_arg(args, char const *);
     if (!asset_path) continue;
 
-    Tigr *bmp = tigrLoadImage(asset_path);
+    Tigr *bmp = loader(asset_path);
     if (!bmp) continue;
 
-    assets->assets[i] = (struct asset){.id = id, .ref_count = 0, .bmp = bmp};
+    assets->assets[i] = asset_create(id, bmp);
     id++;
   }
 
+  return assets;
+}
+
+struct assets_manager *am_create(size_t count, ...) {
+  va_list args;
+  va_start(args, count);
+
+  struct assets_manager *assets = am_vcreate(tigrLoadImage, count, args);
+
+  va_end(args);
+  return assets;
+}
+
+struct assets_manager *am_create_with(asset_loader loader, size_t count, ...) {
+  va_list args;
+  va_start(args, count);
+
+  struct assets_manager *assets = am_vcreate(loader, count, args);
+
   va_end(args);
   return assets;
 }
@@ -68,6 +84,9 @@ static bool resize(struct assets_manager *restrict *assets_manager) {
 struct assets_manager *am_push(struct assets_manager *restrict assets_manager, struct asset asset) {
   if (!assets_manager) goto push_end;
 
+  // every asset must be reachable through a handle
+  if (assets_manager->size >= ASSET_HANDLE_NONE) goto push_end;
+
   if (assets_manager->capacity <= assets_manager->size) {
     if (!resize(&assets_manager)) goto push_end;
   }
@@ -103,60 +122,69 @@ void am_remove(struct assets_manager *restrict assets_manager, int id) {
   }
 }
 
-struct asset *am_get(struct assets_manager *restrict assets_manager, int id) {
-  if (!assets_manager) return NULL;
+asset_handle am_find(struct assets_manager const *restrict assets_manager, int id) {
+  if (!assets_manager) return ASSET_HANDLE_NONE;
 
-  struct asset *needle = NULL;
   for (size_t i = 0; i < assets_manager->size; i++) {
-    if (assets_manager->assets[i].id == id) {
-      needle = &assets_manager->assets[i];
-      needle->ref_count++;
-      break;
-    }
+    if (assets_manager->assets[i].id == id) return (asset_handle)i;
   }
 
-  return needle;
+  return ASSET_HANDLE_NONE;
 }
 
-struct asset *am_get_at(struct assets_manager *restrict assets_manager, unsigned index) {
-  if (!assets_manager || !assets_manager->size) return NULL;
+asset_handle am_find_free(struct assets_manager const *restrict assets_manager, int id) {
+  if (!assets_manager) return ASSET_HANDLE_NONE;
 
-  if (index >= assets_manager->size) return NULL;
+  for (size_t i = 0; i < assets_manager->size; i++) {
+    if (assets_manager->assets[i].id == id && !assets_manager->assets[i].ref_count) return (asset_handle)i;
+  }
 
-  assets_manager->assets[index].ref_count++;
-  return &assets_manager->assets[index];
+  return ASSET_HANDLE_NONE;
 }
 
-struct asset *am_get_free(struct assets_manager *restrict assets_manager, int id) {
-  if (!assets_manager) return NULL;
+struct asset *am_get(struct assets_manager *restrict assets_manager, asset_handle handle) {
+  if (!assets_manager || handle >= assets_manager->size) return NULL;
 
-  struct asset *needle = NULL;
-  for (size_t i = 0; i < assets_manager->size; i++) {
-    if (assets_manager->assets[i].id == id && !assets_manager->assets[i].ref_count) {
-      needle = &assets_manager->assets[i];
-      needle->ref_count++;
-      break;
-    }
-  }
+  return &assets_manager->assets[handle];
+}
+
+Tigr *am_bitmap(struct assets_manager const *restrict assets_manager, asset_handle handle) {
+  if (!assets_manager || handle >= assets_manager->size) return NULL;
 
-  return needle;
+  return assets_manager->assets[handle].bmp;
 }
 
-void am_return(struct assets_manager *restrict assets_manager, struct asset *restrict asset) {
-  if (!assets_manager || !asset) return;
+void am_refresh(struct assets_manager *restrict assets_manager, asset_handle handle) {
+  if (!assets_manager || handle >= assets_manager->size) return;
 
-  // make sure the returned asset is actually tracked
-  struct asset *curr = NULL;
-  for (size_t i = 0; i < assets_manager->size; i++) {
-    curr = &assets_manager->assets[i];
+  struct asset *asset = &assets_manager->assets[handle];
+  if (asset->bmp) asset->blit_kind = tigrBlitKind(asset->bmp);
+}
 
-    if (curr->id == asset->id && curr->bmp == asset->bmp) {
-      if (curr->ref_count) curr->ref_count--;
-      break;
-    }
+void am_acquire(struct assets_manager *restrict assets_manager, asset_handle handle) {
+  if (!assets_manager || handle >= assets_manager->size) return;
+
+  assets_manager->assets[handle].ref_count++;
+}
+
+void am_release(struct assets_manager *restrict assets_manager, asset_handle handle) {
+  if (!assets_manager || handle >= assets_manager->size) return;
+
+  if (assets_manager->assets[handle].ref_count) assets_manager->assets[handle].ref_count--;
+}
+
+size_t am_memory_usage(struct assets_manager const *restrict assets_manager) {
+  if (!assets_manager) return 0;
+
+  size_t usage = sizeof *assets_manager + sizeof *assets_manager->assets * assets_manager->capacity;
+  for (size_t i = 0; i < assets_manager->size; i++) {
+    Tigr const *bmp = assets_manager->assets[i].bmp;
+    if (bmp) usage += sizeof *bmp + sizeof *bmp->pix * bmp->w * bmp->h;
   }
+
+  return usage;
 }
 
 struct asset asset_create(int id, Tigr *restrict bmp) {
-  return (struct asset){.id = id, .ref_count = 0, .bmp = bmp};
+  return (struct asset){.id = id, .ref_count = 0, .blit_kind = bmp ? tigrBlitKind(bmp) : TIGR_BLIT_BLEND, .bmp = bmp};
 }
@@ -0,0 +1,316 @@
+#include "capture.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// a frame waiting for the encoder
+struct slot {
+  unsigned sequence;
+  int width;
+  int height;
+  TPixel *pix;
+};
+
+struct capture {
+#ifdef _WIN32
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE wake;
+  HANDLE thread;
+#else
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_t thread;
+#endif
+
+  // set once by `capture_create`
+  char *prefix;
+  enum capture_format format;
+  int level;
+  unsigned width;
+  unsigned height;
+  TPixel *pixels;  // backs every slot
+
+  // owned by the encoder
+  FILE *raw;
+  FILE *index;
+  unsigned long long offset;
+
+  // guarded by `lock`. the queued frames are `slots[head]`, ..., `slots[head + count - 1]` (wrapping around), the rest
+  // belong to the thread handing in frames
+  size_t head;
+  size_t count;
+  bool stopping;
+  unsigned sequence;
+  struct capture_stats stats;
+
+  size_t slots_amount;
+  struct slot slots[];
+};
+
+#ifdef _WIN32
+static bool sync_init(struct capture *restrict capture) {
+  InitializeCriticalSection(&capture->lock);
+  InitializeConditionVariable(&capture->wake);
+  return true;
+}
+
+static void sync_destroy(struct capture *restrict capture) {
+  DeleteCriticalSection(&capture->lock);
+}
+
+static void sync_lock(struct capture *restrict capture) {
+  EnterCriticalSection(&capture->lock);
+}
+
+static void sync_unlock(struct capture *restrict capture) {
+  LeaveCriticalSection(&capture->lock);
+}
+
+static void sync_wait(struct capture *restrict capture) {
+  SleepConditionVariableCS(&capture->wake, &capture->lock, INFINITE);
+}
+
+static void sync_wake(struct capture *restrict capture) {
+  WakeConditionVariable(&capture->wake);
+}
+#else
+static bool sync_init(struct capture *restrict capture) {
+  if (pthread_mutex_init(&capture->lock, NULL)) return false;
+  if (pthread_cond_init(&capture->wake, NULL)) {
+    pthread_mutex_destroy(&capture->lock);
+    return false;
+  }
+
+  return true;
+}
+
+static void sync_destroy(struct capture *restrict capture) {
+  pthread_cond_destroy(&capture->wake);
+  pthread_mutex_destroy(&capture->lock);
+}
+
+static void sync_lock(struct capture *restrict capture) {
+  pthread_mutex_lock(&capture->lock);
+}
+
+static void sync_unlock(struct capture *restrict capture) {
+  pthread_mutex_unlock(&capture->lock);
+}
+
+static void sync_wait(struct capture *restrict capture) {
+  pthread_cond_wait(&capture->wake, &capture->lock);
+}
+
+static void sync_wake(struct capture *restrict capture) {
+  pthread_cond_signal(&capture->wake);
+}
+#endif
+
+static bool write_png(struct capture *restrict capture, struct slot const *restrict slot) {
+  char path[FILENAME_MAX];
+  int written = snprintf(path, sizeof path, "%s%06u.png", capture->prefix, slot->sequence);
+  if (written < 0 || (size_t)written >= sizeof path) return false;
+
+  Tigr bmp = {.w = slot->width, .h = slot->height, .cw = slot->width, .ch = slot->height, .pix = slot->pix};
+  return tigrSaveImageLevel(path, &bmp, capture->level);
+}
+
+static bool write_raw(struct capture *restrict capture, struct slot const *restrict slot) {
+  size_t pixels = (size_t)slot->width * slot->height;
+  if (fwrite(slot->pix, sizeof *slot->pix, pixels, capture->raw) != pixels) return false;
+
+  fprintf(capture->index, "%u %d %d %llu\n", slot->sequence, slot->width, slot->height, capture->offset);
+  capture->offset += pixels * sizeof *slot->pix;
+  return true;
+}
+
+// the encoder. drains the ring until it's empty and `stopping` is set
+static void encode(struct capture *restrict capture) {
+  for (;;) {
+    sync_lock(capture);
+    while (!capture->count && !capture->stopping) sync_wait(capture);
+
+    if (!capture->count) {
+      sync_unlock(capture);
+      return;
+    }
+
+    struct slot const *slot = &capture->slots[capture->head];
+    sync_unlock(capture);
+
+    bool ok = capture->format == CAPTURE_RAW ? write_raw(capture, slot) : write_png(capture, slot);
+
+    sync_lock(capture);
+    capture->head = (capture->head + 1) % capture->slots_amount;
+    capture->count--;
+    if (ok) {
+      capture->stats.written++;
+    } else {
+      capture->stats.failed++;
+    }
+    sync_unlock(capture);
+  }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI encoder(LPVOID capture) {
+  encode(capture);
+  return 0;
+}
+
+static bool start(struct capture *restrict capture) {
+  capture->thread = CreateThread(NULL, 0, encoder, capture, 0, NULL);
+  return capture->thread != NULL;
+}
+
+static void join(struct capture *restrict capture) {
+  WaitForSingleObject(capture->thread, INFINITE);
+  CloseHandle(capture->thread);
+}
+#else
+static void *encoder(void *capture) {
+  encode(capture);
+  return NULL;
+}
+
+static bool start(struct capture *restrict capture) {
+  return !pthread_create(&capture->thread, NULL, encoder, capture);
+}
+
+static void join(struct capture *restrict capture) {
+  pthread_join(capture->thread, NULL);
+}
+#endif
+
+// opens `<prefix><name>`
+static FILE *open_output(char const *restrict prefix, char const *restrict name) {
+  char path[FILENAME_MAX];
+  int written = snprintf(path, sizeof path, "%s%s", prefix, name);
+  if (written < 0 || (size_t)written >= sizeof path) return NULL;
+
+  return fopen(path, "wb");
+}
+
+struct capture *capture_create(char const *restrict prefix,
+                               enum capture_format format,
+                               int level,
+                               unsigned width,
+                               unsigned height,
+                               size_t slots) {
+  if (!prefix || !width || !height || !slots) return NULL;
+
+  size_t frame = (size_t)width * height;
+  if (frame > SIZE_MAX / sizeof(TPixel) / slots) return NULL;
+
+  struct capture *capture = calloc(1, sizeof *capture + slots * sizeof *capture->slots);
+  if (!capture) return NULL;
+
+  capture->format = format;
+  capture->level = level;
+  capture->width = width;
+  capture->height = height;
+  capture->slots_amount = slots;
+
+  capture->prefix = malloc(strlen(prefix) + 1);
+  if (!capture->prefix) goto capture_cleanup;
+  strcpy(capture->prefix, prefix);
+
+  // the slots are touched up front so the first frames don't page fault them in
+  capture->pixels = malloc(frame * slots * sizeof *capture->pixels);
+  if (!capture->pixels) goto prefix_cleanup;
+  memset(capture->pixels, 0, frame * slots * sizeof *capture->pixels);
+
+  for (size_t i = 0; i < slots; i++) {
+    capture->slots[i].pix = capture->pixels + i * frame;
+  }
+
+  if (format == CAPTURE_RAW) {
+    capture->raw = open_output(prefix, "frames.rgba");
+    capture->index = open_output(prefix, "frames.index");
+    if (!capture->raw || !capture->index) goto files_cleanup;
+
+    fprintf(capture->index, "# sequence width height offset\n");
+  }
+
+  if (!sync_init(capture)) goto files_cleanup;
+  if (!start(capture)) goto sync_cleanup;
+
+  return capture;
+
+sync_cleanup:
+  sync_destroy(capture);
+files_cleanup:
+  if (capture->raw) fclose(capture->raw);
+  if (capture->index) fclose(capture->index);
+  free(capture->pixels);
+prefix_cleanup:
+  free(capture->prefix);
+capture_cleanup:
+  free(capture);
+  return NULL;
+}
+
+bool capture_frame(struct capture *restrict capture, Tigr const *restrict bmp) {
+  if (!capture || !bmp) return false;
+
+  sync_lock(capture);
+  unsigned sequence = capture->sequence++;
+  bool full = capture->count == capture->slots_amount;
+  size_t tail = (capture->head + capture->count) % capture->slots_amount;
+  sync_unlock(capture);
+
+  bool fits = bmp->w > 0 && bmp->h > 0 && (unsigned)bmp->w <= capture->width && (unsigned)bmp->h <= capture->height;
+  if (full || !fits) {
+    sync_lock(capture);
+    capture->stats.dropped++;
+    sync_unlock(capture);
+    return false;
+  }
+
+  // the slot isn't queued yet, so the encoder won't look at it while it's filled
+  struct slot *slot = &capture->slots[tail];
+  slot->sequence = sequence;
+  slot->width = bmp->w;
+  slot->height = bmp->h;
+  memcpy(slot->pix, bmp->pix, (size_t)bmp->w * bmp->h * sizeof *bmp->pix);
+
+  sync_lock(capture);
+  capture->count++;
+  capture->stats.queued++;
+  sync_wake(capture);
+  sync_unlock(capture);
+  return true;
+}
+
+struct capture_stats capture_stats(struct capture *restrict capture) {
+  if (!capture) return (struct capture_stats){0};
+
+  sync_lock(capture);
+  struct capture_stats stats = capture->stats;
+  sync_unlock(capture);
+  return stats;
+}
+
+void capture_destroy(struct capture *restrict capture) {
+  if (!capture) return;
+
+  sync_lock(capture);
+  capture->stopping = true;
+  sync_wake(capture);
+  sync_unlock(capture);
+  join(capture);
+
+  sync_destroy(capture);
+  if (capture->raw) fclose(capture->raw);
+  if (capture->index) fclose(capture->index);
+  free(capture->pixels);
+  free(capture->prefix);
+  free(capture);
+}
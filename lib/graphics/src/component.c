@@ -1,27 +1,71 @@
 #include "component.h"
+#include <limits.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include "alignment.h"
 
-#define INIT_CAPACITY 8
 #define GROWTH_FACTOR 1
 
-struct component *component_create(unsigned id, unsigned x, unsigned y, enum alignment alignment, size_t count, ...) {
-  size_t capacity = INIT_CAPACITY;
-  if (count > capacity) capacity = count;
+static void component_init(struct component *restrict component,
+                           unsigned id,
+                           unsigned x,
+                           unsigned y,
+                           enum alignment alignment,
+                           bool fixed) {
+  *component = (struct component){.id = id,
+                                  .x_offset = x,
+                                  .y_offset = y,
+                                  .alignment = alignment,
+                                  .fixed = fixed,
+                                  .capacity = COMPONENT_INLINE_ASSETS};
+}
+
+static bool spilled(struct component const *restrict component) {
+  return component->capacity > COMPONENT_INLINE_ASSETS;
+}
+
+static asset_handle *handles(struct component *restrict component) {
+  return spilled(component) ? component->assets.heap : component->assets.local;
+}
 
-  struct component *component = malloc(sizeof *component * sizeof *component->assets * capacity);
+static asset_handle const *const_handles(struct component const *restrict component) {
+  return spilled(component) ? component->assets.heap : component->assets.local;
+}
+
+struct component *component_create(unsigned id,
+                                   unsigned x,
+                                   unsigned y,
+                                   enum alignment alignment,
+                                   struct assets_manager *restrict assets_manager,
+                                   size_t count,
+                                   ...) {
+  if (count > USHRT_MAX) return NULL;
+
+  struct component *component = malloc(sizeof *component);
   if (!component) return NULL;
 
-  *component = (struct component){.id = id, .x_offset = x, .y_offset = y, .alignment = alignment, .capacity = capacity};
+  component_init(component, id, x, y, alignment, false);
+
+  if (count > component->capacity) {
+    asset_handle *assets = malloc(sizeof *assets * count);
+    if (!assets) {
+      free(component);
+      return NULL;
+    }
+
+    component->assets.heap = assets;
+    component->capacity = count;
+  }
 
   va_list args;
   va_start(args, count);
 
+  asset_handle *assets = handles(component);
   for (size_t i = 0; i < count; i++) {
-    memcpy(&component->assets[i], va_arg(args, struct asset *), sizeof *component->assets);
+    assets[i] = (asset_handle)va_arg(args, int);  // asset_handle is promoted when passed through `...`
+    am_acquire(assets_manager, assets[i]);
   }
 
   va_end(args);
@@ -30,81 +74,132 @@ struct component *component_create(unsigned id, unsigned x, unsigned y, enum ali
   return component;
 }
 
-void component_destroy(struct component *restrict component) {
-  if (!component) return;
+struct component *component_emplace(struct component *restrict component,
+                                    unsigned id,
+                                    unsigned x,
+                                    unsigned y,
+                                    enum alignment alignment) {
+  if (!component) return NULL;
+
+  component_init(component, id, x, y, alignment, true);
+  return component;
+}
 
+void component_destroy(struct component *restrict component, struct assets_manager *restrict assets_manager) {
+  if (!component || component->fixed) return;
+
+  component_clear(component, assets_manager);
+
+  if (spilled(component)) free(component->assets.heap);
   free(component);
 }
 
-static bool resize(struct component *restrict *component) {
-  struct component *tmp = *component;
+static bool resize(struct component *restrict component) {
+  if (component->fixed) return false;  // its memory isn't ours to grow
 
-  size_t capacity = tmp->capacity << GROWTH_FACTOR;
-  if (capacity < tmp->capacity) return false;  // overflowed
+  unsigned short capacity = component->capacity << GROWTH_FACTOR;
+  if (capacity < component->capacity) return false;  // overflowed
 
-  struct component *resized = realloc(tmp, sizeof *resized + sizeof *tmp->assets * capacity);
+  asset_handle *resized = spilled(component) ? realloc(component->assets.heap, sizeof *resized * capacity)
+                                             : malloc(sizeof *resized * capacity);
   if (!resized) return false;
 
-  resized->capacity = capacity;
-  *component = resized;
+  if (!spilled(component)) memcpy(resized, component->assets.local, sizeof component->assets.local);
+
+  component->assets.heap = resized;
+  component->capacity = capacity;
   return true;
 }
 
-struct component *component_push(struct component *restrict component, struct asset *restrict asset) {
-  if (!component || !asset) goto push_end;
+struct component *component_push(struct component *restrict component,
+                                 struct assets_manager *restrict assets_manager,
+                                 asset_handle asset) {
+  if (!component || asset == ASSET_HANDLE_NONE) goto push_end;
 
   if (component->capacity <= component->size) {
-    if (!resize(&component)) goto push_end;
+    if (!resize(component)) goto push_end;
   }
 
-  component->assets[component->size] = *asset;
+  handles(component)[component->size] = asset;
   component->size++;
+  am_acquire(assets_manager, asset);
 
 push_end:
   return component;
 }
 
-void component_pop(struct component *restrict component) {
-  if (!component) return;
+void component_pop(struct component *restrict component, struct assets_manager *restrict assets_manager) {
+  if (!component || !component->size) return;
 
-  if (component->size) component->size--;
+  component->size--;
+  am_release(assets_manager, handles(component)[component->size]);
 }
 
-void component_remove(struct component *restrict component, int id) {
+void component_remove(struct component *restrict component,
+                      struct assets_manager *restrict assets_manager,
+                      asset_handle asset) {
   if (!component) return;
 
+  asset_handle *assets = handles(component);
   for (size_t i = 0; i < component->size; i++) {
-    if (component->assets[i].id == id) {
-      component->assets[i] = component->assets[component->size - 1];
+    if (assets[i] == asset) {
+      assets[i] = assets[component->size - 1];
       component->size--;
+      am_release(assets_manager, asset);
       break;
     }
   }
 }
 
-void component_clear(struct component *restrict component) {
+void component_clear(struct component *restrict component, struct assets_manager *restrict assets_manager) {
   if (!component) return;
 
+  asset_handle *assets = handles(component);
+  for (size_t i = 0; i < component->size; i++) {
+    am_release(assets_manager, assets[i]);
+  }
+
   component->size = 0;
 }
 
-unsigned component_width(struct component const *restrict component) {
-  if (!component || !component->size) return 0;
+asset_handle component_asset_at(struct component const *restrict component, size_t idx) {
+  if (!component || idx >= component->size) return ASSET_HANDLE_NONE;
+
+  return const_handles(component)[idx];
+}
+
+size_t component_memory_usage(struct component const *restrict component) {
+  if (!component) return 0;
+
+  size_t usage = sizeof *component;
+  if (spilled(component)) usage += sizeof *component->assets.heap * component->capacity;
+
+  return usage;
+}
+
+unsigned component_width(struct component const *restrict component,
+                         struct assets_manager const *restrict assets_manager) {
+  if (!component) return 0;
 
-  unsigned width = component->assets[0].bmp->w;
-  for (size_t i = 1; i < component->size; i++) {
-    if ((unsigned)component->assets[i].bmp->w > width) width = component->assets[i].bmp->w;
+  unsigned width = 0;
+  asset_handle const *assets = const_handles(component);
+  for (size_t i = 0; i < component->size; i++) {
+    Tigr *bmp = am_bitmap(assets_manager, assets[i]);
+    if (bmp && (unsigned)bmp->w > width) width = bmp->w;
   }
 
   return width;
 }
 
-unsigned component_height(struct component const *restrict component) {
-  if (!component || !component->size) return 0;
+unsigned component_height(struct component const *restrict component,
+                          struct assets_manager const *restrict assets_manager) {
+  if (!component) return 0;
 
-  unsigned height = component->assets[0].bmp->h;
-  for (size_t i = 1; i < component->size; i++) {
-    if ((unsigned)component->assets[i].bmp->h > height) height = component->assets[i].bmp->h;
+  unsigned height = 0;
+  asset_handle const *assets = const_handles(component);
+  for (size_t i = 0; i < component->size; i++) {
+    Tigr *bmp = am_bitmap(assets_manager, assets[i]);
+    if (bmp && (unsigned)bmp->h > height) height = bmp->h;
   }
 
   return height;
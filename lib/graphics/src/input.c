@@ -0,0 +1,97 @@
+#include "input.h"
+
+static bool full(struct input_queue const *restrict queue) {
+  return queue->count == INPUT_QUEUE_CAPACITY;
+}
+
+static void push(struct input_queue *restrict queue, struct input_event event) {
+  queue->events[(queue->head + queue->count) % INPUT_QUEUE_CAPACITY] = event;
+  queue->count++;
+}
+
+static struct input_event from_tigr(TigrEvent const *restrict event) {
+  switch (event->type) {
+    case TIGR_MOUSE_DOWN:
+    case TIGR_MOUSE_UP:
+      return (struct input_event){
+        .kind = event->type == TIGR_MOUSE_DOWN ? INPUT_PRESS : INPUT_RELEASE,
+        .mouse = mouse_event_create(event->x, event->y, event->button),
+        .time = event->time,
+      };
+    case TIGR_KEY_DOWN:
+    case TIGR_KEY_UP:
+    default:  // fallthrough
+      return (struct input_event){
+        .kind = event->type == TIGR_KEY_DOWN ? INPUT_KEY_DOWN : INPUT_KEY_UP,
+        .mouse = mouse_event_create(event->x, event->y, MOUSE_NONE),
+        .key = event->key,
+        .time = event->time,
+      };
+  }
+}
+
+// makes up events out of what changed since the last poll. a change is only recorded once its event is queued
+static void poll_state(struct input_queue *restrict queue, Tigr *restrict window) {
+  int x = 0;
+  int y = 0;
+  int buttons = 0;
+  tigrMouse(window, &x, &y, &buttons);
+
+  for (int button = MOUSE_LEFT; button <= MOUSE_MIDDLE && !full(queue); button <<= 1) {
+    if ((buttons & button) == (queue->buttons & button)) continue;
+
+    bool pressed = buttons & button;
+    push(queue,
+         (struct input_event){.kind = pressed ? INPUT_PRESS : INPUT_RELEASE,
+                              .mouse = mouse_event_create(x, y, button)});
+    queue->buttons ^= button;
+  }
+
+  for (int key = 1; key < (int)sizeof queue->keys && !full(queue); key++) {
+    char held = tigrKeyHeld(window, key) != 0;
+    if (held == queue->keys[key]) continue;
+
+    push(queue,
+         (struct input_event){.kind = held ? INPUT_KEY_DOWN : INPUT_KEY_UP,
+                              .mouse = mouse_event_create(x, y, MOUSE_NONE),
+                              .key = key});
+    queue->keys[key] = held;
+  }
+}
+
+void input_poll(struct input_queue *restrict queue, Tigr *restrict window) {
+  if (!queue || !window) return;
+
+  if (queue->polled) {
+    poll_state(queue, window);
+    return;
+  }
+
+  TigrEvent event;
+  while (!full(queue)) {
+    int read = tigrReadEvent(window, &event);
+    if (read < 0) {
+      queue->polled = true;
+      poll_state(queue, window);
+    }
+    if (read <= 0) return;
+
+    push(queue, from_tigr(&event));
+  }
+}
+
+bool input_push(struct input_queue *restrict queue, struct input_event event) {
+  if (!queue || full(queue)) return false;
+
+  push(queue, event);
+  return true;
+}
+
+bool input_next(struct input_queue *restrict queue, struct input_event *restrict event) {
+  if (!queue || !event || !queue->count) return false;
+
+  *event = queue->events[queue->head];
+  queue->head = (queue->head + 1) % INPUT_QUEUE_CAPACITY;
+  queue->count--;
+  return true;
+}
@@ -1,5 +1,6 @@
 #include "panel.h"
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 struct panel *panel_create(unsigned id,
@@ -39,9 +40,85 @@ struct panel *panel_create(unsigned id,
   return panel;
 }
 
+struct panel *panel_create_grid(unsigned id,
+                                unsigned x,
+                                unsigned y,
+                                enum alignment alignment,
+                                size_t rows,
+                                size_t cols,
+                                unsigned cell_width,
+                                unsigned cell_height,
+                                struct assets_manager *restrict assets_manager,
+                                asset_handle asset) {
+  if (cols && rows > SIZE_MAX / cols) return NULL;  // overflow
+  size_t amount = rows * cols;
+
+  // the panel and its components array, followed by the components themselves and the per cell draw state
+  size_t per_cell = sizeof(struct component *) + sizeof(struct component) + sizeof(Tigr *) + sizeof(unsigned char) +
+                    sizeof(uint64_t) + sizeof(unsigned char);
+  if (amount > (SIZE_MAX - sizeof(struct panel)) / per_cell) return NULL;  // overflow
+
+  struct arena *arena = arena_create(arena_footprint(sizeof(struct panel) + amount * sizeof(struct component *)) +
+                                     arena_footprint(amount * sizeof(struct component)) +
+                                     arena_footprint(amount * sizeof(Tigr *)) + arena_footprint(amount) +
+                                     arena_footprint(amount * sizeof(uint64_t)) + arena_footprint(amount));
+  if (!arena) return NULL;
+
+  struct panel *panel = arena_alloc(arena, sizeof *panel + amount * sizeof *panel->components);
+  struct component *components = arena_alloc(arena, amount * sizeof *components);
+  Tigr **layer = arena_alloc(arena, amount * sizeof *layer);
+  unsigned char *kinds = arena_alloc(arena, amount * sizeof *kinds);
+  uint64_t *signatures = arena_alloc(arena, amount * sizeof *signatures);
+  unsigned char *settle = arena_calloc(arena, amount, sizeof *settle);
+
+  // nothing was drawn yet, as if every cell was empty
+  for (size_t i = 0; i < amount; i++) {
+    signatures[i] = UINT64_MAX;
+  }
+
+  Tigr *bmp = tigrBitmap(cols * cell_width, rows * cell_height);
+  if (!bmp) {
+    arena_destroy(arena);
+    return NULL;
+  }
+
+  *panel = (struct panel){.id = id,
+                          .visible = true,
+                          .blend = true,
+                          .x_offset = x,
+                          .y_offset = y,
+                          .alignment = alignment,
+                          .bmp = bmp,
+                          .arena = arena,
+                          .grid = {.rows = rows,
+                                   .cols = cols,
+                                   .cell_width = cell_width,
+                                   .cell_height = cell_height,
+                                   .cells = components,
+                                   .layer = layer,
+                                   .kinds = kinds,
+                                   .signatures = signatures,
+                                   .settle = settle},
+                          .components_amount = amount};
+
+  for (size_t row = 0; row < rows; row++) {
+    for (size_t col = 0; col < cols; col++) {
+      size_t idx = row * cols + col;
+
+      component_emplace(&components[idx], idx, col * cell_width, row * cell_height, ALIGN_LEFT);
+      component_push(&components[idx], assets_manager, asset);
+      panel->components[idx] = &components[idx];
+    }
+  }
+
+  return panel;
+}
+
 struct panel *panel_add(struct panel *restrict panel, size_t components, ...) {
   if (!panel) return NULL;
 
+  if (panel->arena) return panel;  // the panel lives in its arena, it can't grow
+
   size_t old_components = panel->components_amount;
 
   struct panel *resized = realloc(panel, sizeof *panel + (old_components + components) * sizeof *panel->components);
@@ -59,28 +136,40 @@ struct panel *panel_add(struct panel *restrict panel, size_t components, ...) {
   return resized;
 }
 
-void panel_destroy(struct panel *restrict panel) {
+void panel_destroy(struct panel *restrict panel, struct assets_manager *restrict assets_manager) {
   if (!panel) return;
 
   if (panel->bmp) tigrFree(panel->bmp);
 
+  // the panel and all of its components go with the arena. only their assets need to be given back
+  if (panel->arena) {
+    for (size_t i = 0; i < panel->components_amount; i++) {
+      component_clear(panel->components[i], assets_manager);
+    }
+
+    arena_destroy(panel->arena);
+    return;
+  }
+
   for (size_t i = 0; i < panel->components_amount; i++) {
-    component_destroy(panel->components[i]);
+    component_destroy(panel->components[i], assets_manager);
   }
 
   free(panel);
 }
 
 // panel, component and their internal bmps must not be NULL
-static unsigned x_component(struct panel const *restrict panel, struct component const *restrict component) {
+static unsigned x_component(struct panel const *restrict panel,
+                            struct component const *restrict component,
+                            unsigned width) {
   switch (component->alignment) {
     case ALIGN_LEFT:
       return component->x_offset;
     case ALIGN_RIGHT:
-      return panel->bmp->w - (component_width(component) + component->x_offset);
+      return panel->bmp->w - (width + component->x_offset);
     case ALIGN_CENTER:
     default:  // fallthrough
-      return panel->bmp->w / 2 - (component_width(component) / 2 + component->x_offset);
+      return panel->bmp->w / 2 - (width / 2 + component->x_offset);
   }
 }
 
@@ -94,8 +183,139 @@ static unsigned y_component(struct panel const *restrict panel, struct component
   return component->y_offset;
 }
 
-void panel_draw(struct panel *restrict panel, float alpha) {
-  if (!panel || !panel->bmp) return;
+static struct asset const *asset_of(struct assets_manager const *restrict assets_manager, asset_handle handle) {
+  if (handle >= assets_manager->size) return NULL;
+
+  return &assets_manager->assets[handle];
+}
+
+// the asset on the `layer`th layer of a cell or NULL. cells are fixed components, their assets never spill out of
+// `assets.local`
+static struct asset const *cell_asset(struct component const *restrict cell,
+                                      struct assets_manager const *restrict assets_manager,
+                                      size_t layer) {
+  if (layer >= cell->size) return NULL;
+
+  return asset_of(assets_manager, cell->assets.local[layer]);
+}
+
+// whether an opaque asset covering the whole cell sits above the `layer`th layer
+static bool cell_covered(struct panel const *restrict panel,
+                         struct component const *restrict cell,
+                         struct assets_manager const *restrict assets_manager,
+                         size_t layer) {
+  for (size_t above = layer + 1; above < cell->size; above++) {
+    struct asset const *asset = cell_asset(cell, assets_manager, above);
+    if (asset && asset->blit_kind == TIGR_BLIT_COPY && (unsigned)asset->bmp->w >= panel->grid.cell_width &&
+        (unsigned)asset->bmp->h >= panel->grid.cell_height)
+      return true;
+  }
+
+  return false;
+}
+
+// the handles a cell holds, ASSET_HANDLE_NONE past its size
+static uint64_t cell_signature(struct component const *restrict cell) {
+  uint64_t signature = 0;
+  for (size_t layer = 0; layer < COMPONENT_INLINE_ASSETS; layer++) {
+    asset_handle handle = layer < cell->size ? cell->assets.local[layer] : ASSET_HANDLE_NONE;
+    signature |= (uint64_t)handle << (layer * 16);
+  }
+
+  return signature;
+}
+
+// the amount of draws a cell changes the bitmap for, once its assets changed. blending a translucent asset onto what
+// the cell held before takes a few draws to settle
+static unsigned char cell_settle(struct panel const *restrict panel,
+                                 struct component const *restrict cell,
+                                 struct assets_manager const *restrict assets_manager) {
+  for (size_t layer = 0; layer < cell->size; layer++) {
+    struct asset const *asset = cell_asset(cell, assets_manager, layer);
+    if (asset && asset->blit_kind == TIGR_BLIT_BLEND && !cell_covered(panel, cell, assets_manager, layer))
+      return GRID_SETTLE_DRAWS;
+  }
+
+  return 1;
+}
+
+static void draw_grid(struct panel *restrict panel, struct assets_manager const *restrict assets_manager, float alpha) {
+  // at full alpha an opaque asset hides whatever lies beneath it
+  bool opaque_hides = alpha >= 1.0f;
+
+  // track the cells changed by this draw
+  size_t top = SIZE_MAX, bottom = 0, left = SIZE_MAX, right = 0;
+  for (size_t i = 0; i < panel->components_amount; i++) {
+    struct component const *cell = &panel->grid.cells[i];
+
+    uint64_t signature = cell_signature(cell);
+    if (signature != panel->grid.signatures[i]) {
+      panel->grid.signatures[i] = signature;
+      panel->grid.settle[i] = cell_settle(panel, cell, assets_manager);
+    }
+
+    if (!panel->grid.settle[i]) continue;
+    panel->grid.settle[i]--;
+
+    size_t row = i / panel->grid.cols;
+    size_t col = i % panel->grid.cols;
+    if (row < top) top = row;
+    if (row > bottom) bottom = row;
+    if (col < left) left = col;
+    if (col > right) right = col;
+  }
+
+  if (!opaque_hides) {
+    // every cell blends onto its previous draw, there's no telling when it settles
+    panel->damage = (struct panel_rect){0, 0, panel->bmp->w, panel->bmp->h};
+  } else if (top == SIZE_MAX) {
+    panel->damage = (struct panel_rect){0};
+  } else {
+    panel->damage = (struct panel_rect){left * panel->grid.cell_width,
+                                        top * panel->grid.cell_height,
+                                        (right - left + 1) * panel->grid.cell_width,
+                                        (bottom - top + 1) * panel->grid.cell_height};
+  }
+
+  for (size_t layer = 0; layer < COMPONENT_INLINE_ASSETS; layer++) {
+    bool empty = true;
+
+    for (size_t i = 0; i < panel->components_amount; i++) {
+      struct component const *cell = &panel->grid.cells[i];
+      if (layer < cell->size) empty = false;
+
+      struct asset const *asset = cell_asset(cell, assets_manager, layer);
+      if (asset && opaque_hides && cell_covered(panel, cell, assets_manager, layer)) asset = NULL;
+
+      panel->grid.layer[i] = asset ? asset->bmp : NULL;
+      panel->grid.kinds[i] = asset ? asset->blit_kind : TIGR_BLIT_BLEND;
+    }
+
+    if (empty) break;
+
+    tigrBlitGrid(panel->bmp,
+                 panel->grid.layer,
+                 panel->grid.kinds,
+                 panel->grid.rows,
+                 panel->grid.cols,
+                 panel->grid.cell_width,
+                 panel->grid.cell_height,
+                 0,
+                 0,
+                 alpha);
+  }
+}
+
+void panel_draw(struct panel *restrict panel, struct assets_manager const *restrict assets_manager, float alpha) {
+  if (!panel || !panel->bmp || !assets_manager) return;
+
+  if (panel->grid.cells) {
+    draw_grid(panel, assets_manager, alpha);
+    return;
+  }
+
+  // not worth tracking, such panels are small
+  panel->damage = (struct panel_rect){0, 0, panel->bmp->w, panel->bmp->h};
 
   for (size_t i = 0; i < panel->components_amount; i++) {
     struct component *current = panel->components[i];
@@ -103,20 +323,25 @@ void panel_draw(struct panel *restrict panel, float alpha) {
     // 'empty' component
     if (!current->size) continue;
 
-    unsigned width = component_width(current);
-    unsigned height = component_height(current);
+    unsigned width = component_width(current, assets_manager);
+    unsigned height = component_height(current, assets_manager);
+    unsigned x = x_component(panel, current, width);
 
-    // blit all assets a component holds
+    // blit all assets a component holds. each is a single cell grid, so it's copied rather than blended if it can be
     for (size_t j = 0; j < current->size; j++) {
-      tigrBlitAlpha(panel->bmp,
-                    current->assets[j].bmp,
-                    x_component(panel, current),
-                    y_component(panel, current),
-                    0,
-                    0,
-                    width,
-                    height,
-                    alpha);
+      struct asset const *asset = asset_of(assets_manager, component_asset_at(current, j));
+      if (!asset || !asset->bmp) continue;
+
+      tigrBlitGrid(panel->bmp,
+                   &asset->bmp,
+                   &asset->blit_kind,
+                   1,
+                   1,
+                   width,
+                   height,
+                   x,
+                   y_component(panel, current),
+                   alpha);
     }
   }
 }
@@ -129,30 +354,56 @@ void panel_clear(struct panel *restrict panel, TPixel color) {
 
 static bool within_component_boundries(struct panel const *restrict panel,
                                        struct component const *restrict component,
+                                       struct assets_manager const *restrict assets_manager,
                                        unsigned x,
                                        unsigned y) {
   if (!panel || !panel->bmp) return false;
 
   if (!component || !component->size) return false;
 
-  unsigned width = component_width(component);
-  unsigned height = component_height(component);
+  unsigned width = component_width(component, assets_manager);
+  unsigned height = component_height(component, assets_manager);
 
-  return x >= x_component(panel, component) && x <= x_component(panel, component) + width &&
+  return x >= x_component(panel, component, width) && x <= x_component(panel, component, width) + width &&
          y >= y_component(panel, component) && y <= y_component(panel, component) + height;
 }
 
-struct component *panel_get_component(struct panel *restrict panel, unsigned x, unsigned y) {
+struct component *panel_get_component(struct panel *restrict panel,
+                                      struct assets_manager const *restrict assets_manager,
+                                      unsigned x,
+                                      unsigned y) {
   if (!panel || !panel->bmp) return NULL;
 
   for (size_t i = 0; i < panel->components_amount; i++) {
     struct component *current = panel->components[i];
 
-    if (within_component_boundries(panel, current, x, y)) { return current; }
+    if (within_component_boundries(panel, current, assets_manager, x, y)) { return current; }
   }
   return NULL;
 }
 
+size_t panel_memory_usage(struct panel const *restrict panel, size_t *restrict components_usage) {
+  if (!panel) return 0;
+
+  size_t components = 0;
+  for (size_t i = 0; i < panel->components_amount; i++) {
+    components += component_memory_usage(panel->components[i]);
+  }
+
+  size_t usage = 0;
+  if (panel->bmp) usage += sizeof *panel->bmp + sizeof *panel->bmp->pix * panel->bmp->w * panel->bmp->h;
+
+  // the components of a grid panel live in its arena. don't count them twice
+  if (panel->arena) {
+    usage += sizeof *panel->arena + panel->arena->capacity - components;
+  } else {
+    usage += sizeof *panel + sizeof *panel->components * panel->components_amount;
+  }
+
+  if (components_usage) *components_usage += components;
+  return usage;
+}
+
 struct component *panel_component_at(struct panel *restrict panel, size_t idx) {
   if (!panel) return NULL;
 
@@ -62,13 +62,14 @@ struct panel *window_pop(struct window *restrict window) {
   return NULL;
 }
 
-void window_destroy(struct window *restrict window) {
+void window_destroy(struct window *restrict window, struct assets_manager *restrict assets_manager) {
   if (!window) return;
 
+  capture_destroy(window->capture);
   if (window->window) tigrFree(window->window);
 
   for (size_t i = 0; i < window->panels_amount; i++) {
-    panel_destroy(window->panels[i]);
+    panel_destroy(window->panels[i], assets_manager);
   }
 
   free(window);
@@ -93,15 +94,54 @@ unsigned window_y_panel(struct panel const *restrict panel) {
   return panel->y_offset;
 }
 
-void window_draw(struct window *restrict window, float alpha) {
+// reports a rectangle of a panel as changed on the window, returns whether it wasn't empty
+static bool damage(struct window *restrict window, struct panel const *restrict panel, struct panel_rect rect) {
+  if (!rect.width || !rect.height) return false;
+
+  tigrDamage(window->window,
+             window_x_panel(window, panel) + rect.x,
+             window_y_panel(panel) + rect.y,
+             rect.width,
+             rect.height);
+  return true;
+}
+
+void window_capture(struct window *restrict window, struct capture *restrict capture) {
+  if (!window) return;
+
+  capture_destroy(window->capture);
+  window->capture = capture;
+}
+
+void window_draw(struct window *restrict window, struct assets_manager const *restrict assets_manager, float alpha) {
   if (!window || !window->window) return;
 
+  bool changed = false;
+
+  // a new panel might not cover what the panel it replaced did
+  for (size_t i = 0; i < window->panels_amount; i++) {
+    if (window->panels[i]->visible && !window->panels[i]->drawn) {
+      tigrDamage(window->window, 0, 0, window->window->w, window->window->h);
+      changed = true;
+      break;
+    }
+  }
+
   for (size_t i = 0; i < window->panels_amount; i++) {
     struct panel *current = window->panels[i];
+    struct panel_rect whole = {0, 0, current->bmp->w, current->bmp->h};
 
-    if (!current->visible) continue;
+    if (!current->visible) {
+      // uncover whatever lies beneath it
+      if (current->drawn) changed |= damage(window, current, whole);
 
-    panel_draw(current, alpha);
+      current->drawn = false;
+      continue;
+    }
+
+    panel_draw(current, assets_manager, alpha);
+    changed |= damage(window, current, current->damage);
+    current->drawn = true;
     if (current->blend) {
       tigrBlitAlpha(window->window,
                     current->bmp,
@@ -145,6 +185,9 @@ void window_draw(struct window *restrict window, float alpha) {
 #endif
   }
 
+  // only copies the frame, the encoder thread writes it out
+  if (changed && window->capture) capture_frame(window->capture, window->window);
+
   tigrUpdate(window->window);
 }
 
@@ -187,11 +230,32 @@ struct panel *window_get_panel(struct window *restrict window, unsigned x, unsig
   return NULL;
 }
 
-struct component *window_get_component(struct window *restrict window, unsigned x, unsigned y) {
+struct component *window_get_component(struct window *restrict window,
+                                       struct assets_manager const *restrict assets_manager,
+                                       unsigned x,
+                                       unsigned y) {
   if (!window || !window->window) return NULL;
 
   struct panel *panel = window_get_panel(window, x, y);
   if (!panel) return NULL;
 
-  return panel_get_component(panel, x - window_x_panel(window, panel), y - window_y_panel(panel));
+  return panel_get_component(panel, assets_manager, x - window_x_panel(window, panel), y - window_y_panel(panel));
+}
+
+struct memory_usage window_memory_usage(struct window const *restrict window,
+                                        struct assets_manager const *restrict assets_manager) {
+  struct memory_usage usage = {.assets = am_memory_usage(assets_manager)};
+  if (!window) return usage;
+
+  usage.window = sizeof *window + sizeof *window->panels * window->panels_amount;
+  if (window->window) {
+    usage.window += sizeof *window->window + sizeof *window->window->pix * window->window->w * window->window->h;
+  }
+
+  for (size_t i = 0; i < window->panels_amount; i++) {
+    usage.panels += panel_memory_usage(window->panels[i], &usage.components);
+  }
+
+  usage.total = usage.window + usage.panels + usage.components + usage.assets;
+  return usage;
 }
@@ -81,6 +81,7 @@ typedef struct {
   void *glContext;
 #endif
   GLuint tex[2];
+  int texW, texH;  // Size of tex[0]'s storage, 0 until allocated
   GLuint vao;
   GLuint program;
   GLuint uniform_projection;
@@ -124,6 +125,8 @@ typedef struct {
   int flags;
   int scale;
   int pos[4];
+  int damaged;    // Non-zero once tigrDamage was called on the window
+  int damage[4];  // x1, y1, x2, y2 changed since the last update, empty when x1 >= x2
   int lastChar;
   char keys[256], prev[256];
 #if defined(__ANDROID__)
@@ -145,6 +148,11 @@ typedef struct {
 } TigrInternal;
 // ----------------------------------------------------------
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TIGR_SSE2
+#include <emmintrin.h>
+#endif
+
 TigrInternal *tigrInternal(Tigr *bmp);
 
 void tigrGAPICreate(Tigr *bmp);
@@ -293,6 +301,60 @@ void tigrFree(Tigr *bmp) {
   free(bmp->pix);
   free(bmp);
 }
+
+// Offscreen windows are plain bitmaps. They're never shown or closed, and get no input.
+Tigr *tigrWindow(int w, int h, const char *title, int flags) {
+  (void)title;
+  (void)flags;
+  return tigrBitmap(w, h);
+}
+
+int tigrClosed(Tigr *bmp) {
+  (void)bmp;
+  return 0;
+}
+
+void tigrUpdate(Tigr *bmp) {
+  (void)bmp;
+}
+
+void tigrDamage(Tigr *bmp, int x, int y, int w, int h) {
+  (void)bmp;
+  (void)x;
+  (void)y;
+  (void)w;
+  (void)h;
+}
+
+void tigrMouse(Tigr *bmp, int *x, int *y, int *buttons) {
+  (void)bmp;
+  if (x) { *x = 0; }
+  if (y) { *y = 0; }
+  if (buttons) { *buttons = 0; }
+}
+
+int tigrKeyDown(Tigr *bmp, int key) {
+  (void)bmp;
+  (void)key;
+  return 0;
+}
+
+int tigrKeyHeld(Tigr *bmp, int key) {
+  (void)bmp;
+  (void)key;
+  return 0;
+}
+
+int tigrReadChar(Tigr *bmp) {
+  (void)bmp;
+  return 0;
+}
+
+int tigrReadEvent(Tigr *bmp, TigrEvent *event) {
+  (void)bmp;
+  (void)event;
+  return 0;
+}
 #endif  // TIGR_HEADLESS
 
 void tigrResize(Tigr *bmp, int w, int h) {
@@ -611,11 +673,197 @@ void tigrBlitTint(Tigr *dst, Tigr *src, int dx, int dy, int sx, int sy, int w, i
   } while (--h);
 }
 
+// Same blend as tigrBlitTint, for a source whose colour channels were already multiplied by the tint. Only the tint's
+// alpha (expanded) is left to apply. Fully transparent source pixels leave the destination untouched and are skipped.
+static void blitPretinted(Tigr *dst, Tigr *src, int dx, int dy, int sx, int sy, int w, int h, int xa) {
+  int cw = dst->cw >= 0 ? dst->cw : dst->w;
+  int ch = dst->ch >= 0 ? dst->ch : dst->h;
+
+  CLIP();
+
+  TPixel *ts = &src->pix[sy * src->w + sx];
+  TPixel *td = &dst->pix[dy * dst->w + dx];
+  int st = src->w;
+  int dt = dst->w;
+  do {
+    for (int x = 0; x < w; x++) {
+      if (!ts[x].a) continue;
+
+      unsigned r = ts[x].r;
+      unsigned g = ts[x].g;
+      unsigned b = ts[x].b;
+      unsigned a = xa * EXPAND(ts[x].a);
+      td[x].r += (unsigned char)((r - td[x].r) * a >> 16);
+      td[x].g += (unsigned char)((g - td[x].g) * a >> 16);
+      td[x].b += (unsigned char)((b - td[x].b) * a >> 16);
+      td[x].a += (dst->blitMode) * (unsigned char)((ts[x].a - td[x].a) * a >> 16);
+    }
+    ts += st;
+    td += dt;
+  } while (--h);
+}
+
 void tigrBlitAlpha(Tigr *dst, Tigr *src, int dx, int dy, int sx, int sy, int w, int h, float alpha) {
   alpha = (alpha < 0) ? 0 : (alpha > 1 ? 1 : alpha);
   tigrBlitTint(dst, src, dx, dy, sx, sy, w, h, tigrRGBA(0xff, 0xff, 0xff, (unsigned char)(alpha * 255)));
 }
 
+#ifdef TIGR_SSE2
+// Blends 2 pixels widened to 16 bits a channel, bit exact with the scalar blend: d + ((s - d) * a >> 16), where
+// a = xa * EXPAND(sa) is in [0, 65536]. a doesn't fit in 16 bits - the signed high half of the product is off by
+// (s - d) whenever a's 16th bit is set, and a == 65536 (only when xa is 256 and sa is 255) wraps around to 0.
+static __m128i blend2(__m128i d, __m128i s, __m128i xa, __m128i opaque, __m128i lanes) {
+  __m128i zero = _mm_setzero_si128();
+  __m128i sa = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xff), 0xff);
+  __m128i a = _mm_mullo_epi16(_mm_sub_epi16(sa, _mm_cmpgt_epi16(sa, zero)), xa);
+  __m128i diff = _mm_sub_epi16(s, d);
+
+  __m128i fix = _mm_or_si128(_mm_cmplt_epi16(a, zero), _mm_cmpeq_epi16(sa, opaque));
+  __m128i r = _mm_add_epi16(_mm_mulhi_epi16(diff, a), _mm_and_si128(diff, fix));
+
+  return _mm_and_si128(_mm_add_epi16(d, _mm_and_si128(r, lanes)), _mm_set1_epi16(0xff));
+}
+#endif
+
+// One scanline of tigrBlitAlpha. xa is the global alpha, expanded. A transparent source pixel blends with a weight of
+// 0, so there's no need to skip it.
+static void blendSpan(TPixel *restrict td, const TPixel *restrict ts, int w, int xa, int blitMode) {
+  int x = 0;
+
+#ifdef TIGR_SSE2
+  __m128i zero = _mm_setzero_si128();
+  __m128i vxa = _mm_set1_epi16((short)xa);
+  __m128i opaque = _mm_set1_epi16(xa == 256 ? 255 : -1);
+  __m128i lanes = blitMode ? _mm_set1_epi16(-1) : _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+
+  for (; x + 4 <= w; x += 4) {
+    __m128i s = _mm_loadu_si128((const __m128i *)&ts[x]);
+    __m128i d = _mm_loadu_si128((const __m128i *)&td[x]);
+
+    __m128i lo = blend2(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero), vxa, opaque, lanes);
+    __m128i hi = blend2(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero), vxa, opaque, lanes);
+    _mm_storeu_si128((__m128i *)&td[x], _mm_packus_epi16(lo, hi));
+  }
+#endif
+
+  for (; x < w; x++) {
+    unsigned a = xa * EXPAND(ts[x].a);
+    td[x].r += (unsigned char)((ts[x].r - td[x].r) * a >> 16);
+    td[x].g += (unsigned char)((ts[x].g - td[x].g) * a >> 16);
+    td[x].b += (unsigned char)((ts[x].b - td[x].b) * a >> 16);
+    td[x].a += blitMode * (unsigned char)((ts[x].a - td[x].a) * a >> 16);
+  }
+}
+
+// One scanline of tigrBlitAlpha at full alpha for a source whose pixels are either opaque or fully transparent: opaque
+// pixels replace the destination, transparent ones leave it be.
+static void maskSpan(TPixel *restrict td, const TPixel *restrict ts, int w) {
+  int x = 0;
+
+#ifdef TIGR_SSE2
+  __m128i alphaMask = _mm_set1_epi32((int)0xff000000);
+  __m128i zero = _mm_setzero_si128();
+
+  for (; x + 4 <= w; x += 4) {
+    __m128i s = _mm_loadu_si128((const __m128i *)&ts[x]);
+    __m128i d = _mm_loadu_si128((const __m128i *)&td[x]);
+
+    __m128i keep = _mm_cmpeq_epi32(_mm_and_si128(s, alphaMask), zero);
+    _mm_storeu_si128((__m128i *)&td[x], _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, s)));
+  }
+#endif
+
+  for (; x < w; x++) {
+    if (ts[x].a) td[x] = ts[x];
+  }
+}
+
+int tigrBlitKind(Tigr *src) {
+  int opaque = 1;
+
+  for (int i = 0; i < src->w * src->h; i++) {
+    unsigned char a = src->pix[i].a;
+    if (a != 255) {
+      if (a) return TIGR_BLIT_BLEND;
+      opaque = 0;
+    }
+  }
+
+  return opaque ? TIGR_BLIT_COPY : TIGR_BLIT_MASK;
+}
+
+void tigrBlitGrid(Tigr *dst,
+                  Tigr *const *cells,
+                  const unsigned char *kinds,
+                  int rows,
+                  int cols,
+                  int cw,
+                  int ch,
+                  int dx,
+                  int dy,
+                  float alpha) {
+  if (rows <= 0 || cols <= 0 || cw <= 0 || ch <= 0) return;
+
+  alpha = (alpha < 0) ? 0 : (alpha > 1 ? 1 : alpha);
+  int xa = EXPAND((unsigned char)(alpha * 255));
+  if (!xa) return;
+
+  // Copying and masking only match the blend when the source's alpha is taken as is, into the destination as well.
+  if (xa != 256 || dst->blitMode != TIGR_BLEND_ALPHA) kinds = NULL;
+
+  // Clip the grid as a whole, once.
+  int clipW = dst->cw >= 0 ? dst->cw : dst->w;
+  int clipH = dst->ch >= 0 ? dst->ch : dst->h;
+  int x0 = dx > dst->cx ? dx : dst->cx;
+  int y0 = dy > dst->cy ? dy : dst->cy;
+  int x1 = dx + cols * cw < dst->cx + clipW ? dx + cols * cw : dst->cx + clipW;
+  int y1 = dy + rows * ch < dst->cy + clipH ? dy + rows * ch : dst->cy + clipH;
+  if (x0 >= x1 || y0 >= y1) return;
+
+  // Only the first and last visible columns can be cut short.
+  int firstCol = (x0 - dx) / cw;
+  int lastCol = (x1 - dx - 1) / cw;
+  int firstSkip = x0 - (dx + firstCol * cw);
+  int lastWidth = x1 - (dx + lastCol * cw);
+
+  int row = (y0 - dy) / ch;
+  int sy = (y0 - dy) % ch;
+  for (int y = y0; y < y1; y++) {
+    Tigr *const *line = &cells[row * cols];
+    const unsigned char *lineKinds = kinds ? &kinds[row * cols] : NULL;
+    TPixel *td = &dst->pix[y * dst->w];
+
+    for (int col = firstCol; col <= lastCol; col++) {
+      Tigr *src = line[col];
+      if (!src || sy >= src->h) continue;
+
+      int sx = col == firstCol ? firstSkip : 0;
+      int w = col == lastCol ? lastWidth : cw;
+      if (w > src->w) w = src->w;
+      if (w <= sx) continue;
+
+      TPixel *to = td + dx + col * cw + sx;
+      const TPixel *from = &src->pix[sy * src->w + sx];
+      switch (lineKinds ? lineKinds[col] : TIGR_BLIT_BLEND) {
+        case TIGR_BLIT_COPY:
+          memcpy(to, from, (w - sx) * sizeof(TPixel));
+          break;
+        case TIGR_BLIT_MASK:
+          maskSpan(to, from, w - sx);
+          break;
+        default:
+          blendSpan(to, from, w - sx, xa, dst->blitMode);
+          break;
+      }
+    }
+
+    if (++sy == ch) {
+      sy = 0;
+      row++;
+    }
+  }
+}
+
 void tigrBlitMode(Tigr *dst, int mode) {
   dst->blitMode = mode;
 }
@@ -664,6 +912,102 @@ static int rowBytes(int w, int bipp) {
   return rowBits / 8 + ((rowBits % 8) ? 1 : 0);
 }
 
+#ifdef TIGR_SSE2
+// SSE2 unfiltering of 3 and 4 byte pixels, one pixel per step. Sub, Avg and Paeth depend on the pixel to the left, so
+// the parallelism is across the channels of a pixel.
+static __m128i load4(const unsigned char *p) {
+  int v;
+  memcpy(&v, p, 4);
+  return _mm_cvtsi32_si128(v);
+}
+
+static void store4(unsigned char *p, __m128i v) {
+  int tmp = _mm_cvtsi128_si32(v);
+  memcpy(p, &tmp, 4);
+}
+
+static __m128i load3(const unsigned char *p) {
+  int v = 0;
+  memcpy(&v, p, 3);
+  return _mm_cvtsi32_si128(v);
+}
+
+static void store3(unsigned char *p, __m128i v) {
+  int tmp = _mm_cvtsi128_si32(v);
+  memcpy(p, &tmp, 3);
+}
+
+#define LOAD(P) (bpp == 4 ? load4(P) : load3(P))
+#define STORE(P, V) (bpp == 4 ? store4(P, V) : store3(P, V))
+
+static void unfilterSubSSE2(int len, int bpp, unsigned char *raw) {
+  __m128i a = _mm_setzero_si128();
+  for (int x = 0; x < len; x += bpp) {
+    a = _mm_add_epi8(a, LOAD(raw + x));
+    STORE(raw + x, a);
+  }
+}
+
+static void unfilterUpSSE2(int len, unsigned char *raw, const unsigned char *prev) {
+  int x = 0;
+  for (; x + 16 <= len; x += 16) {
+    __m128i d = _mm_loadu_si128((const __m128i *)(raw + x));
+    _mm_storeu_si128((__m128i *)(raw + x), _mm_add_epi8(d, _mm_loadu_si128((const __m128i *)(prev + x))));
+  }
+  for (; x < len; x++)
+    raw[x] += prev[x];
+}
+
+static void unfilterAvgSSE2(int len, int bpp, unsigned char *raw, const unsigned char *prev) {
+  const __m128i one = _mm_set1_epi8(1);
+  __m128i a = _mm_setzero_si128();
+  for (int x = 0; x < len; x += bpp) {
+    __m128i b = LOAD(prev + x);
+    // _mm_avg_epu8 rounds up, PNG rounds down
+    __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+    a = _mm_add_epi8(LOAD(raw + x), avg);
+    STORE(raw + x, a);
+  }
+}
+
+static __m128i abs16(__m128i v) {
+  return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v));
+}
+
+static __m128i select16(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static void unfilterPaethSSE2(int len, int bpp, unsigned char *raw, const unsigned char *prev) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i a = zero, b = zero, c = zero, d = zero;
+  for (int x = 0; x < len; x += bpp) {
+    c = b;
+    b = _mm_unpacklo_epi8(LOAD(prev + x), zero);
+    a = d;
+    d = _mm_unpacklo_epi8(LOAD(raw + x), zero);
+
+    // p = a + b - c, so p - a = b - c, p - b = a - c and p - c = (b - c) + (a - c)
+    __m128i pa = _mm_sub_epi16(b, c);
+    __m128i pb = _mm_sub_epi16(a, c);
+    __m128i pc = abs16(_mm_add_epi16(pa, pb));
+    pa = abs16(pa);
+    pb = abs16(pb);
+
+    // ties resolve a, then b, then c
+    __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+    __m128i nearest = select16(_mm_cmpeq_epi16(smallest, pb), b, c);
+    nearest = select16(_mm_cmpeq_epi16(smallest, pa), a, nearest);
+
+    d = _mm_add_epi8(d, nearest);
+    STORE(raw + x, _mm_packus_epi16(d, d));
+  }
+}
+
+#undef LOAD
+#undef STORE
+#endif  // TIGR_SSE2
+
 static int unfilter(int w, int h, int bipp, unsigned char *raw) {
   int len = rowBytes(w, bipp);
   int bpp = rowBytes(1, bipp);
@@ -672,6 +1016,29 @@ static int unfilter(int w, int h, int bipp, unsigned char *raw) {
   memset(first, 0, len + 1);
   unsigned char *prev = first;
   for (y = 0; y < h; y++, prev = raw, raw += len) {
+#ifdef TIGR_SSE2
+    if (bpp == 3 || bpp == 4) {
+      switch (*raw++) {
+        case 0:
+          continue;
+        case 1:
+          unfilterSubSSE2(len, bpp, raw);
+          continue;
+        case 2:
+          unfilterUpSSE2(len, raw, prev);
+          continue;
+        case 3:
+          unfilterAvgSSE2(len, bpp, raw, prev);
+          continue;
+        case 4:
+          unfilterPaethSSE2(len, bpp, raw, prev);
+          continue;
+        default:
+          free(first);
+          return 0;
+      }
+    }
+#endif
 #define LOOP(A, B)          \
   for (x = 0; x < bpp; x++) \
     raw[x] += A;            \
@@ -690,6 +1057,7 @@ static int unfilter(int w, int h, int bipp, unsigned char *raw) {
       case 4:
         LOOP(prev[x], paeth(raw[x - bpp], prev[x], prev[x - bpp]));
       default:
+        free(first);
         return 0;
     }
 #undef LOOP
@@ -700,6 +1068,15 @@ static int unfilter(int w, int h, int bipp, unsigned char *raw) {
 
 static void convert(int bypp, int w, int h, const unsigned char *src, TPixel *dest, const unsigned char *trns) {
   int x, y;
+
+  // RGBA rows already match TPixel's layout, only the filter bytes need squeezing out. Rows may overlap.
+  if (bypp == 4) {
+    for (y = 0; y < h; y++, src += w * 4 + 1, dest += w) {
+      memmove(dest, src + 1, w * 4);
+    }
+    return;
+  }
+
   for (y = 0; y < h; y++) {
     src++;  // skip filter byte
     for (x = 0; x < w; x++, src += bypp) {
@@ -912,204 +1289,495 @@ Tigr *tigrLoadImage(const char *fileName) {
 
 // #include "tigr_internal.h"
 #include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 typedef struct {
-  unsigned crc, adler, bits, prev, runlen;
-  FILE *out;
-  unsigned crcTable[256];
+  unsigned char *out;  // the whole file, sized up front for the worst case
+  size_t size;
+  uint64_t bits;  // pending bits, lowest first
+  unsigned count;
 } Save;
 
-static const unsigned crctable[16] = {0,
-                                      0x1db71064,
-                                      0x3b6e20c8,
-                                      0x26d930ac,
-                                      0x76dc4190,
-                                      0x6b6b51f4,
-                                      0x4db26158,
-                                      0x5005713c,
-                                      0xedb88320,
-                                      0xf00f9344,
-                                      0xd6d6a3e8,
-                                      0xcb61b38c,
-                                      0x9b64c2b0,
-                                      0x86d3d2d4,
-                                      0xa00ae278,
-                                      0xbdbdf21c};
+// Compression levels: how many candidates a match search walks and how long a match may be for every position in it
+// to be hashed. Level 0 stores the data as is.
+typedef struct {
+  int chain;
+  int insert;
+} SaveLevel;
+
+static const SaveLevel saveLevels[10] = {{0, 0},
+                                         {1, 0},
+                                         {2, 0},
+                                         {4, 0},
+                                         {8, 8},
+                                         {16, 16},
+                                         {32, 32},
+                                         {64, 64},
+                                         {128, 128},
+                                         {256, 258}};
+
+#define SAVE_WINDOW 32768
+#define SAVE_HASH_BITS 15
+#define SAVE_MIN_MATCH 4
+#define SAVE_MAX_MATCH 258
+#define SAVE_STORED_MAX 65535
+
+// Codes of the fixed Huffman tables, bit reversed (deflate sends codes high bit first), with their extra bits appended.
+typedef struct {
+  unsigned lit[286];
+  unsigned char litBits[286];
+  unsigned len[SAVE_MAX_MATCH + 1];  // length code and extra bits of every match length
+  unsigned char lenBits[SAVE_MAX_MATCH + 1];
+  unsigned char distCode[512];  // distance code of (d - 1) < 256, or of 256 + ((d - 1) >> 7)
+  unsigned char dist[30];       // the codes themselves
+} SaveTables;
+
+static const unsigned short saveLenBase[29] = {3,  4,  5,  6,  7,  8,  9,  10,  11,  13,  15,  17,  19,  23, 27,
+                                               31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const unsigned char saveLenExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                               2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const unsigned short saveDistBase[30] = {1,    2,    3,    4,    5,    7,    9,    13,    17,    25,
+                                                33,   49,   65,   97,   129,  193,  257,  385,   513,   769,
+                                                1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const unsigned char saveDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3,  3,  4,  4,  5,  5,  6,
+                                                6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static unsigned reverseBits(unsigned code, unsigned bits) {
+  unsigned out = 0;
+  while (bits--) {
+    out = (out << 1) | (code & 1);
+    code >>= 1;
+  }
+  return out;
+}
+
+// Everything an encode works with besides the rows and the output. Every call allocates its own, so encodes may run
+// on several threads at once.
+typedef struct {
+  SaveTables tables;
+  uint32_t crc[8][256];  // see crc32
+  int32_t head[1 << SAVE_HASH_BITS];
+  int32_t prev[SAVE_WINDOW];
+} SaveState;
+
+static void buildSaveTables(SaveTables *t) {
+  for (unsigned v = 0; v < 286; v++) {
+    if (v < 144) {
+      t->lit[v] = reverseBits(0x030 + v, 8), t->litBits[v] = 8;
+    } else if (v < 256) {
+      t->lit[v] = reverseBits(0x190 + v - 144, 9), t->litBits[v] = 9;
+    } else if (v < 280) {
+      t->lit[v] = reverseBits(v - 256, 7), t->litBits[v] = 7;
+    } else {
+      t->lit[v] = reverseBits(0x0c0 + v - 280, 8), t->litBits[v] = 8;
+    }
+  }
 
-static void put(Save *s, unsigned v) {
-  fputc(v, s->out);
-  s->crc = (s->crc >> 4) ^ crctable[(s->crc & 15) ^ (v & 15)];
-  s->crc = (s->crc >> 4) ^ crctable[(s->crc & 15) ^ (v >> 4)];
+  for (unsigned code = 0; code < 29; code++) {
+    unsigned last = code + 1 < 29 ? saveLenBase[code + 1] : SAVE_MAX_MATCH + 1;
+    // 258 has a code of its own rather than being 227 + 31
+    if (code == 27) last = SAVE_MAX_MATCH;
+    for (unsigned len = saveLenBase[code]; len < last; len++) {
+      unsigned sym = 257 + code;
+      t->len[len] = t->lit[sym] | (len - saveLenBase[code]) << t->litBits[sym];
+      t->lenBits[len] = t->litBits[sym] + saveLenExtra[code];
+    }
+  }
+
+  for (unsigned code = 0; code < 30; code++) {
+    t->dist[code] = reverseBits(code, 5);
+
+    unsigned first = saveDistBase[code] - 1;
+    unsigned last = first + (1u << saveDistExtra[code]);
+    for (unsigned d = first; d < last; d++) {
+      if (d < 256)
+        t->distCode[d] = code;
+      else
+        t->distCode[256 + (d >> 7)] = code;
+    }
+  }
 }
 
-static void updateAdler(Save *s, unsigned v) {
-  unsigned s1 = s->adler & 0xffff, s2 = (s->adler >> 16) & 0xffff;
-  s1 = (s1 + v) % 65521;
-  s2 = (s2 + s1) % 65521;
-  s->adler = (s2 << 16) + s1;
+static void putbits(Save *s, unsigned data, unsigned bitcount) {
+  s->bits |= (uint64_t)data << s->count;
+  s->count += bitcount;
+  if (s->count >= 32) {
+    s->out[s->size++] = s->bits & 0xff;
+    s->out[s->size++] = (s->bits >> 8) & 0xff;
+    s->out[s->size++] = (s->bits >> 16) & 0xff;
+    s->out[s->size++] = (s->bits >> 24) & 0xff;
+    s->bits >>= 32;
+    s->count -= 32;
+  }
+}
+
+// Pads the bits to a whole byte and writes them out.
+static void flushbits(Save *s) {
+  while (s->count > 0) {
+    s->out[s->size++] = s->bits & 0xff;
+    s->bits >>= 8;
+    s->count = s->count > 8 ? s->count - 8 : 0;
+  }
+  s->bits = 0;
+}
+
+static void put(Save *s, unsigned v) {
+  s->out[s->size++] = v & 0xff;
 }
 
 static void put32(Save *s, unsigned v) {
-  put(s, (v >> 24) & 0xff);
-  put(s, (v >> 16) & 0xff);
-  put(s, (v >> 8) & 0xff);
-  put(s, v & 0xff);
-}
-
-void putbits(Save *s, unsigned data, unsigned bitcount) {
-  while (bitcount--) {
-    unsigned prev = s->bits;
-    s->bits = (s->bits >> 1) | ((data & 1) << 7);
-    data >>= 1;
-    if (prev & 1) {
-      put(s, s->bits);
-      s->bits = 0x80;
+  put(s, v >> 24);
+  put(s, v >> 16);
+  put(s, v >> 8);
+  put(s, v);
+}
+
+// CRC-32, eight bytes at a time through eight tables (slice-by-8).
+static void buildCrcTables(uint32_t crcTables[8][256]) {
+  for (unsigned n = 0; n < 256; n++) {
+    uint32_t c = n;
+    for (int k = 0; k < 8; k++)
+      c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+    crcTables[0][n] = c;
+  }
+  for (unsigned n = 0; n < 256; n++) {
+    for (int t = 1; t < 8; t++)
+      crcTables[t][n] = (crcTables[t - 1][n] >> 8) ^ crcTables[0][crcTables[t - 1][n] & 0xff];
+  }
+}
+
+static uint32_t crc32(const SaveState *state, const unsigned char *p, size_t n) {
+  const uint32_t(*crcTables)[256] = state->crc;
+  uint32_t c = 0xffffffffu;
+
+  while (n >= 8) {
+    uint32_t lo = c ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+    uint32_t hi = (uint32_t)p[4] | (uint32_t)p[5] << 8 | (uint32_t)p[6] << 16 | (uint32_t)p[7] << 24;
+    c = crcTables[7][lo & 0xff] ^ crcTables[6][(lo >> 8) & 0xff] ^ crcTables[5][(lo >> 16) & 0xff] ^
+        crcTables[4][lo >> 24] ^ crcTables[3][hi & 0xff] ^ crcTables[2][(hi >> 8) & 0xff] ^
+        crcTables[1][(hi >> 16) & 0xff] ^ crcTables[0][hi >> 24];
+    p += 8;
+    n -= 8;
+  }
+  while (n--)
+    c = crcTables[0][(c ^ *p++) & 0xff] ^ (c >> 8);
+  return ~c;
+}
+
+// Adler-32. The sums are reduced once every ADLER_NMAX bytes, the most that can't overflow 32 bits.
+#define ADLER_MOD 65521
+#define ADLER_NMAX 5552
+
+static uint32_t adler32(const unsigned char *p, size_t n) {
+  uint32_t s1 = 1, s2 = 0;
+
+  while (n) {
+    size_t block = n < ADLER_NMAX ? n : ADLER_NMAX;
+    n -= block;
+
+#ifdef TIGR_SSE2
+    // 16 bytes a step: s1 gains their sum, s2 gains 16 * s1 plus the bytes weighted 16 down to 1.
+    if (block >= 16) {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i weightsHi = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+      const __m128i weightsLo = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+      __m128i vs1 = _mm_setzero_si128(), vs2 = _mm_setzero_si128(), vps = _mm_setzero_si128();
+      size_t steps = block / 16;
+      block -= steps * 16;
+      s2 += s1 * (uint32_t)(steps * 16);
+
+      while (steps--) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)p);
+        vps = _mm_add_epi32(vps, vs1);
+        vs1 = _mm_add_epi32(vs1, _mm_sad_epu8(bytes, zero));
+        vs2 = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_unpacklo_epi8(bytes, zero), weightsHi));
+        vs2 = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_unpackhi_epi8(bytes, zero), weightsLo));
+        p += 16;
+      }
+
+      uint32_t lanes[4];
+      _mm_storeu_si128((__m128i *)lanes, vs1);
+      uint32_t sum = lanes[0] + lanes[2];
+      _mm_storeu_si128((__m128i *)lanes, vps);
+      uint32_t prefix = lanes[0] + lanes[2];
+      _mm_storeu_si128((__m128i *)lanes, vs2);
+      s2 += (prefix << 4) + lanes[0] + lanes[1] + lanes[2] + lanes[3];
+      s1 += sum;
     }
+#endif
+
+    while (block >= 8) {
+      s1 += p[0], s2 += s1;
+      s1 += p[1], s2 += s1;
+      s1 += p[2], s2 += s1;
+      s1 += p[3], s2 += s1;
+      s1 += p[4], s2 += s1;
+      s1 += p[5], s2 += s1;
+      s1 += p[6], s2 += s1;
+      s1 += p[7], s2 += s1;
+      p += 8;
+      block -= 8;
+    }
+    while (block--) {
+      s1 += *p++;
+      s2 += s1;
+    }
+
+    s1 %= ADLER_MOD;
+    s2 %= ADLER_MOD;
+  }
+
+  return (s2 << 16) | s1;
+}
+
+// The rows of the image, each prefixed by the Sub filter type and holding the difference with the pixel to its left.
+static void filterRows(Tigr *bmp, unsigned char *out) {
+  size_t stride = (size_t)bmp->w * 4 + 1;
+
+  for (int y = 0; y < bmp->h; y++) {
+    const unsigned char *row = (const unsigned char *)&bmp->pix[y * bmp->w];
+    unsigned char *dst = out + y * stride;
+    size_t n = (size_t)bmp->w * 4;
+    size_t x = 4;
+
+    *dst++ = 1;  // sub filter
+    if (n) memcpy(dst, row, 4);
+#ifdef TIGR_SSE2
+    for (; x + 16 <= n; x += 16) {
+      __m128i curr = _mm_loadu_si128((const __m128i *)(row + x));
+      __m128i left = _mm_loadu_si128((const __m128i *)(row + x - 4));
+      _mm_storeu_si128((__m128i *)(dst + x), _mm_sub_epi8(curr, left));
+    }
+#endif
+    for (; x < n; x++)
+      dst[x] = row[x] - row[x - 4];
   }
 }
 
-void putbitsr(Save *s, unsigned data, unsigned bitcount) {
-  while (bitcount--)
-    putbits(s, data >> bitcount, 1);
+static uint32_t load32(const unsigned char *p) {
+  uint32_t v;
+  memcpy(&v, p, 4);
+  return v;
 }
 
-static void begin(Save *s, const char *id, unsigned len) {
-  put32(s, len);
-  s->crc = 0xffffffff;
-  put(s, id[0]);
-  put(s, id[1]);
-  put(s, id[2]);
-  put(s, id[3]);
-}
-
-static void literal(Save *s, unsigned v) {
-  // Encode a literal/length using the built-in tables.
-  // Could do better with a custom table but whatever.
-  if (v < 144)
-    putbitsr(s, 0x030 + v - 0, 8);
-  else if (v < 256)
-    putbitsr(s, 0x190 + v - 144, 9);
-  else if (v < 280)
-    putbitsr(s, 0x000 + v - 256, 7);
-  else
-    putbitsr(s, 0x0c0 + v - 280, 8);
+static unsigned hash4(const unsigned char *p) {
+  return (load32(p) * 2654435761u) >> (32 - SAVE_HASH_BITS);
 }
 
-static void encodelen(Save *s, unsigned code, unsigned bits, unsigned len) {
-  literal(s, code + (len >> bits));
-  putbits(s, len, bits);
-  putbits(s, 0, 5);
+// The amount of leading bytes a and b share, up to max.
+static int matchLength(const unsigned char *a, const unsigned char *b, int max) {
+  int len = 0;
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (len + 8 <= max) {
+    uint64_t x, y;
+    memcpy(&x, a + len, 8);
+    memcpy(&y, b + len, 8);
+    if (x != y) return len + (__builtin_ctzll(x ^ y) >> 3);
+    len += 8;
+  }
+#endif
+  while (len < max && a[len] == b[len])
+    len++;
+  return len;
 }
 
-static void endrun(Save *s) {
-  s->runlen--;
-  literal(s, s->prev);
+static void encodeMatch(Save *s, const SaveTables *t, int len, int dist) {
+  unsigned d = dist - 1;
+  unsigned code = t->distCode[d < 256 ? d : 256 + (d >> 7)];
 
-  if (s->runlen >= 67)
-    encodelen(s, 277, 4, s->runlen - 67);
-  else if (s->runlen >= 35)
-    encodelen(s, 273, 3, s->runlen - 35);
-  else if (s->runlen >= 19)
-    encodelen(s, 269, 2, s->runlen - 19);
-  else if (s->runlen >= 11)
-    encodelen(s, 265, 1, s->runlen - 11);
-  else if (s->runlen >= 3)
-    encodelen(s, 257, 0, s->runlen - 3);
-  else
-    while (s->runlen--)
-      literal(s, s->prev);
+  putbits(s, t->len[len], t->lenBits[len]);
+  putbits(s, t->dist[code] | (d - (saveDistBase[code] - 1)) << 5, 5 + saveDistExtra[code]);
 }
 
-static void encodeByte(Save *s, unsigned char v) {
-  updateAdler(s, v);
+// A single block of fixed Huffman codes. Matches are found greedily through hash chains of 4 byte prefixes.
+static void deflateFixed(Save *out, SaveState *state, const unsigned char *in, size_t n, const SaveLevel *level) {
+  const SaveTables *t = &state->tables;
+  int32_t *head = state->head;
+  int32_t *prev = state->prev;
 
-  // Simple RLE compression. We could do better by doing a search
-  // to find matches, but this works pretty well TBH.
-  if (s->prev == v && s->runlen < 115) {
-    s->runlen++;
-  } else {
-    if (s->runlen) endrun(s);
+  // a local copy the compiler can keep in registers, the output bytes would alias it otherwise
+  Save local = *out;
+  Save *s = &local;
+
+  memset(head, 0xff, sizeof state->head);
+
+  putbits(s, 3, 3);  // last block + fixed dictionary
 
-    s->prev = v;
-    s->runlen = 1;
+  size_t pos = 0;
+  while (pos < n) {
+    int best = 0, bestDist = 0;
+
+    if (pos + SAVE_MIN_MATCH <= n) {
+      unsigned h = hash4(in + pos);
+      int32_t cand = head[h];
+      int max = n - pos < SAVE_MAX_MATCH ? (int)(n - pos) : SAVE_MAX_MATCH;
+
+      for (int chain = level->chain; cand >= 0 && pos - cand <= SAVE_WINDOW && chain--;
+           cand = prev[cand & (SAVE_WINDOW - 1)]) {
+        if (in[cand + best] != in[pos + best]) continue;
+
+        int len = matchLength(in + cand, in + pos, max);
+        if (len > best) {
+          best = len;
+          bestDist = (int)(pos - cand);
+          if (len == max) break;
+        }
+      }
+
+      prev[pos & (SAVE_WINDOW - 1)] = head[h];
+      head[h] = (int32_t)pos;
+    }
+
+    if (best < SAVE_MIN_MATCH) {
+      putbits(s, t->lit[in[pos]], t->litBits[in[pos]]);
+      pos++;
+      continue;
+    }
+
+    encodeMatch(s, t, best, bestDist);
+
+    // Hash the positions within short matches, long ones are runs not worth the time.
+    size_t end = pos + best;
+    if (best <= level->insert) {
+      for (pos++; pos < end && pos + SAVE_MIN_MATCH <= n; pos++) {
+        unsigned h = hash4(in + pos);
+        prev[pos & (SAVE_WINDOW - 1)] = head[h];
+        head[h] = (int32_t)pos;
+      }
+    }
+    pos = end;
   }
+
+  putbits(s, t->lit[256], t->litBits[256]);  // terminator
+  flushbits(s);
+  *out = local;
 }
 
-static void savePngHeader(Save *s, Tigr *bmp) {
-  fwrite("\211PNG\r\n\032\n", 8, 1, s->out);
-  begin(s, "IHDR", 13);
-  put32(s, bmp->w);
-  put32(s, bmp->h);
-  put(s, 8);  // bit depth
-  put(s, 6);  // RGBA
-  put(s, 0);  // compression (deflate)
-  put(s, 0);  // filter (standard)
-  put(s, 0);  // interlace off
-  put32(s, ~s->crc);
+static void deflateStored(Save *s, const unsigned char *in, size_t n) {
+  do {
+    size_t len = n < SAVE_STORED_MAX ? n : SAVE_STORED_MAX;
+    n -= len;
+
+    putbits(s, n == 0, 3);  // last block? + stored
+    flushbits(s);
+    put(s, len);
+    put(s, len >> 8);
+    put(s, ~len);
+    put(s, ~len >> 8);
+    memcpy(s->out + s->size, in, len);
+    s->size += len;
+    in += len;
+  } while (n);
+}
+
+static void beginChunk(Save *s, const char *id, unsigned len) {
+  put32(s, len);
+  memcpy(s->out + s->size, id, 4);
+  s->size += 4;
 }
 
-static long savePngData(Save *s, Tigr *bmp, long dataPos) {
-  int x, y;
-  long dataSize;
-  begin(s, "IDAT", 0);
-  put(s, 0x08);      // zlib compression method
-  put(s, 0x1d);      // zlib compression flags
-  putbits(s, 3, 3);  // zlib last block + fixed dictionary
-  for (y = 0; y < bmp->h; y++) {
-    TPixel *row = &bmp->pix[y * bmp->w];
-    TPixel prev = tigrRGBA(0, 0, 0, 0);
-
-    encodeByte(s, 1);  // sub filter
-    for (x = 0; x < bmp->w; x++) {
-      encodeByte(s, row[x].r - prev.r);
-      encodeByte(s, row[x].g - prev.g);
-      encodeByte(s, row[x].b - prev.b);
-      encodeByte(s, row[x].a - prev.a);
-      prev = row[x];
-    }
-  }
-  endrun(s);
-  literal(s, 256);  // terminator
-  while (s->bits != 0x80)
-    putbits(s, 0, 1);
-  put32(s, s->adler);
-  dataSize = (ftell(s->out) - dataPos) - 8;
-  put32(s, ~s->crc);
-  return dataSize;
+// The CRC covers the chunk's type and data, which start at `start`.
+static void endChunk(Save *s, const SaveState *state, size_t start) {
+  put32(s, crc32(state, s->out + start, s->size - start));
 }
 
-int tigrSaveImage(const char *fileName, Tigr *bmp) {
-  Save s;
-  long dataPos, dataSize, err;
+void *tigrEncodeImage(Tigr *bmp, int level, int *size) {
+  if (!bmp || !size || bmp->w <= 0 || bmp->h <= 0) return NULL;
+  if (level < 0) level = 0;
+  if (level > 9) level = 9;
 
-  // TODO - unicode?
-  FILE *out = fopen(fileName, "wb");
-  if (!out) return 1;
+  size_t raw = ((size_t)bmp->w * 4 + 1) * bmp->h;
+  // fixed codes take at most 9 bits a byte, stored blocks 5 bytes a block
+  size_t bound = raw + raw / 8 + (raw / SAVE_STORED_MAX + 1) * 5 + 128;
+  if (bound > 0x7fffffff) return NULL;
 
-  s.out = out;
-  s.adler = 1;
-  s.bits = 0x80;
-  s.prev = 0xffff;
-  s.runlen = 0;
+  SaveState *state = (SaveState *)malloc(sizeof(SaveState));
+  unsigned char *filtered = (unsigned char *)malloc(raw);
+  Save s = {(unsigned char *)malloc(bound), 0, 0, 0};
+  if (!state || !filtered || !s.out) {
+    free(state);
+    free(filtered);
+    free(s.out);
+    return NULL;
+  }
 
-  savePngHeader(&s, bmp);
-  dataPos = ftell(s.out);
-  dataSize = savePngData(&s, bmp, dataPos);
+  buildSaveTables(&state->tables);
+  buildCrcTables(state->crc);
+  filterRows(bmp, filtered);
+
+  memcpy(s.out, "\211PNG\r\n\032\n", 8);
+  s.size = 8;
+
+  size_t start = s.size + 4;
+  beginChunk(&s, "IHDR", 13);
+  put32(&s, bmp->w);
+  put32(&s, bmp->h);
+  put(&s, 8);  // bit depth
+  put(&s, 6);  // RGBA
+  put(&s, 0);  // compression (deflate)
+  put(&s, 0);  // filter (standard)
+  put(&s, 0);  // interlace off
+  endChunk(&s, state, start);
+
+  size_t lenPos = s.size;
+  start = s.size + 4;
+  beginChunk(&s, "IDAT", 0);
+  put(&s, 0x78);  // zlib, 32k window
+  put(&s, 0x01);  // no dictionary, fastest compression
+  size_t body = s.size;
+  if (level > 0) {
+    deflateFixed(&s, state, filtered, raw, &saveLevels[level]);
+    // Noise grows under fixed codes; store it instead.
+    if (s.size - body > raw + (raw / SAVE_STORED_MAX + 1) * 5) level = 0;
+  }
+  if (level == 0) {
+    s.size = body;
+    s.bits = 0;
+    s.count = 0;
+    deflateStored(&s, filtered, raw);
+  }
+  put32(&s, adler32(filtered, raw));
+
+  // Write back the payload size.
+  size_t end = s.size;
+  s.size = lenPos;
+  put32(&s, (unsigned)(end - start - 4));
+  s.size = end;
+  endChunk(&s, state, start);
+
+  start = s.size + 4;
+  beginChunk(&s, "IEND", 0);
+  endChunk(&s, state, start);
+
+  free(state);
+  free(filtered);
+  *size = (int)s.size;
+  return s.out;
+}
+
+int tigrSaveImageLevel(const char *fileName, Tigr *bmp, int level) {
+  int size = 0;
+  void *png = tigrEncodeImage(bmp, level, &size);
+  if (!png) return 0;
 
-  // End chunk.
-  begin(&s, "IEND", 0);
-  put32(&s, ~s.crc);
+  // TODO - unicode?
+  FILE *out = fopen(fileName, "wb");
+  if (!out) {
+    free(png);
+    return 0;
+  }
 
-  // Write back payload size.
-  fseek(out, dataPos, SEEK_SET);
-  put32(&s, dataSize);
+  int written = fwrite(png, size, 1, out) == 1;
+  int err = ferror(out);
+  free(png);
+  return !fclose(out) && written && !err;
+}
 
-  err = ferror(out);
-  fclose(out);
-  return !err;
+int tigrSaveImage(const char *fileName, Tigr *bmp) {
+  return tigrSaveImageLevel(fileName, bmp, TIGR_PNG_DEFAULT_LEVEL);
 }
 
 //////// End of inlined file: tigr_savepng.c ////////
@@ -1118,15 +1786,30 @@ int tigrSaveImage(const char *fileName, Tigr *bmp) {
 
 // #include "tigr_internal.h"
 #include <setjmp.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+// Codes up to FAST_BITS long are decoded with a single table lookup.
+#define FAST_BITS 9
+#define FAST_MASK ((1 << FAST_BITS) - 1)
+
+typedef struct {
+  unsigned short fast[1 << FAST_BITS];  // (len << 9) | symbol, 0 if the code is longer than FAST_BITS
+  unsigned short firstcode[16];
+  int maxcode[17];
+  unsigned short firstsymbol[16];
+  unsigned char size[288];
+  unsigned short value[288];
+} Huffman;
 
 typedef struct {
-  unsigned bits, count;
+  uint64_t bits;
+  unsigned count, overrun;
   const unsigned char *in, *inend;
-  unsigned char *out, *outend;
+  unsigned char *out, *outstart, *outend;
   jmp_buf jmp;
-  unsigned litcodes[288], distcodes[32], lencodes[19];
-  int tlit, tdist, tlen;
+  Huffman lit, dist, len;
 } State;
 
 #define FAIL() longjmp(s->jmp, 1)
@@ -1158,87 +1841,132 @@ static unsigned rev16(unsigned n) {
   return (reverseTable[n & 0xff] << 8) | reverseTable[(n >> 8) & 0xff];
 }
 
-static int bits(State *s, int n) {
-  int v = s->bits & ((1 << n) - 1);
-  s->bits >>= n;
-  s->count -= n;
-  while (s->count < 16) {
-    CHECK(s->in != s->inend);
-    s->bits |= (*s->in++) << s->count;
+static uint64_t load64(const unsigned char *p) {
+  return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24 | (uint64_t)p[4] << 32 |
+         (uint64_t)p[5] << 40 | (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+// Tops the bit buffer up to at least 56 bits. Reads 64 bits at a time while the input allows it; past the end of the
+// input zeros are shifted in and accounted for in 'overrun'.
+static void refill(State *s) {
+  if (s->inend - s->in >= 8) {
+    unsigned take = (63 - s->count) >> 3;
+    s->bits |= load64(s->in) << s->count;
+    s->in += take;
+    s->count += take * 8;
+    return;
+  }
+
+  while (s->count <= 56) {
+    if (s->in < s->inend)
+      s->bits |= (uint64_t)(*s->in++) << s->count;
+    else
+      s->overrun += 8;
     s->count += 8;
   }
+}
+
+static void consume(State *s, int n) {
+  s->bits >>= n;
+  s->count -= n;
+  CHECK(s->count >= s->overrun);
+}
+
+static int bits(State *s, int n) {
+  if (s->count < (unsigned)n) refill(s);
+  int v = (int)(s->bits & ((1u << n) - 1));
+  consume(s, n);
   return v;
 }
 
 static unsigned char *emit(State *s, int len) {
+  CHECK(s->outend - s->out >= len);
   s->out += len;
-  CHECK(s->out <= s->outend);
   return s->out - len;
 }
 
-static void copy(State *s, const unsigned char *src, int len) {
-  unsigned char *dest = emit(s, len);
-  while (len--)
-    *dest++ = *src++;
-}
-
-static int build(State *s, unsigned *tree, unsigned char *lens, unsigned int symcount) {
-  unsigned int codes[16], first[16], counts[16] = {0};
+static void build(State *s, Huffman *h, const unsigned char *lens, int symcount) {
+  int counts[16] = {0}, next[16];
 
   // Frequency count.
-  for (unsigned int n = 0; n < symcount; n++)
+  for (int n = 0; n < symcount; n++)
     counts[lens[n]]++;
-
-  // Distribute codes.
-  counts[0] = codes[0] = first[0] = 0;
-  for (unsigned int n = 1; n <= 15; n++) {
-    codes[n] = (codes[n - 1] + counts[n - 1]) << 1;
-    first[n] = first[n - 1] + counts[n - 1];
-  }
-  CHECK(first[15] + counts[15] <= symcount);
-
-  // Insert keys into the tree for each symbol.
-  for (unsigned int n = 0; n < symcount; n++) {
+  counts[0] = 0;
+
+  // Distribute codes, rejecting over-subscribed sets.
+  int code = 0, symbol = 0;
+  for (int n = 1; n < 16; n++) {
+    next[n] = code;
+    h->firstcode[n] = (unsigned short)code;
+    h->firstsymbol[n] = (unsigned short)symbol;
+    code += counts[n];
+    CHECK(code <= (1 << n));
+    h->maxcode[n] = code << (16 - n);
+    code <<= 1;
+    symbol += counts[n];
+  }
+  h->maxcode[16] = 0x10000;
+
+  // Fill the canonical tables and replicate short codes across the fast table.
+  memset(h->fast, 0, sizeof(h->fast));
+  for (int n = 0; n < symcount; n++) {
     int len = lens[n];
-    if (len != 0) {
-      unsigned code = codes[len]++, slot = first[len]++;
-      tree[slot] = (code << (32 - len)) | (n << 4) | len;
+    if (len == 0) continue;
+
+    int slot = next[len] - h->firstcode[len] + h->firstsymbol[len];
+    h->size[slot] = (unsigned char)len;
+    h->value[slot] = (unsigned short)n;
+    if (len <= FAST_BITS) {
+      for (int j = rev16(next[len]) >> (16 - len); j < (1 << FAST_BITS); j += 1 << len)
+        h->fast[j] = (unsigned short)((len << 9) | n);
     }
+    next[len]++;
   }
-
-  return first[15];
 }
 
-static int decode(State *s, unsigned tree[], int max) {
-  // Find the next prefix code.
-  unsigned lo = 0, hi = max, key;
-  unsigned search = (rev16(s->bits) << 16) | 0xffff;
-  while (lo < hi) {
-    unsigned guess = (lo + hi) / 2;
-    if (search < tree[guess])
-      hi = guess;
-    else
-      lo = guess + 1;
+static int decode(State *s, Huffman *h) {
+  if (s->count < 16) refill(s);
+
+  // Short codes resolve with a single lookup.
+  unsigned fast = h->fast[s->bits & FAST_MASK];
+  if (fast) {
+    consume(s, fast >> 9);
+    return fast & 511;
   }
 
-  // Pull out the key and check it.
-  key = tree[lo - 1];
-  CHECK(((search ^ key) >> (32 - (key & 0xf))) == 0);
+  // Longer codes walk the canonical code lengths.
+  int key = (int)rev16((unsigned)s->bits & 0xffff), len;
+  for (len = FAST_BITS + 1; key >= h->maxcode[len]; len++)
+    ;
+  CHECK(len < 16);
 
-  bits(s, key & 0xf);
-  return (key >> 4) & 0xfff;
+  int slot = (key >> (16 - len)) - h->firstcode[len] + h->firstsymbol[len];
+  CHECK(slot >= 0 && slot < 288 && h->size[slot] == len);
+  consume(s, len);
+  return h->value[slot];
 }
 
 static void run(State *s, int sym) {
   int length = bits(s, lenBits[sym]) + lenBase[sym];
-  int dsym = decode(s, s->distcodes, s->tdist);
+  int dsym = decode(s, &s->dist);
   int offs = bits(s, distBits[dsym]) + distBase[dsym];
-  copy(s, s->out - offs, length);
+  CHECK(offs <= s->out - s->outstart);
+
+  unsigned char *dest = emit(s, length);
+  const unsigned char *src = dest - offs;
+  if (offs >= length) {
+    memcpy(dest, src, length);
+  } else if (offs == 1) {
+    memset(dest, *src, length);
+  } else {
+    while (length--)
+      *dest++ = *src++;
+  }
 }
 
 static void block(State *s) {
   for (;;) {
-    int sym = decode(s, s->litcodes, s->tlit);
+    int sym = decode(s, &s->lit);
     if (sym < 256)
       *emit(s, 1) = (unsigned char)sym;
     else if (sym > 256)
@@ -1253,12 +1981,16 @@ static void stored(State *s) {
   int len;
   bits(s, s->count & 7);
   len = bits(s, 16);
-  CHECK(((len ^ s->bits) & 0xffff) == 0xffff);
-  CHECK(s->in + len <= s->inend);
+  CHECK((len ^ bits(s, 16)) == 0xffff);
+
+  // Hand the whole bytes left in the bit buffer back to the input.
+  s->in -= (s->count - s->overrun) / 8;
+  s->bits = 0;
+  s->count = s->overrun = 0;
 
-  copy(s, s->in, len);
+  CHECK(s->inend - s->in >= len);
+  memcpy(emit(s, len), s->in, len);
   s->in += len;
-  bits(s, 16);
 }
 
 static void fixed(State *s) {
@@ -1276,9 +2008,9 @@ static void fixed(State *s) {
   for (n = 0; n < 32; n++)
     lens[288 + n] = 5;
 
-  // Build lit/dist trees.
-  s->tlit = build(s, s->litcodes, lens, 288);
-  s->tdist = build(s, s->distcodes, lens + 288, 32);
+  // Build lit/dist tables.
+  build(s, &s->lit, lens, 288);
+  build(s, &s->dist, lens + 288, 32);
 }
 
 static void dynamic(State *s) {
@@ -1290,24 +2022,31 @@ static void dynamic(State *s) {
   for (n = 0; n < nlen; n++)
     lenlens[(int)order[n]] = (unsigned char)bits(s, 3);
 
-  // Build the tree for decoding code lengths.
-  s->tlen = build(s, s->lencodes, lenlens, 19);
+  // Build the table for decoding code lengths.
+  build(s, &s->len, lenlens, 19);
 
   // Decode code lengths.
   for (n = 0; n < nlit + ndist;) {
-    int sym = decode(s, s->lencodes, s->tlen);
+    int sym = decode(s, &s->len);
     switch (sym) {
       case 16:
-        for (i = 3 + bits(s, 2); i; i--, n++)
+        CHECK(n > 0);
+        for (i = 3 + bits(s, 2); i; i--, n++) {
+          CHECK(n < nlit + ndist);
           lens[n] = lens[n - 1];
+        }
         break;
       case 17:
-        for (i = 3 + bits(s, 3); i; i--, n++)
+        for (i = 3 + bits(s, 3); i; i--, n++) {
+          CHECK(n < nlit + ndist);
           lens[n] = 0;
+        }
         break;
       case 18:
-        for (i = 11 + bits(s, 7); i; i--, n++)
+        for (i = 11 + bits(s, 7); i; i--, n++) {
+          CHECK(n < nlit + ndist);
           lens[n] = 0;
+        }
         break;
       default:
         lens[n++] = (unsigned char)sym;
@@ -1315,9 +2054,9 @@ static void dynamic(State *s) {
     }
   }
 
-  // Build lit/dist trees.
-  s->tlit = build(s, s->litcodes, lens, nlit);
-  s->tdist = build(s, s->distcodes, lens + nlit, ndist);
+  // Build lit/dist tables.
+  build(s, &s->lit, lens, nlit);
+  build(s, &s->dist, lens + nlit, ndist);
 }
 
 int tigrInflate(void *out, unsigned outlen, const void *in, unsigned inlen) {
@@ -1327,11 +2066,10 @@ int tigrInflate(void *out, unsigned outlen, const void *in, unsigned inlen) {
   // We assume we can buffer 2 extra bytes from off the end of 'in'.
   s->in = (unsigned char *)in;
   s->inend = s->in + inlen + 2;
-  s->out = (unsigned char *)out;
+  s->out = s->outstart = (unsigned char *)out;
   s->outend = s->out + outlen;
   s->bits = 0;
-  s->count = 0;
-  bits(s, 0);
+  s->count = s->overrun = 0;
 
   if (setjmp(s->jmp) == 1) {
     free(s);
@@ -1363,6 +2101,8 @@ int tigrInflate(void *out, unsigned outlen, const void *in, unsigned inlen) {
 
 #undef CHECK
 #undef FAIL
+#undef FAST_BITS
+#undef FAST_MASK
 
 //////// End of inlined file: tigr_inflate.c ////////
 
@@ -1650,6 +2390,8 @@ static int readWatermark(Tigr *bmp, int x, int y, int *big, int *small) {
   return 1;
 }
 
+static TigrGlyph *search(TigrFont *font, int code);
+
 int tigrLoadGlyphs(TigrFont *font, int codepage) {
   int x = 0;
   int y = 0;
@@ -1749,6 +2491,10 @@ int tigrLoadGlyphs(TigrFont *font, int codepage) {
     font->glyphs[j] = g;
   }
 
+  // Resolve ASCII once, printing then never searches for it.
+  for (int code = 0; code < 128; code++)
+    font->ascii[code] = search(font, code);
+
   return 1;
 }
 
@@ -1762,13 +2508,116 @@ TigrFont *tigrLoadFont(Tigr *bitmap, int codepage) {
   return font;
 }
 
+// Text colours in use stay pre-tinted, and recently measured strings keep their widths.
+#define TINT_SLOTS 8
+#define METRIC_SLOTS 32
+#define METRIC_TEXT 48
+
+typedef struct {
+  TPixel color;
+  Tigr *strip;           // the font bitmap multiplied by 'color', filled in glyph by glyph
+  unsigned char *ready;  // per glyph, set once its part of 'strip' is tinted
+} TigrTint;
+
+typedef struct {
+  char text[METRIC_TEXT];
+  int width;
+} TigrMetric;
+
+typedef struct {
+  TigrTint tints[TINT_SLOTS];
+  int nextTint;
+  TigrMetric metrics[METRIC_SLOTS];
+} TigrFontCache;
+
+static void freeTint(TigrTint *tint) {
+  if (tint->strip) tigrFree(tint->strip);
+  free(tint->ready);
+  tint->strip = NULL;
+  tint->ready = NULL;
+}
+
+static void freeCache(TigrFont *font) {
+  TigrFontCache *cache = (TigrFontCache *)font->cache;
+  if (!cache) return;
+
+  for (int i = 0; i < TINT_SLOTS; i++)
+    freeTint(&cache->tints[i]);
+  free(cache);
+  font->cache = NULL;
+}
+
+static TigrFontCache *getCache(TigrFont *font) {
+  if (!font->cache) font->cache = calloc(1, sizeof(TigrFontCache));
+  return (TigrFontCache *)font->cache;
+}
+
+// Returns the strip for 'color', evicting the oldest one when all slots are taken. NULL if it couldn't be allocated.
+static TigrTint *getTint(TigrFont *font, TPixel color) {
+  TigrFontCache *cache = getCache(font);
+  if (!cache) return NULL;
+
+  for (int i = 0; i < TINT_SLOTS; i++) {
+    TigrTint *tint = &cache->tints[i];
+    if (tint->strip && tint->color.r == color.r && tint->color.g == color.g && tint->color.b == color.b) return tint;
+  }
+
+  TigrTint *tint = &cache->tints[cache->nextTint];
+  cache->nextTint = (cache->nextTint + 1) % TINT_SLOTS;
+  freeTint(tint);
+
+  tint->strip = tigrBitmap(font->bitmap->w, font->bitmap->h);
+  tint->ready = (unsigned char *)calloc(font->numGlyphs, 1);
+  if (!tint->strip || !tint->ready) {
+    freeTint(tint);
+    return NULL;
+  }
+  tint->color = color;
+  return tint;
+}
+
+static void tintGlyph(TigrFont *font, TigrTint *tint, TigrGlyph *g) {
+  int index = (int)(g - font->glyphs);
+  if (tint->ready[index]) return;
+
+  int xr = EXPAND(tint->color.r);
+  int xg = EXPAND(tint->color.g);
+  int xb = EXPAND(tint->color.b);
+  for (int y = g->y; y < g->y + g->h; y++) {
+    TPixel *ts = &font->bitmap->pix[y * font->bitmap->w];
+    TPixel *td = &tint->strip->pix[y * tint->strip->w];
+    for (int x = g->x; x < g->x + g->w; x++) {
+      td[x].r = (unsigned char)((xr * ts[x].r) >> 8);
+      td[x].g = (unsigned char)((xg * ts[x].g) >> 8);
+      td[x].b = (unsigned char)((xb * ts[x].b) >> 8);
+      td[x].a = ts[x].a;
+    }
+  }
+  tint->ready[index] = 1;
+}
+
+static TigrMetric *getMetric(TigrFont *font, const char *text) {
+  TigrFontCache *cache = getCache(font);
+  if (!cache) return NULL;
+
+  // FNV-1a, bails out on strings too long to memoise.
+  unsigned hash = 2166136261u;
+  size_t len = 0;
+  for (; text[len]; len++) {
+    if (len + 1 >= METRIC_TEXT) return NULL;
+    hash = (hash ^ (unsigned char)text[len]) * 16777619u;
+  }
+  return &cache->metrics[hash % METRIC_SLOTS];
+}
+
 void tigrFreeFont(TigrFont *font) {
+  freeCache(font);
   tigrFree(font->bitmap);
   free(font->glyphs);
   free(font);
 }
 
-static TigrGlyph *get(TigrFont *font, int code) {
+static TigrGlyph *search(TigrFont *font, int code) {
   unsigned lo = 0, hi = font->numGlyphs;
   while (lo < hi) {
     unsigned guess = (lo + hi) / 2;
@@ -1784,6 +2633,11 @@ static TigrGlyph *get(TigrFont *font, int code) {
     return &font->glyphs[lo - 1];
 }
 
+static TigrGlyph *get(TigrFont *font, int code) {
+  if (code >= 0 && code < 128) return font->ascii[code];
+  return search(font, code);
+}
+
 void tigrSetupFont(TigrFont *font) {
   // Load the stock font if needed.
   if (font == tfont && !tfont->bitmap) {
@@ -1795,20 +2649,29 @@ void tigrSetupFont(TigrFont *font) {
 void tigrPrint(Tigr *dest, TigrFont *font, int x, int y, TPixel color, const char *text, ...) {
   char tmp[1024];
   TigrGlyph *g;
+  TigrTint *tint;
   va_list args;
   const char *p;
   int start = x, c;
 
   tigrSetupFont(font);
 
-  // Expand the formatting string.
-  va_start(args, text);
-  vsnprintf(tmp, sizeof(tmp), text, args);
-  tmp[sizeof(tmp) - 1] = 0;
-  va_end(args);
+  // Expand the formatting string, unless there's nothing to expand.
+  for (p = text; *p && *p != '%' && p - text < (int)sizeof(tmp) - 1; p++)
+    ;
+  if (*p) {
+    va_start(args, text);
+    vsnprintf(tmp, sizeof(tmp), text, args);
+    tmp[sizeof(tmp) - 1] = 0;
+    va_end(args);
+    p = tmp;
+  } else {
+    p = text;
+  }
+
+  tint = getTint(font, color);
 
   // Print each glyph.
-  p = tmp;
   while (*p) {
     p = tigrDecodeUTF8(p, &c);
     if (c == '\r') continue;
@@ -1818,7 +2681,12 @@ void tigrPrint(Tigr *dest, TigrFont *font, int x, int y, TPixel color, const cha
       continue;
     }
     g = get(font, c);
-    tigrBlitTint(dest, font->bitmap, x, y, g->x, g->y, g->w, g->h, color);
+    if (tint) {
+      tintGlyph(font, tint, g);
+      blitPretinted(dest, tint->strip, x, y, g->x, g->y, g->w, g->h, EXPAND(color.a));
+    } else {
+      tigrBlitTint(dest, font->bitmap, x, y, g->x, g->y, g->w, g->h, color);
+    }
     x += g->w;
   }
 }
@@ -1827,8 +2695,12 @@ int tigrTextWidth(TigrFont *font, const char *text) {
   int x = 0, w = 0, c;
   tigrSetupFont(font);
 
-  while (*text) {
-    text = tigrDecodeUTF8(text, &c);
+  TigrMetric *metric = getMetric(font, text);
+  if (metric && strcmp(metric->text, text) == 0) return metric->width;
+
+  const char *p = text;
+  while (*p) {
+    p = tigrDecodeUTF8(p, &c);
     if (c == '\n' || c == '\r') {
       x = 0;
     } else {
@@ -1836,6 +2708,11 @@ int tigrTextWidth(TigrFont *font, const char *text) {
       w = (x > w) ? x : w;
     }
   }
+
+  if (metric) {
+    strcpy(metric->text, text);
+    metric->width = w;
+  }
   return w;
 }
 
@@ -1866,6 +2743,25 @@ TigrInternal *tigrInternal(Tigr *bmp) {
   return (TigrInternal *)(bmp + 1);
 }
 
+void tigrDamage(Tigr *bmp, int x, int y, int w, int h) {
+  TigrInternal *win = tigrInternal(bmp);
+  if (w <= 0 || h <= 0) return;
+
+  int *d = win->damage;
+  if (d[0] >= d[2]) {
+    d[0] = x;
+    d[1] = y;
+    d[2] = x + w;
+    d[3] = y + h;
+  } else {
+    d[0] = x < d[0] ? x : d[0];
+    d[1] = y < d[1] ? y : d[1];
+    d[2] = x + w > d[2] ? x + w : d[2];
+    d[3] = y + h > d[3] ? y + h : d[3];
+  }
+  win->damaged = 1;
+}
+
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <shellapi.h>
@@ -4452,7 +5348,7 @@ Tigr *tigrWindow(int w, int h, const char *title, int flags) {
 
   cmap = XCreateColormap(dpy, root, vi->visual, AllocNone);
   swa.colormap = cmap;
-  swa.event_mask = StructureNotifyMask;
+  swa.event_mask = StructureNotifyMask | ButtonPressMask | ButtonReleaseMask | KeyPressMask | KeyReleaseMask;
 
   // Create window of wanted size
   xwin = XCreateWindow(dpy,
@@ -4905,8 +5801,61 @@ int tigrTouch(Tigr *bmp, TigrTouchPoint *points, int maxPoints) {
   return buttons ? 1 : 0;
 }
 
+// Same bits tigrMouse reports. The wheel and extra buttons aren't reported.
+static int tigrButtonFromX11(unsigned int button) {
+  switch (button) {
+    case Button1:
+      return 1;
+    case Button3:
+      return 2;
+    case Button2:
+      return 4;
+  }
+  return 0;
+}
+
+int tigrReadEvent(Tigr *bmp, TigrEvent *event) {
+  TigrInternal *win = tigrInternal(bmp);
+  if (!win->win) { return 0; }
+
+  XEvent e;
+  long mask = ButtonPressMask | ButtonReleaseMask | KeyPressMask | KeyReleaseMask;
+  while (XCheckWindowEvent(win->dpy, win->win, mask, &e)) {
+    memset(event, 0, sizeof(*event));
+    if (e.type == ButtonPress || e.type == ButtonRelease) {
+      event->button = tigrButtonFromX11(e.xbutton.button);
+      if (!event->button) { continue; }
+
+      event->type = e.type == ButtonPress ? TIGR_MOUSE_DOWN : TIGR_MOUSE_UP;
+      event->x = (e.xbutton.x - win->pos[0]) / win->scale;
+      event->y = (e.xbutton.y - win->pos[1]) / win->scale;
+      event->time = e.xbutton.time;
+      return 1;
+    }
+
+    event->key = tigrKeyFromX11(XLookupKeysym(&e.xkey, 0));
+    if (!event->key) { continue; }
+
+    event->type = e.type == KeyPress ? TIGR_KEY_DOWN : TIGR_KEY_UP;
+    event->x = (e.xkey.x - win->pos[0]) / win->scale;
+    event->y = (e.xkey.y - win->pos[1]) / win->scale;
+    event->time = e.xkey.time;
+    return 1;
+  }
+
+  return 0;
+}
+
 #endif  // __linux__ && !__ANDROID__
 
+#if !(__linux__ && !__ANDROID__)
+int tigrReadEvent(Tigr *bmp, TigrEvent *event) {
+  (void)bmp;
+  (void)event;
+  return -1;
+}
+#endif  // !(__linux__ && !__ANDROID__)
+
 #endif  // #ifndef TIGR_HEADLESS
 
 //////// End of inlined file: tigr_linux.c ////////
@@ -5970,6 +6919,7 @@ void tigrGAPICreate(Tigr *bmp) {
   // create textures
   if (gl->gl_legacy) { glEnable(GL_TEXTURE_2D); }
   glGenTextures(2, gl->tex);
+  gl->texW = gl->texH = 0;
   for (int i = 0; i < 2; ++i) {
     glBindTexture(GL_TEXTURE_2D, gl->tex[i]);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, gl->gl_legacy ? GL_NEAREST : GL_LINEAR);
@@ -6003,9 +6953,46 @@ void tigrGAPIDestroy(Tigr *bmp) {
   }
 }
 
+// Uploads the window's bitmap into tex[0], which keeps its storage from frame to frame. Once the window tracks damage
+// only the damaged rectangle is sent.
+static void tigrGAPIUpload(TigrInternal *win, GLStuff *gl, Tigr *bmp) {
+  glBindTexture(GL_TEXTURE_2D, gl->tex[0]);
+
+  int *d = win->damage;
+  if (gl->texW != bmp->w || gl->texH != bmp->h) {
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, bmp->w, bmp->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, bmp->pix);
+    gl->texW = bmp->w;
+    gl->texH = bmp->h;
+  } else if (!win->damaged) {
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, bmp->w, bmp->h, GL_RGBA, GL_UNSIGNED_BYTE, bmp->pix);
+  } else {
+    int x1 = d[0] > 0 ? d[0] : 0;
+    int y1 = d[1] > 0 ? d[1] : 0;
+    int x2 = d[2] < bmp->w ? d[2] : bmp->w;
+    int y2 = d[3] < bmp->h ? d[3] : bmp->h;
+
+    if (x1 < x2 && y1 < y2) {
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, bmp->w);
+      glTexSubImage2D(GL_TEXTURE_2D,
+                      0,
+                      x1,
+                      y1,
+                      x2 - x1,
+                      y2 - y1,
+                      GL_RGBA,
+                      GL_UNSIGNED_BYTE,
+                      &bmp->pix[y1 * bmp->w + x1]);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+  }
+
+  d[0] = d[1] = d[2] = d[3] = 0;
+}
+
+// Draws tex over (x1, y1) - (x2, y2), uploading bmp into it first unless it's NULL.
 void tigrGAPIDraw(int legacy, GLuint uniform_model, GLuint tex, Tigr *bmp, int x1, int y1, int x2, int y2) {
   glBindTexture(GL_TEXTURE_2D, tex);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, bmp->w, bmp->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, bmp->pix);
+  if (bmp) glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, bmp->w, bmp->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, bmp->pix);
 
   if (!legacy) {
     float sx = (float)(x2 - x1);
@@ -6071,7 +7058,8 @@ void tigrGAPIPresent(Tigr *bmp, int w, int h) {
   } else {
     glDisable(GL_BLEND);
   }
-  tigrGAPIDraw(gl->gl_legacy, gl->uniform_model, gl->tex[0], bmp, win->pos[0], win->pos[1], win->pos[2], win->pos[3]);
+  tigrGAPIUpload(win, gl, bmp);
+  tigrGAPIDraw(gl->gl_legacy, gl->uniform_model, gl->tex[0], NULL, win->pos[0], win->pos[1], win->pos[2], win->pos[3]);
 
   if (win->widgetsScale > 0) {
     glEnable(GL_BLEND);
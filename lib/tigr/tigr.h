@@ -86,6 +86,12 @@ int tigrClosed(Tigr *bmp);
 // Displays a window's contents on-screen and updates input.
 void tigrUpdate(Tigr *bmp);
 
+// Marks a rectangle of a window as changed since the last tigrUpdate.
+// Until a window is first damaged, tigrUpdate uploads all of it every frame.
+// From then on it only uploads what was damaged since the previous update,
+// so everything that changes on-screen must be damaged.
+void tigrDamage(Tigr *bmp, int x, int y, int w, int h);
+
 // Called before doing direct OpenGL calls and before tigrUpdate.
 // Returns non-zero if OpenGL is available.
 int tigrBeginOpenGL(Tigr *bmp);
@@ -180,6 +186,36 @@ void tigrBlit(Tigr *dest, Tigr *src, int dx, int dy, int sx, int sy, int w, int
 // Clips and blends.
 void tigrBlitAlpha(Tigr *dest, Tigr *src, int dx, int dy, int sx, int sy, int w, int h, float alpha);
 
+// How a bitmap may be blit at full alpha without changing the result of
+// tigrBlitAlpha.
+enum TIGRBlitKind {
+  TIGR_BLIT_BLEND = 0,  // Translucent pixels, blend
+  TIGR_BLIT_MASK = 1,   // Opaque or fully transparent pixels only, copy the opaque ones
+  TIGR_BLIT_COPY = 2,   // Opaque pixels only, copy rows
+};
+
+// Classifies a bitmap by its alpha channel. Scans every pixel, so classify
+// once and again only after drawing onto the bitmap.
+int tigrBlitKind(Tigr *src);
+
+// Alpha blends a grid of equally sized cells onto dest in one pass, each
+// cell from its own bitmap, exactly like tigrBlitAlpha would one by one.
+// cells holds rows*cols bitmaps in row major order, NULL cells are skipped.
+// kinds, if not NULL, holds the tigrBlitKind of every cell. When alpha is 1
+// and dest blends alpha, cells are copied or masked rather than blended.
+// Cell (row, col) lands at (dx + col*cw, dy + row*ch) and is cropped to cw*ch.
+// Clips once for the whole grid.
+void tigrBlitGrid(Tigr *dest,
+                  Tigr *const *cells,
+                  const unsigned char *kinds,
+                  int rows,
+                  int cols,
+                  int cw,
+                  int ch,
+                  int dx,
+                  int dy,
+                  float alpha);
+
 // Same as tigrBlit, but tints the source bitmap with a color
 // and alpha blends the resulting source with the destination.
 //
@@ -236,6 +272,8 @@ typedef struct {
   Tigr *bitmap;
   int numGlyphs;
   TigrGlyph *glyphs;
+  TigrGlyph *ascii[128];  // direct lookup for code points below 128
+  void *cache;            // pre-tinted glyphs and memoised metrics, created on first use
 } TigrFont;
 
 typedef enum { TCP_ASCII = 0, TCP_1252 = 1252, TCP_UTF32 = 12001 } TCodepage;
@@ -369,6 +407,28 @@ int tigrKeyHeld(Tigr *bmp, int key);
 // Returns the Unicode value of the last key pressed, or 0 if none.
 int tigrReadChar(Tigr *bmp);
 
+// Input event types.
+#define TIGR_MOUSE_DOWN 1
+#define TIGR_MOUSE_UP 2
+#define TIGR_KEY_DOWN 3
+#define TIGR_KEY_UP 4
+
+typedef struct {
+  int type;            // TIGR_MOUSE_DOWN, ...
+  int x, y;            // Mouse position at the time
+  int button;          // The mouse button, as reported by tigrMouse
+  int key;             // The TKey or character
+  unsigned long time;  // Milliseconds from an arbitrary origin
+} TigrEvent;
+
+// Reads the oldest mouse button or key event of a window, catching every
+// press and release that happened between updates.
+// Returns 1 if an event was read, 0 if none is left, or -1 if the platform
+// doesn't report events (poll tigrMouse and tigrKeyDown instead).
+// Events pile up until they're read. Only X11 reports them so far, offscreen
+// (TIGR_HEADLESS) windows never get any.
+int tigrReadEvent(Tigr *bmp, TigrEvent *event);
+
 // Show / hide virtual keyboard.
 // (Only available on iOS / Android)
 void tigrShowKeyboard(int show);
@@ -384,6 +444,20 @@ Tigr *tigrLoadImageMem(const void *data, int length);
 // On error, returns zero and sets errno.
 int tigrSaveImage(const char *fileName, Tigr *bmp);
 
+// Compression level of tigrSaveImage, from 0 (stored, fastest) to 9 (smallest).
+#ifndef TIGR_PNG_DEFAULT_LEVEL
+#define TIGR_PNG_DEFAULT_LEVEL 6
+#endif
+
+// Same as tigrSaveImage at the given compression level.
+int tigrSaveImageLevel(const char *fileName, Tigr *bmp, int level);
+
+// Encodes a PNG into memory at the given compression level.
+// Returns the encoded bytes (free them with free) and their amount in size, or NULL on error.
+// The encoder keeps no state between calls: it, tigrSaveImage and tigrSaveImageLevel may be called from several
+// threads at once, as long as none of them draws to bmp meanwhile.
+void *tigrEncodeImage(Tigr *bmp, int level, int *size);
+
 // Helpers ----------------------------------------------------------------
 
 // Returns the amount of time elapsed since tigrTime was last called,
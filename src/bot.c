@@ -0,0 +1,158 @@
+#include "bot.h"
+#include <string.h>
+
+enum bot_local_size {
+  BOT_LINE = 128,  // the longest command understood
+  BOT_WORD = 16,
+};
+
+static char const *const moves[MOVE_KIND_AMOUNT] = {
+    [MOVE_REVEAL] = "open",
+    [MOVE_MARK] = "flag",
+    [MOVE_CHORD] = "chord",
+};
+
+static struct {
+  char const *name;
+  enum difficulty difficulty;
+} const difficulties[MS_DIFFICULTIES] = {
+    {"classic", MS_CLASSIC},
+    {"advanced", MS_ADVANCED},
+    {"expert", MS_EXPERT},
+};
+
+static char const *state_as_str(enum game_state state) {
+  switch (state) {
+    case STATE_PLAYING:
+      return "playing";
+    case STATE_WON:
+      return "won";
+    case STATE_LOST:
+      return "lost";
+    case STATE_INVALID:
+    default:  // fallthrough
+      return "invalid";
+  }
+}
+
+static char cell_as_char(struct cell cell) {
+  if (cell.revealed) return cell.mine ? '*' : (char)('0' + cell.adjacent_mines);
+
+  switch (cell.mark) {
+    case MARK_MINE:
+      return 'F';
+    case MARK_QUESTION:
+      return '?';
+    default:
+      return '.';
+  }
+}
+
+static void print_status(struct game const *restrict game, FILE *restrict out, char const *restrict result) {
+  fprintf(out,
+          "%s %s %d %zu %zu\n",
+          result,
+          state_as_str(game->state),
+          game->mines,
+          board_rows(&game->board),
+          board_cols(&game->board));
+}
+
+// the answers are flushed right away, the bot on the other end waits for them before sending the next command
+static enum bot_reply answer(struct game const *restrict game,
+                             FILE *restrict out,
+                             char const *restrict result,
+                             enum bot_reply reply) {
+  print_status(game, out, result);
+  fflush(out);
+  return reply;
+}
+
+static enum bot_reply answer_error(FILE *restrict out, char const *restrict reason, enum bot_reply reply) {
+  fprintf(out, "error %s\n", reason);
+  fflush(out);
+  return reply;
+}
+
+static enum bot_reply print_board(struct game const *restrict game, FILE *restrict out) {
+  struct board const *board = &game->board;
+
+  print_status(game, out, "ok");
+  for (size_t row = 0; row < board_rows(board); row++) {
+    for (size_t col = 0; col < board_cols(board); col++) {
+      putc(cell_as_char(board_cell(board, row, col)), out);
+    }
+    putc('\n', out);
+  }
+  fflush(out);
+  return BOT_IGNORED;
+}
+
+static enum bot_reply start_over(struct game *restrict game, char const *restrict args, FILE *restrict out) {
+  size_t rows = 0;
+  size_t cols = 0;
+  size_t mines = 0;
+  char name[BOT_WORD];
+
+  if (sscanf(args, "%zu %zu %zu", &rows, &cols, &mines) == 3) {
+    // the current game goes on if the new one can't be created
+    struct game custom = game_create_custom(rows, cols, mines);
+    if (custom.state == STATE_INVALID) {
+      game_destroy(&custom);
+      return answer_error(out, "invalid board", BOT_IGNORED);
+    }
+
+    // a generator deals the custom board again
+    custom.no_guess = game->no_guess;
+    game_destroy(game);
+    *game = custom.no_guess ? game_reset(&custom) : custom;
+  } else if (sscanf(args, "%15s", name) == 1) {
+    size_t i = 0;
+    while (i < MS_DIFFICULTIES && strcmp(name, difficulties[i].name)) i++;
+    if (i == MS_DIFFICULTIES) return answer_error(out, "unknown difficulty", BOT_IGNORED);
+
+    *game = game_restart(game, difficulties[i].difficulty);
+  } else {
+    *game = game_reset(game);
+  }
+
+  if (game->state == STATE_INVALID) return answer_error(out, "failed to create a new game", BOT_QUIT);
+  return answer(game, out, "ok", BOT_STARTED);
+}
+
+enum bot_reply bot_serve(struct game *restrict game, FILE *restrict in, FILE *restrict out) {
+  if (!game || !in || !out) return BOT_QUIT;
+
+  char line[BOT_LINE];
+  if (!fgets(line, sizeof line, in)) return BOT_QUIT;
+
+  // skip the rest of a line too long to be a command
+  if (!strchr(line, '\n') && !feof(in)) {
+    for (int c = getc(in); c != '\n' && c != EOF; c = getc(in)) {}
+    return answer_error(out, "line too long", BOT_IGNORED);
+  }
+
+  char command[BOT_WORD];
+  int length = 0;
+  if (sscanf(line, "%15s%n", command, &length) != 1) return answer_error(out, "empty line", BOT_IGNORED);
+  char const *args = line + length;
+
+  for (enum move_kind kind = 0; kind < MOVE_KIND_AMOUNT; kind++) {
+    if (strcmp(command, moves[kind])) continue;
+
+    size_t row = 0;
+    size_t col = 0;
+    if (sscanf(args, "%zu %zu", &row, &col) != 2) return answer_error(out, "expected <row> <col>", BOT_IGNORED);
+
+    if (!game_step(game, (struct game_action){.kind = kind, .row = row, .col = col})) {
+      return answer(game, out, "ignored", BOT_IGNORED);
+    }
+    return answer(game, out, "ok", BOT_MOVED);
+  }
+
+  if (!strcmp(command, "new")) return start_over(game, args, out);
+  if (!strcmp(command, "board")) return print_board(game, out);
+  if (!strcmp(command, "quit")) return answer(game, out, "ok", BOT_QUIT);
+
+  return answer_error(out, "unknown command", BOT_IGNORED);
+}
@@ -1,4 +1,40 @@
 #include "game.h"
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+enum game_local_size {
+  LOG_CAPACITY = 64,  // the log's first allocation
+};
+
+// a game starts with a running clock and an empty log. the log's storage is kept across restarts
+static struct game game_start(struct board board, struct move_log log) {
+  log.size = 0;
+  return (struct game){.state = STATE_PLAYING,
+                       .clock = {.resumed = game_clock_now(), .elapsed = 0, .running = true},
+                       .log = log,
+                       .board = board,
+                       .mines = board_mines(&board)};
+}
+
+// deals the board again from the game's generator if it has one. the random board stays if the generator gave up on
+// its size
+static void deal(struct game *restrict game) {
+  size_t rows = board_rows(&game->board);
+  size_t cols = board_cols(&game->board);
+  uint64_t seed = 0;
+  if (!game->no_guess || !no_guess_deal(game->no_guess, rows, cols, board_mines(&game->board), &seed)) return;
+  if (!board_reset_seeded(&game->board, seed)) return;
+
+  size_t row = 0;
+  size_t col = 0;
+  no_guess_start(rows, cols, &row, &col);
+  game_step(game, (struct game_action){.kind = MOVE_REVEAL, .row = row, .col = col});
+}
 
 struct game game_create(enum difficulty difficulty) {
   struct game game = {.state = STATE_INVALID};
@@ -6,30 +42,205 @@ struct game game_create(enum difficulty difficulty) {
   if (!board_create(&game.board, difficulty)) return game;
   if (!board_init(&game.board, difficulty)) return game;
 
-  return (struct game){.state = STATE_PLAYING,
-                       .clock = {.start = time(NULL), .end = -1},
-                       .board = game.board,
-                       .mines = board_mines(&game.board),
-                       .prev_buttons = 0};
+  return game_start(game.board, (struct move_log){0});
+}
+
+struct game game_create_custom(size_t rows, size_t cols, size_t mines) {
+  struct game game = {.state = STATE_INVALID};
+
+  if (!board_create_custom(&game.board, rows, cols, mines)) return game;
+  if (!board_init_custom(&game.board, rows, cols, mines)) return game;
+
+  return game_start(game.board, (struct move_log){0});
 }
 
 struct game game_restart(struct game *restrict game, enum difficulty difficulty) {
   if (!game) return (struct game){.state = STATE_INVALID};
 
   if (!board_init(&game->board, difficulty)) {
-    board_destroy(&game->board);
+    game_destroy(game);
     return (struct game){.state = STATE_INVALID};
   }
 
-  return (struct game){.state = STATE_PLAYING,
-                       .clock = {.start = time(NULL), .end = -1},
-                       .board = game->board,
-                       .mines = board_mines(&game->board),
-                       .prev_buttons = 0};
+  struct game restarted = game_start(game->board, game->log);
+  restarted.no_guess = game->no_guess;
+  deal(&restarted);
+  return restarted;
+}
+
+struct game game_reset(struct game *restrict game) {
+  if (!game) return (struct game){.state = STATE_INVALID};
+
+  if (!board_reset(&game->board)) {
+    game_destroy(game);
+    return (struct game){.state = STATE_INVALID};
+  }
+
+  struct game reset = game_start(game->board, game->log);
+  reset.no_guess = game->no_guess;
+  deal(&reset);
+  return reset;
 }
 
 void game_destroy(struct game *restrict game) {
   if (!game) return;
 
   board_destroy(&game->board);
+
+  free(game->log.moves);
+  game->log = (struct move_log){0};
+}
+
+uint64_t game_clock_now(void) {
+#ifdef _WIN32
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+
+  // split to not overflow the multiplication
+  uint64_t ticks = (uint64_t)counter.QuadPart;
+  uint64_t hz = (uint64_t)frequency.QuadPart;
+  return ticks / hz * NSEC_PER_SEC + ticks % hz * NSEC_PER_SEC / hz;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * NSEC_PER_SEC + (uint64_t)now.tv_nsec;
+#endif
+}
+
+void game_pause(struct game *restrict game) {
+  if (!game || !game->clock.running) return;
+
+  game->clock.elapsed += game_clock_now() - game->clock.resumed;
+  game->clock.running = false;
+}
+
+void game_resume(struct game *restrict game) {
+  if (!game || game->clock.running) return;
+
+  game->clock.resumed = game_clock_now();
+  game->clock.running = true;
+}
+
+uint64_t game_elapsed(struct game const *restrict game) {
+  if (!game) return 0;
+
+  struct game_clock const *clock = &game->clock;
+  return clock->running ? clock->elapsed + game_clock_now() - clock->resumed : clock->elapsed;
+}
+
+bool game_record_move(struct game *restrict game, enum move_kind kind, size_t row, size_t col) {
+  if (!game) return false;
+
+  struct move_log *log = &game->log;
+  if (log->size == log->capacity) {
+    size_t capacity = log->capacity ? log->capacity * 2 : LOG_CAPACITY;
+
+    struct move *moves = realloc(log->moves, capacity * sizeof *moves);
+    if (!moves) return false;
+
+    log->moves = moves;
+    log->capacity = capacity;
+  }
+
+  log->moves[log->size++] = (struct move){.time = game_elapsed(game), .row = row, .col = col, .kind = kind};
+  return true;
+}
+
+static size_t sum_adjacent_flags(struct board const *restrict board, size_t row, size_t col) {
+  size_t adjacent_flags = 0;
+
+  // out of bounds neighbours wrap around and are blank
+  for (size_t curr_row = row - 1; curr_row != row + 2; curr_row++) {
+    for (size_t curr_col = col - 1; curr_col != col + 2; curr_col++) {
+      if (board_cell(board, curr_row, curr_col).mark == MARK_MINE) adjacent_flags++;
+    }
+  }
+  return adjacent_flags;
+}
+
+// reveals the cell at (row, col) unless it's out of bounds, revealed or flagged. zero cells open their whole region
+static void reveal_cell(struct game *restrict game, size_t row, size_t col) {
+  if (row >= board_rows(&game->board) || col >= board_cols(&game->board)) return;
+
+  struct cell cell = board_cell(&game->board, row, col);
+  if (cell.revealed || cell.mark == MARK_MINE) return;
+
+  board_open(&game->board, row, col);
+  if (cell.mine) game->state = STATE_LOST;
+}
+
+// reveals the neighbours of the revealed cell at (row, col) as long as it has as many flags around it as mines
+static void chord(struct game *restrict game, size_t row, size_t col) {
+  struct cell cell = board_cell(&game->board, row, col);
+  if (!cell.revealed || sum_adjacent_flags(&game->board, row, col) < cell.adjacent_mines) return;
+
+  for (size_t next_row = row - 1; next_row != row + 2 && game->state != STATE_LOST; next_row++) {
+    for (size_t next_col = col - 1; next_col != col + 2 && game->state != STATE_LOST; next_col++) {
+      reveal_cell(game, next_row, next_col);
+    }
+  }
+}
+
+static int flag(struct board *restrict board, size_t row, size_t col, int mines) {
+  switch (board_mark_cell(board, row, col)) {
+    case MARK_MINE:
+      return mines - 1;
+    case MARK_QUESTION:
+      return mines + 1;
+    case MARK_NONE:
+    default:  // fallthrough
+      return mines;
+  }
+}
+
+bool game_step(struct game *restrict game, struct game_action action) {
+  if (!game || game->state != STATE_PLAYING) return false;
+
+  size_t row = action.row;
+  size_t col = action.col;
+  if (row >= board_rows(&game->board) || col >= board_cols(&game->board)) return false;
+
+  struct cell cell = board_cell(&game->board, row, col);
+  board_clear_changes(&game->board);
+
+  switch (action.kind) {
+    case MOVE_REVEAL:
+      if (cell.revealed || cell.mark != MARK_NONE) return false;
+
+      game_record_move(game, MOVE_REVEAL, row, col);
+
+      if (cell.mine) {
+        game->state = STATE_LOST;
+      } else {
+        board_open(&game->board, row, col);
+      }
+      break;
+    case MOVE_MARK:
+      if (cell.revealed) return false;
+
+      game_record_move(game, MOVE_MARK, row, col);
+      game->mines = flag(&game->board, row, col, game->mines);
+      break;
+    case MOVE_CHORD:
+      if (!cell.revealed) return false;
+
+      game_record_move(game, MOVE_CHORD, row, col);
+      chord(game, row, col);
+      break;
+    default:
+      return false;
+  }
+
+  // check win condition
+  if (board_revealed_cells(&game->board) && game->state == STATE_PLAYING) {
+    game->state = STATE_WON;
+    game->mines = 0;
+  }
+
+  // revealing the mines walks the whole board, it's done once the game is over rather than on every frame
+  if (game->state != STATE_PLAYING) board_reveal_mines(&game->board);
+  return true;
 }
@@ -0,0 +1,264 @@
+#include "hint.h"
+#include <stdlib.h>
+#include "solver.h"
+#include "version.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+enum hint_local_size {
+  HINT_RESULTS = 4,  // hints not collected yet past which the next ones are dropped
+};
+
+struct hints {
+#ifdef _WIN32
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE wake;
+  HANDLE thread;
+#else
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_t thread;
+#endif
+
+  struct board_versions *versions;  // the worker is their only reader
+  struct solver *solver;            // owned by the worker
+
+  // guarded by `lock`
+  uint64_t requested;  // the sequence of the version a hint was last asked for on, 0 before the first
+  bool stopping;
+
+  // the found hints are `results[head]`, ..., `results[tail - 1]` modulo HINT_RESULTS. the worker alone moves `tail`,
+  // the game alone moves `head`
+  uint64_t head;
+  uint64_t tail;
+  struct hint results[HINT_RESULTS];
+};
+
+#ifdef _WIN32
+static bool sync_init(struct hints *restrict hints) {
+  InitializeCriticalSection(&hints->lock);
+  InitializeConditionVariable(&hints->wake);
+  return true;
+}
+
+static void sync_destroy(struct hints *restrict hints) {
+  DeleteCriticalSection(&hints->lock);
+}
+
+static void sync_lock(struct hints *restrict hints) {
+  EnterCriticalSection(&hints->lock);
+}
+
+static void sync_unlock(struct hints *restrict hints) {
+  LeaveCriticalSection(&hints->lock);
+}
+
+static void sync_wait(struct hints *restrict hints) {
+  SleepConditionVariableCS(&hints->wake, &hints->lock, INFINITE);
+}
+
+static void sync_wake(struct hints *restrict hints) {
+  WakeConditionVariable(&hints->wake);
+}
+
+static uint64_t load_index(uint64_t volatile *index) {
+  return (uint64_t)InterlockedCompareExchange64((LONG64 volatile *)index, 0, 0);
+}
+
+static void store_index(uint64_t volatile *index, uint64_t value) {
+  InterlockedExchange64((LONG64 volatile *)index, (LONG64)value);
+}
+#else
+static bool sync_init(struct hints *restrict hints) {
+  if (pthread_mutex_init(&hints->lock, NULL)) return false;
+  if (pthread_cond_init(&hints->wake, NULL)) {
+    pthread_mutex_destroy(&hints->lock);
+    return false;
+  }
+
+  return true;
+}
+
+static void sync_destroy(struct hints *restrict hints) {
+  pthread_cond_destroy(&hints->wake);
+  pthread_mutex_destroy(&hints->lock);
+}
+
+static void sync_lock(struct hints *restrict hints) {
+  pthread_mutex_lock(&hints->lock);
+}
+
+static void sync_unlock(struct hints *restrict hints) {
+  pthread_mutex_unlock(&hints->lock);
+}
+
+static void sync_wait(struct hints *restrict hints) {
+  pthread_cond_wait(&hints->wake, &hints->lock);
+}
+
+static void sync_wake(struct hints *restrict hints) {
+  pthread_cond_signal(&hints->wake);
+}
+
+// a slot is written before the index handing it over is, and read before the index handing it back is
+static uint64_t load_index(uint64_t volatile *index) {
+  return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+}
+
+static void store_index(uint64_t volatile *index, uint64_t value) {
+  __atomic_store_n(index, value, __ATOMIC_RELEASE);
+}
+#endif
+
+// drops the hint if the game doesn't collect them
+static void push(struct hints *restrict hints, struct hint hint) {
+  uint64_t tail = load_index(&hints->tail);
+  if (tail - load_index(&hints->head) == HINT_RESULTS) return;
+
+  hints->results[tail % HINT_RESULTS] = hint;
+  store_index(&hints->tail, tail + 1);
+}
+
+// what a solve is cancelled by
+struct job {
+  struct hints *hints;
+  uint64_t sequence;
+};
+
+// a move was made since the solve began, or the game is closing
+static bool superseded(void *job) {
+  struct job const *current = job;
+  if (board_versions_sequence(current->hints->versions) != current->sequence) return true;
+
+  sync_lock(current->hints);
+  bool stopping = current->hints->stopping;
+  sync_unlock(current->hints);
+  return stopping;
+}
+
+// the worker. solves the latest version whenever a hint is asked for, until `stopping` is set
+static void solve(struct hints *restrict hints) {
+  uint64_t answered = 0;
+  for (;;) {
+    sync_lock(hints);
+    while (hints->requested == answered && !hints->stopping) sync_wait(hints);
+
+    bool stopping = hints->stopping;
+    answered = hints->requested;
+    sync_unlock(hints);
+
+    if (stopping) return;
+
+    // a move made since the hint was asked for cancels it before it even begins
+    struct board_version const *version = board_version_acquire(hints->versions, 0);
+    struct job job = {.hints = hints, .sequence = answered};
+    struct solver_hint found;
+    if (version && version->sequence == answered && solver_hint(hints->solver, version, superseded, &job, &found)) {
+      push(hints, (struct hint){.sequence = answered, .row = found.row, .col = found.col, .mine = found.mine});
+    }
+    board_version_release(hints->versions, 0);
+  }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker(LPVOID hints) {
+  solve(hints);
+  return 0;
+}
+
+static bool start(struct hints *restrict hints) {
+  hints->thread = CreateThread(NULL, 0, worker, hints, 0, NULL);
+  return hints->thread != NULL;
+}
+
+static void join(struct hints *restrict hints) {
+  WaitForSingleObject(hints->thread, INFINITE);
+  CloseHandle(hints->thread);
+}
+#else
+static void *worker(void *hints) {
+  solve(hints);
+  return NULL;
+}
+
+static bool start(struct hints *restrict hints) {
+  return !pthread_create(&hints->thread, NULL, worker, hints);
+}
+
+static void join(struct hints *restrict hints) {
+  pthread_join(hints->thread, NULL);
+}
+#endif
+
+struct hints *hints_create(void) {
+  struct hints *hints = calloc(1, sizeof *hints);
+  if (!hints) return NULL;
+
+  hints->versions = board_versions_create(1);
+  if (!hints->versions) goto hints_cleanup;
+
+  hints->solver = solver_create();
+  if (!hints->solver) goto versions_cleanup;
+
+  if (!sync_init(hints)) goto solver_cleanup;
+  if (!start(hints)) goto sync_cleanup;
+
+  return hints;
+
+sync_cleanup:
+  sync_destroy(hints);
+solver_cleanup:
+  solver_destroy(hints->solver);
+versions_cleanup:
+  board_versions_destroy(hints->versions);
+hints_cleanup:
+  free(hints);
+  return NULL;
+}
+
+void hints_destroy(struct hints *restrict hints) {
+  if (!hints) return;
+
+  sync_lock(hints);
+  hints->stopping = true;
+  sync_wake(hints);
+  sync_unlock(hints);
+
+  join(hints);
+  sync_destroy(hints);
+  solver_destroy(hints->solver);
+  board_versions_destroy(hints->versions);
+  free(hints);
+}
+
+bool hints_publish(struct hints *restrict hints, struct board const *restrict board) {
+  if (!hints || !board) return false;
+
+  return board_publish(hints->versions, board);
+}
+
+void hints_request(struct hints *restrict hints) {
+  if (!hints) return;
+
+  sync_lock(hints);
+  hints->requested = board_versions_sequence(hints->versions);
+  sync_wake(hints);
+  sync_unlock(hints);
+}
+
+bool hints_poll(struct hints *restrict hints, struct hint *restrict hint) {
+  if (!hints || !hint) return false;
+
+  uint64_t sequence = board_versions_sequence(hints->versions);
+  for (uint64_t head = hints->head; head != load_index(&hints->tail); head = hints->head) {
+    *hint = hints->results[head % HINT_RESULTS];
+    store_index(&hints->head, head + 1);
+
+    if (hint->sequence == sequence) return true;
+  }
+  return false;
+}
@@ -0,0 +1,149 @@
+#include "latency.h"
+#include "properties.h"
+
+static size_t bucket_of(uint64_t latency) {
+  size_t bucket = 0;
+  while (latency >>= 1) bucket++;
+
+  return bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1;
+}
+
+static void record(struct latency_histogram *restrict histogram, uint64_t latency) {
+  if (!histogram->count || latency < histogram->min) histogram->min = latency;
+  if (latency > histogram->max) histogram->max = latency;
+
+  histogram->count++;
+  histogram->total += latency;
+  histogram->buckets[bucket_of(latency)]++;
+  if (latency <= LATENCY_FRAME) histogram->within_frame++;
+}
+
+void latency_tag(struct latency *restrict latency, struct game const *restrict game, size_t moves, uint64_t read) {
+  if (!latency || !game) return;
+
+  // restarting the game empties its log
+  for (size_t i = moves; i < game->log.size && latency->pending_amount < LATENCY_PENDING; i++) {
+    struct latency_pending *pending = &latency->pending[latency->pending_amount++];
+    *pending = (struct latency_pending){.kind = game->log.moves[i].kind, .read = read};
+  }
+}
+
+void latency_presented(struct latency *restrict latency, uint64_t presented) {
+  if (!latency) return;
+
+  for (size_t i = 0; i < latency->pending_amount; i++) {
+    struct latency_pending const *pending = &latency->pending[i];
+    record(&latency->moves[pending->kind], presented - pending->read);
+  }
+
+  latency->pending_amount = 0;
+}
+
+// the upper bound of the bucket the `percent`th percentile falls into
+static uint64_t percentile(struct latency_histogram const *restrict histogram, size_t percent) {
+  size_t rank = (histogram->count * percent + 99) / 100;
+  size_t seen = 0;
+  for (size_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+    seen += histogram->buckets[bucket];
+    if (seen >= rank) return bucket + 1 < LATENCY_BUCKETS ? (uint64_t)1 << (bucket + 1) : histogram->max;
+  }
+
+  return histogram->max;
+}
+
+static double ms(uint64_t nanoseconds) {
+  return nanoseconds / 1e6;
+}
+
+void latency_report(struct latency const *restrict latency, FILE *restrict out) {
+  if (!latency || !out) return;
+
+  enum local_bar_size {
+    BAR_WIDTH = 50,
+  };
+  char const *names[MOVE_KIND_AMOUNT] = {"reveal", "mark", "chord"};
+
+  for (size_t kind = 0; kind < MOVE_KIND_AMOUNT; kind++) {
+    struct latency_histogram const *histogram = &latency->moves[kind];
+    if (!histogram->count) {
+      fprintf(out, "%s: no moves\n", names[kind]);
+      continue;
+    }
+
+    fprintf(out,
+            "%s: %zu moves, %zu within a frame (%.1fms)\n",
+            names[kind],
+            histogram->count,
+            histogram->within_frame,
+            ms(LATENCY_FRAME));
+    fprintf(out,
+            "  min %.3fms, mean %.3fms, p50 < %.3fms, p99 < %.3fms, max %.3fms\n",
+            ms(histogram->min),
+            ms(histogram->total / histogram->count),
+            ms(percentile(histogram, 50)),
+            ms(percentile(histogram, 99)),
+            ms(histogram->max));
+
+    size_t tallest = 0;
+    for (size_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+      if (histogram->buckets[bucket] > tallest) tallest = histogram->buckets[bucket];
+    }
+
+    for (size_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+      if (!histogram->buckets[bucket]) continue;
+
+      fprintf(out,
+              "  [%9.3fms, %9.3fms) %8zu ",
+              ms((uint64_t)1 << bucket),
+              ms((uint64_t)1 << (bucket + 1)),
+              histogram->buckets[bucket]);
+      for (size_t i = 0; i < (histogram->buckets[bucket] * BAR_WIDTH + tallest - 1) / tallest; i++) fputc('#', out);
+      fputc('\n', out);
+    }
+  }
+}
+
+// splitmix64, the generator the board deals its mines with, so a seed replays the same clicks as it always did
+static size_t random_below(uint64_t *restrict state, size_t bound) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15u);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+  return (size_t)((z ^ (z >> 31)) % bound);
+}
+
+static void push_key(struct input_queue *restrict input, int key, uint64_t now) {
+  input_push(input, (struct input_event){.kind = INPUT_KEY_DOWN, .key = key, .time = now / 1000000});
+  input_push(input, (struct input_event){.kind = INPUT_KEY_UP, .key = key, .time = now / 1000000});
+}
+
+bool latency_script_step(struct latency_script *restrict script,
+                         struct window *restrict window,
+                         struct game const *restrict game,
+                         struct input_queue *restrict input) {
+  if (!script || !window || !game || !input || !script->clicks) return false;
+
+  uint64_t now = game_clock_now();
+  if (game->state != STATE_PLAYING) {
+    push_key(input, TK_F2, now);
+    return true;
+  }
+
+  struct panel *board = window_panel_at(window, PANEL_BOARD);
+  if (!board || !board->components_amount) return false;
+
+  size_t idx = random_below(&script->state, board->components_amount);
+  size_t pick = random_below(&script->state, 10);
+  enum mouse_button button = pick < 7 ? MOUSE_LEFT : pick < 9 ? MOUSE_RIGHT : MOUSE_MIDDLE;
+
+  // the middle of the cell
+  unsigned x = window_x_panel(window, board) + (idx % board->grid.cols) * board->grid.cell_width;
+  unsigned y = window_y_panel(board) + (idx / board->grid.cols) * board->grid.cell_height;
+  x += board->grid.cell_width / 2;
+  y += board->grid.cell_height / 2;
+  struct mouse_event click = mouse_event_create(x, y, button);
+
+  input_push(input, (struct input_event){.kind = INPUT_PRESS, .mouse = click, .time = now / 1000000});
+  input_push(input, (struct input_event){.kind = INPUT_RELEASE, .mouse = click, .time = now / 1000000});
+  script->clicks--;
+  return true;
+}
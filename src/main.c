@@ -1,13 +1,73 @@
-#include <time.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "assets.h"
+#include "bot.h"
 #include "colors.h"
 #include "game.h"
+#include "latency.h"
 #include "mouse_event.h"
+#include "no_guess.h"
 #include "properties.h"
+#include "resources.h"
+#include "snapshot.h"
 #include "util.h"
 #include "window.h"
 
-int main(void) {
+// parses a board dimension given on the command line. returns 0 if it isn't a positive number
+static size_t parse_size(char const *restrict arg) {
+  char *end = NULL;
+  unsigned long long value = strtoull(arg, &end, 10);
+  if (end == arg || *end || arg[0] == '-') return 0;
+
+  return value > SIZE_MAX ? 0 : (size_t)value;
+}
+
+// writes the latency histograms to `path`, or to stdout if it's NULL or "-"
+static void report_latency(struct latency const *restrict latency, char const *restrict path) {
+  bool to_stdout = !path || !strcmp(path, "-");
+  FILE *out = to_stdout ? stdout : fopen(path, "w");
+  if (!out) return;
+
+  latency_report(latency, out);
+  if (!to_stdout) fclose(out);
+}
+
+// starts recording the window if asked to through the environment
+static void start_capture(struct window *restrict window) {
+  char const *prefix = getenv(CAPTURE_ENV);
+  if (!prefix) return;
+
+  char const *format = getenv(CAPTURE_FORMAT_ENV);
+  window_capture(window,
+                 capture_create(prefix,
+                                format && !strcmp(format, "raw") ? CAPTURE_RAW : CAPTURE_PNG,
+                                CAPTURE_LEVEL,
+                                window->window->w,
+                                window->window->h,
+                                CAPTURE_SLOTS));
+}
+
+// plays the commands a bot sends on stdin, drawing every `every` moves as long as there's a window to draw on
+static void serve_bot(struct game *restrict game,
+                      struct window *restrict window,
+                      struct assets_manager *restrict am,
+                      TigrFont *restrict font,
+                      size_t every) {
+  size_t moves = 0;
+  for (enum bot_reply reply; (reply = bot_serve(game, stdin, stdout)) != BOT_QUIT;) {
+    if (!window) continue;
+    if (tigrClosed(window->window)) break;
+
+    if (reply == BOT_STARTED) on_game_replaced(window, game, am, font);
+    if (reply == BOT_MOVED && ++moves % every == 0) draw_window(window, game, am, font);
+  }
+}
+
+// `minesweeper` resumes the saved game (or starts a classic one), `minesweeper <rows> <cols> <mines>` starts a custom
+// one
+int main(int argc, char *argv[]) {
   // font
   TigrFont *font = load_font(FONT_PATH);
   if (!font) {
@@ -16,16 +76,17 @@ int main(void) {
   }
 
   // assets
-  struct assets_manager *am = am_create(ASSET_LOAD_AMOUNT,
-                                        "resources/assets/tile",
-                                        "resources/assets/flag",
-                                        "resources/assets/question",
-                                        "resources/assets/mine",
-                                        "resources/assets/humburger",
-                                        "resources/assets/em_happy",
-                                        "resources/assets/em_sad",
-                                        "resources/assets/em_chad",
-                                        "resources/assets/em_shock");
+  struct assets_manager *am = am_create_with(resource_load,
+                                             ASSET_LOAD_AMOUNT,
+                                             "resources/assets/tile",
+                                             "resources/assets/flag",
+                                             "resources/assets/question",
+                                             "resources/assets/mine",
+                                             "resources/assets/humburger",
+                                             "resources/assets/em_happy",
+                                             "resources/assets/em_sad",
+                                             "resources/assets/em_chad",
+                                             "resources/assets/em_shock");
   if (!am) {
     alert(font, "falied to load game assets");
     goto font_cleanup;
@@ -37,20 +98,53 @@ int main(void) {
     goto assets_cleanup;
   }
 
+  // scripted runs leave the saved game alone
+  char const *clicks = getenv(SCRIPT_ENV);
+  struct latency_script script = {.clicks = clicks ? parse_size(clicks) : 0, .state = SCRIPT_SEED};
+  bool scripted = script.clicks;
+  char const *bot = getenv(BOT_ENV);
+  char const *cache = getenv(NO_GUESS_ENV);
+  struct no_guess *no_guess = NULL;
+
   // game
-  struct game game = game_create(MS_CLASSIC);
+  struct game game = argc == 4 ? game_create_custom(parse_size(argv[1]), parse_size(argv[2]), parse_size(argv[3]))
+                     : scripted || bot ? game_create(MS_CLASSIC)
+                                : snapshot_load(SNAPSHOT_PATH);
+  if (argc != 4 && game.state == STATE_INVALID) game = game_create(MS_CLASSIC);
   if (game.state == STATE_INVALID) {
     alert(font, "failed to create a new game");
     goto assets_cleanup;
   }
 
+  // scripted runs play the boards their seed deals. a game resumed with moves made keeps its board
+  if (cache && !scripted && (no_guess = no_guess_create(*cache ? cache : NULL))) {
+    game.no_guess = no_guess;
+    if (!game.board.revealed_cells) game = game_reset(&game);
+    if (game.state == STATE_INVALID) {
+      alert(font, "failed to create a new game");
+      goto game_cleanup;
+    }
+  }
+
+  // a bot without anyone watching doesn't need a window
+  if (bot) {
+    size_t every = parse_size(bot);
+    struct window *window = every ? create_window(&game, am, font) : NULL;
+    serve_bot(&game, window, am, font, every);
+    window_destroy(window, am);
+    goto game_cleanup;
+  }
+
   // window
   struct window *window = create_window(&game, am, font);
   if (!window) {
     alert(font, "falied to create game window");
     goto game_cleanup;
   }
+  start_capture(window);
 
+  struct input_queue input = {0};
+  struct latency latency = {0};
   while (!tigrClosed(window->window)) {
     int x = 0;
     int y = 0;
@@ -64,27 +158,53 @@ int main(void) {
       case STATE_INVALID:
         alert(font, "an unexpected error occurred");
         goto cleanup;
-      case STATE_PLAYING:
-        game.clock.end = time(NULL);  // update the clock
-        break;
-      case STATE_WON:
-      case STATE_LOST:  // fallthrough
-        reveal_mines(&game.board);
-      default:  // fallthrough
+      default:
         break;
     }
 
+    if (scripted && !latency_script_step(&script, window, &game, &input)) break;
+
+    // every press and release since the last frame, in order. the moves they make are timed until they're on screen
+    input_poll(&input, window->window);
+    for (struct input_event event; input_next(&input, &event);) {
+      uint64_t read = game_clock_now();
+      size_t moves = game.log.size;
+
+      on_input(window, &game, am, font, &event);
+      latency_tag(&latency, &game, moves, read);
+    }
     on_mouse_hover(window, &game, am, font, mouse_event);
-    on_mouse_click(window, &game, am, font, mouse_event);
-    game.prev_buttons = mouse_event.button;
+
+    // the clock stands still while the menu is open and once the game is over
+    struct panel const *menu = window_panel_at(window, PANEL_MENU);
+    if (game.state != STATE_PLAYING || (menu && menu->visible)) {
+      game_pause(&game);
+    } else {
+      game_resume(&game);
+    }
 
     draw_window(window, &game, am, font);
+    latency_presented(&latency, game_clock_now());
+  }
+
+  char const *report = getenv(LATENCY_ENV);
+  if (scripted || report) report_latency(&latency, report);
+
+  // save the game in progress, there's nothing to resume once it's over. nor in a scripted game
+  if (!scripted) {
+    if (game.state == STATE_PLAYING) {
+      snapshot_save(&game, SNAPSHOT_PATH);
+    } else {
+      remove(SNAPSHOT_PATH);
+    }
   }
 
 cleanup:
-  window_destroy(window);
+  destroy_hints();
+  window_destroy(window, am);
 game_cleanup:
   game_destroy(&game);
+  no_guess_destroy(no_guess);
 assets_cleanup:
   am_destroy(am);
 font_cleanup:
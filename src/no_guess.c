@@ -0,0 +1,550 @@
+#include "no_guess.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "board.h"
+#include "solver.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+enum no_guess_local_size {
+  NO_GUESS_WORKERS = 8,     // at most, whatever the amount of processors
+  NO_GUESS_SHELVES = 8,     // board sizes kept at once, the one dealt from least recently makes room
+  NO_GUESS_SEEDS = 8,       // per shelf
+  NO_GUESS_TRIES = 4096,    // seeds failing in a row past which a size is given up on
+  NO_GUESS_PATIENCE = 100,  // milliseconds a deal waits for an empty shelf before the board is dealt at random
+};
+
+#ifdef _WIN32
+typedef CONDITION_VARIABLE no_guess_cond;
+#else
+typedef pthread_cond_t no_guess_cond;
+#endif
+
+struct shelf {
+  size_t rows;
+  size_t cols;
+  size_t mines;
+
+  uint64_t seeds[NO_GUESS_SEEDS];
+  size_t amount;
+
+  uint64_t dealt;  // when a seed was last dealt from it, see `deals`
+  size_t waiting;  // deals waiting for a seed
+  size_t tried;    // seeds failed since the last one passed
+  bool hopeless;   // past `NO_GUESS_TRIES`, nothing is searched nor dealt for it anymore
+
+  // bumped once the searches in flight for the shelf are of no use anymore, written under `lock` but read without
+  uint64_t round;
+};
+
+// a worker and what it keeps from a seed to the next
+struct searcher {
+  struct no_guess *no_guess;
+  struct board board;
+  bool created;  // whether `board` is
+  struct solver *solver;
+
+#ifdef _WIN32
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+};
+
+struct no_guess {
+#ifdef _WIN32
+  CRITICAL_SECTION lock;
+#else
+  pthread_mutex_t lock;
+#endif
+  no_guess_cond work;   // the workers wait on it for a shelf to fill
+  no_guess_cond found;  // the deals wait on it for a seed
+
+  char *path;  // owned, NULL if the shelves aren't kept
+
+  // guarded by `lock`
+  uint64_t base;  // the seeds are tried from it on, one after the other
+  uint64_t deals;
+  bool stopping;
+  struct shelf shelves[NO_GUESS_SHELVES];
+  size_t shelves_amount;
+
+  size_t searchers_amount;
+  struct searcher searchers[NO_GUESS_WORKERS];
+};
+
+#ifdef _WIN32
+static bool sync_init(struct no_guess *restrict no_guess) {
+  InitializeCriticalSection(&no_guess->lock);
+  InitializeConditionVariable(&no_guess->work);
+  InitializeConditionVariable(&no_guess->found);
+  return true;
+}
+
+static void sync_destroy(struct no_guess *restrict no_guess) {
+  DeleteCriticalSection(&no_guess->lock);
+}
+
+static void sync_lock(struct no_guess *restrict no_guess) {
+  EnterCriticalSection(&no_guess->lock);
+}
+
+static void sync_unlock(struct no_guess *restrict no_guess) {
+  LeaveCriticalSection(&no_guess->lock);
+}
+
+static void sync_wait(struct no_guess *restrict no_guess, no_guess_cond *restrict cond) {
+  SleepConditionVariableCS(cond, &no_guess->lock, INFINITE);
+}
+
+// milliseconds on the clock `sync_wait_until` waits against
+static uint64_t clock_ms(void) {
+  return GetTickCount64();
+}
+
+// false once `deadline` has passed, see `clock_ms`
+static bool sync_wait_until(struct no_guess *restrict no_guess, no_guess_cond *restrict cond, uint64_t deadline) {
+  uint64_t now = clock_ms();
+  if (now >= deadline) return false;
+
+  SleepConditionVariableCS(cond, &no_guess->lock, (DWORD)(deadline - now));
+  return true;
+}
+
+static void sync_wake_all(no_guess_cond *restrict cond) {
+  WakeAllConditionVariable(cond);
+}
+
+static uint64_t load_round(uint64_t volatile *round) {
+  return (uint64_t)InterlockedCompareExchange64((LONG64 volatile *)round, 0, 0);
+}
+
+static void store_round(uint64_t volatile *round, uint64_t value) {
+  InterlockedExchange64((LONG64 volatile *)round, (LONG64)value);
+}
+
+static size_t processors(void) {
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors;
+}
+#else
+static bool sync_init(struct no_guess *restrict no_guess) {
+  if (pthread_mutex_init(&no_guess->lock, NULL)) return false;
+  if (pthread_cond_init(&no_guess->work, NULL)) goto lock_cleanup;
+  if (pthread_cond_init(&no_guess->found, NULL)) goto work_cleanup;
+
+  return true;
+
+work_cleanup:
+  pthread_cond_destroy(&no_guess->work);
+lock_cleanup:
+  pthread_mutex_destroy(&no_guess->lock);
+  return false;
+}
+
+static void sync_destroy(struct no_guess *restrict no_guess) {
+  pthread_cond_destroy(&no_guess->found);
+  pthread_cond_destroy(&no_guess->work);
+  pthread_mutex_destroy(&no_guess->lock);
+}
+
+static void sync_lock(struct no_guess *restrict no_guess) {
+  pthread_mutex_lock(&no_guess->lock);
+}
+
+static void sync_unlock(struct no_guess *restrict no_guess) {
+  pthread_mutex_unlock(&no_guess->lock);
+}
+
+static void sync_wait(struct no_guess *restrict no_guess, no_guess_cond *restrict cond) {
+  pthread_cond_wait(cond, &no_guess->lock);
+}
+
+// milliseconds on the clock `sync_wait_until` waits against, the realtime one condition variables default to
+static uint64_t clock_ms(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+// false once `deadline` has passed, see `clock_ms`
+static bool sync_wait_until(struct no_guess *restrict no_guess, no_guess_cond *restrict cond, uint64_t deadline) {
+  struct timespec until = {.tv_sec = (time_t)(deadline / 1000), .tv_nsec = (long)(deadline % 1000) * 1000000};
+  return pthread_cond_timedwait(cond, &no_guess->lock, &until) != ETIMEDOUT;
+}
+
+static void sync_wake_all(no_guess_cond *restrict cond) {
+  pthread_cond_broadcast(cond);
+}
+
+static uint64_t load_round(uint64_t volatile *round) {
+  return __atomic_load_n(round, __ATOMIC_RELAXED);
+}
+
+static void store_round(uint64_t volatile *round, uint64_t value) {
+  __atomic_store_n(round, value, __ATOMIC_RELAXED);
+}
+
+static size_t processors(void) {
+  long amount = sysconf(_SC_NPROCESSORS_ONLN);
+  return amount > 0 ? (size_t)amount : 1;
+}
+#endif
+
+static struct shelf *find_shelf(struct no_guess *restrict no_guess, size_t rows, size_t cols, size_t mines) {
+  for (size_t i = 0; i < no_guess->shelves_amount; i++) {
+    struct shelf *shelf = &no_guess->shelves[i];
+    if (shelf->rows == rows && shelf->cols == cols && shelf->mines == mines) return shelf;
+  }
+  return NULL;
+}
+
+// the shelf for that size, put up in place of the one dealt from least recently that nobody waits on if there's no room
+// left. NULL if every shelf is waited on
+static struct shelf *add_shelf(struct no_guess *restrict no_guess, size_t rows, size_t cols, size_t mines) {
+  struct shelf *shelf = find_shelf(no_guess, rows, cols, mines);
+  if (shelf) return shelf;
+
+  if (no_guess->shelves_amount < NO_GUESS_SHELVES) {
+    shelf = &no_guess->shelves[no_guess->shelves_amount++];
+  } else {
+    for (size_t i = 0; i < NO_GUESS_SHELVES; i++) {
+      struct shelf *other = &no_guess->shelves[i];
+      if (!other->waiting && (!shelf || other->dealt < shelf->dealt)) shelf = other;
+    }
+    if (!shelf) return NULL;
+  }
+
+  shelf->rows = rows;
+  shelf->cols = cols;
+  shelf->mines = mines;
+  shelf->amount = 0;
+  shelf->dealt = 0;
+  shelf->waiting = 0;
+  shelf->tried = 0;
+  shelf->hopeless = false;
+
+  // searches still in flight for the shelf replaced are cancelled. they read its round meanwhile, so it's only ever
+  // written through `store_round`
+  store_round(&shelf->round, shelf->round + 1);
+  return shelf;
+}
+
+// a shelf waited on first, or else one with room left
+static struct shelf *pick_shelf(struct no_guess *restrict no_guess) {
+  struct shelf *pick = NULL;
+  for (size_t i = 0; i < no_guess->shelves_amount; i++) {
+    struct shelf *shelf = &no_guess->shelves[i];
+    if (shelf->hopeless || shelf->amount == NO_GUESS_SEEDS) continue;
+
+    if (shelf->waiting) return shelf;
+    if (!pick) pick = shelf;
+  }
+  return pick;
+}
+
+// what a seed's search is cancelled by
+struct job {
+  struct shelf *shelf;
+  uint64_t round;
+};
+
+// the shelf filled up or was replaced, or the generator is closing
+static bool superseded(void *job) {
+  struct job const *current = job;
+  return load_round(&current->shelf->round) != current->round;
+}
+
+// whether the seed deals a board that can be cleared without a guess
+static bool clears(struct searcher *restrict searcher,
+                   size_t rows,
+                   size_t cols,
+                   size_t mines,
+                   uint64_t seed,
+                   struct job *restrict job) {
+  struct board *board = &searcher->board;
+  if (searcher->created && (board_rows(board) != rows || board_cols(board) != cols || board_mines(board) != mines)) {
+    board_destroy(board);
+    searcher->created = false;
+  }
+  if (!searcher->created && !(searcher->created = board_create_custom(board, rows, cols, mines))) return false;
+  if (!board_reset_seeded(board, seed)) return false;
+
+  // the start cell opens a region of its own, the solver takes it from there
+  size_t row = 0;
+  size_t col = 0;
+  no_guess_start(rows, cols, &row, &col);
+  struct cell start = board_cell(board, row, col);
+  if (start.mine || start.adjacent_mines) return false;
+
+  return solver_clears(searcher->solver, board, row, col, superseded, job);
+}
+
+// the worker. tries seeds for the shelves until `stopping` is set
+static void search(struct searcher *restrict searcher) {
+  struct no_guess *no_guess = searcher->no_guess;
+
+  sync_lock(no_guess);
+  for (;;) {
+    struct shelf *shelf = NULL;
+    while (!no_guess->stopping && !(shelf = pick_shelf(no_guess))) sync_wait(no_guess, &no_guess->work);
+    if (no_guess->stopping) break;
+
+    size_t rows = shelf->rows;
+    size_t cols = shelf->cols;
+    size_t mines = shelf->mines;
+    uint64_t seed = no_guess->base++;
+    struct job job = {.shelf = shelf, .round = shelf->round};
+    sync_unlock(no_guess);
+
+    bool passed = clears(searcher, rows, cols, mines, seed, &job);
+
+    sync_lock(no_guess);
+    if (superseded(&job)) continue;
+
+    if (passed) {
+      shelf->seeds[shelf->amount++] = seed;
+      shelf->tried = 0;
+      sync_wake_all(&no_guess->found);
+
+      // the other searches for the shelf have nowhere left to go
+      if (shelf->amount == NO_GUESS_SEEDS) store_round(&shelf->round, shelf->round + 1);
+    } else if (++shelf->tried == NO_GUESS_TRIES) {
+      shelf->hopeless = true;
+      sync_wake_all(&no_guess->found);
+    }
+  }
+  sync_unlock(no_guess);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker(LPVOID searcher) {
+  search(searcher);
+  return 0;
+}
+
+static bool start(struct searcher *restrict searcher) {
+  searcher->thread = CreateThread(NULL, 0, worker, searcher, 0, NULL);
+  return searcher->thread != NULL;
+}
+
+static void join(struct searcher *restrict searcher) {
+  WaitForSingleObject(searcher->thread, INFINITE);
+  CloseHandle(searcher->thread);
+}
+#else
+static void *worker(void *searcher) {
+  search(searcher);
+  return NULL;
+}
+
+static bool start(struct searcher *restrict searcher) {
+  return !pthread_create(&searcher->thread, NULL, worker, searcher);
+}
+
+static void join(struct searcher *restrict searcher) {
+  pthread_join(searcher->thread, NULL);
+}
+#endif
+
+// fills the shelves from the file at `path`. an invalid file leaves them empty
+static void load_shelves(struct no_guess *restrict no_guess, char const *restrict path) {
+  FILE *file = fopen(path, "rb");
+  if (!file) return;
+
+  unsigned char *buf = NULL;
+  if (fseek(file, 0, SEEK_END)) goto close;
+
+  long size = ftell(file);
+  if (size < (long)sizeof(struct no_guess_header) || fseek(file, 0, SEEK_SET)) goto close;
+
+  buf = malloc(size);
+  if (!buf || fread(buf, size, 1, file) != 1) goto close;
+
+  struct no_guess_header header;
+  memcpy(&header, buf, sizeof header);
+  if (memcmp(header.magic, NO_GUESS_MAGIC, sizeof header.magic) || header.version != NO_GUESS_VERSION) goto close;
+  if (header.amount > (uint64_t)size || (size_t)size - sizeof header != header.amount * sizeof(struct no_guess_entry)) {
+    goto close;
+  }
+
+  for (uint64_t i = 0; i < header.amount; i++) {
+    struct no_guess_entry entry;
+    memcpy(&entry, buf + sizeof header + i * sizeof entry, sizeof entry);
+    if ((size_t)entry.rows != entry.rows || (size_t)entry.cols != entry.cols || (size_t)entry.mines != entry.mines) {
+      continue;
+    }
+    if (!no_guess_fits(entry.rows, entry.cols)) continue;
+
+    struct shelf *shelf = find_shelf(no_guess, entry.rows, entry.cols, entry.mines);
+    if (!shelf && no_guess->shelves_amount < NO_GUESS_SHELVES) {
+      shelf = add_shelf(no_guess, entry.rows, entry.cols, entry.mines);
+    }
+    if (shelf && shelf->amount < NO_GUESS_SEEDS) shelf->seeds[shelf->amount++] = entry.seed;
+  }
+
+close:
+  free(buf);
+  fclose(file);
+}
+
+// writes the shelves to the file at `path` with a single write
+static bool save_shelves(struct no_guess const *restrict no_guess, char const *restrict path) {
+  struct no_guess_header header = {.version = NO_GUESS_VERSION};
+  memcpy(header.magic, NO_GUESS_MAGIC, sizeof header.magic);
+  for (size_t i = 0; i < no_guess->shelves_amount; i++) header.amount += no_guess->shelves[i].amount;
+
+  size_t size = sizeof header + header.amount * sizeof(struct no_guess_entry);
+  unsigned char *buf = malloc(size);
+  if (!buf) return false;
+
+  memcpy(buf, &header, sizeof header);
+  unsigned char *next = buf + sizeof header;
+  for (size_t i = 0; i < no_guess->shelves_amount; i++) {
+    struct shelf const *shelf = &no_guess->shelves[i];
+    for (size_t j = 0; j < shelf->amount; j++) {
+      struct no_guess_entry entry = {
+        .rows = shelf->rows, .cols = shelf->cols, .mines = shelf->mines, .seed = shelf->seeds[j]};
+      memcpy(next, &entry, sizeof entry);
+      next += sizeof entry;
+    }
+  }
+
+  bool saved = false;
+  FILE *file = fopen(path, "wb");
+  if (!file) goto cleanup;
+
+  saved = fwrite(buf, size, 1, file) == 1;
+  saved = !fclose(file) && saved;
+
+cleanup:
+  free(buf);
+  return saved;
+}
+
+// stops the workers started so far and frees what they kept
+static void stop(struct no_guess *restrict no_guess) {
+  sync_lock(no_guess);
+  no_guess->stopping = true;
+  for (size_t i = 0; i < no_guess->shelves_amount; i++) {
+    store_round(&no_guess->shelves[i].round, no_guess->shelves[i].round + 1);
+  }
+  sync_wake_all(&no_guess->work);
+  sync_wake_all(&no_guess->found);
+  sync_unlock(no_guess);
+
+  for (size_t i = 0; i < no_guess->searchers_amount; i++) {
+    struct searcher *searcher = &no_guess->searchers[i];
+    join(searcher);
+    solver_destroy(searcher->solver);
+    if (searcher->created) board_destroy(&searcher->board);
+  }
+  no_guess->searchers_amount = 0;
+}
+
+struct no_guess *no_guess_create(char const *restrict path) {
+  struct no_guess *no_guess = calloc(1, sizeof *no_guess);
+  if (!no_guess) return NULL;
+
+  if (path) {
+    no_guess->path = malloc(strlen(path) + 1);
+    if (!no_guess->path) goto no_guess_cleanup;
+
+    strcpy(no_guess->path, path);
+    load_shelves(no_guess, path);
+  }
+
+  // a different run of seeds every run
+  no_guess->base = (uint64_t)time(NULL) << 32 ^ (uint64_t)clock();
+
+  if (!sync_init(no_guess)) goto path_cleanup;
+
+  size_t workers = processors() < NO_GUESS_WORKERS ? processors() : NO_GUESS_WORKERS;
+  while (no_guess->searchers_amount < workers) {
+    struct searcher *searcher = &no_guess->searchers[no_guess->searchers_amount];
+    searcher->no_guess = no_guess;
+    searcher->solver = solver_create();
+    if (!searcher->solver) break;
+
+    if (!start(searcher)) {
+      solver_destroy(searcher->solver);
+      break;
+    }
+    no_guess->searchers_amount++;
+  }
+  if (!no_guess->searchers_amount) goto sync_cleanup;
+
+  return no_guess;
+
+sync_cleanup:
+  sync_destroy(no_guess);
+path_cleanup:
+  free(no_guess->path);
+no_guess_cleanup:
+  free(no_guess);
+  return NULL;
+}
+
+void no_guess_destroy(struct no_guess *restrict no_guess) {
+  if (!no_guess) return;
+
+  stop(no_guess);
+  if (no_guess->path) save_shelves(no_guess, no_guess->path);
+
+  sync_destroy(no_guess);
+  free(no_guess->path);
+  free(no_guess);
+}
+
+bool no_guess_deal(struct no_guess *restrict no_guess,
+                   size_t rows,
+                   size_t cols,
+                   size_t mines,
+                   uint64_t *restrict seed) {
+  if (!no_guess || !seed || !no_guess_fits(rows, cols)) return false;
+
+  sync_lock(no_guess);
+  struct shelf *shelf = add_shelf(no_guess, rows, cols, mines);
+  if (!shelf) {
+    sync_unlock(no_guess);
+    return false;
+  }
+
+  // past its patience the deal leaves the shelf to fill in the background, for the next one
+  uint64_t deadline = clock_ms() + NO_GUESS_PATIENCE;
+  shelf->waiting++;
+  sync_wake_all(&no_guess->work);
+  while (!shelf->amount && !shelf->hopeless && !no_guess->stopping) {
+    if (!sync_wait_until(no_guess, &no_guess->found, deadline)) break;
+  }
+  shelf->waiting--;
+  shelf->dealt = ++no_guess->deals;
+
+  bool dealt = shelf->amount;
+  if (dealt) {
+    *seed = shelf->seeds[--shelf->amount];
+
+    // the workers refill the shelf meanwhile
+    sync_wake_all(&no_guess->work);
+  }
+  sync_unlock(no_guess);
+  return dealt;
+}
+
+bool no_guess_fits(size_t rows, size_t cols) {
+  return rows && cols && rows <= NO_GUESS_CELLS / cols;
+}
+
+void no_guess_start(size_t rows, size_t cols, size_t *restrict row, size_t *restrict col) {
+  if (row) *row = rows / 2;
+  if (col) *col = cols / 2;
+}
@@ -0,0 +1,56 @@
+#include "resources.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef BUNDLE_RESOURCES
+#include "bundle.h"
+
+static Tigr *bundle_bitmap(struct bundle_entry const *restrict entry) {
+  Tigr *bmp = tigrBitmap(entry->w, entry->h);
+  if (!bmp) return NULL;
+
+  memcpy(bmp->pix, entry->pixels, sizeof *bmp->pix * entry->w * entry->h);
+  return bmp;
+}
+
+static Tigr *bundle_load(char const *restrict path) {
+  for (size_t i = 0; i < bundle_entries_amount; i++) {
+    if (!strcmp(bundle_entries[i].path, path)) return bundle_bitmap(&bundle_entries[i]);
+  }
+
+  return NULL;
+}
+#endif
+
+static Tigr *override_load(char const *restrict path) {
+  char const *dir = getenv(RESOURCES_ENV);
+  if (!dir || !*dir) return NULL;
+
+  size_t prefix_len = strlen(RESOURCES_PREFIX);
+  if (!strncmp(path, RESOURCES_PREFIX, prefix_len)) path += prefix_len;
+
+  enum local_str_size {
+    SIZE = 4096,
+  };
+  char override_path[SIZE];
+
+  int written = snprintf(override_path, sizeof override_path, "%s/%s", dir, path);
+  if (written < 0 || written >= (int)sizeof override_path) return NULL;
+
+  return tigrLoadImage(override_path);
+}
+
+Tigr *resource_load(char const *path) {
+  if (!path) return NULL;
+
+  Tigr *bmp = override_load(path);
+  if (bmp) return bmp;
+
+#ifdef BUNDLE_RESOURCES
+  bmp = bundle_load(path);
+  if (bmp) return bmp;
+#endif
+
+  return tigrLoadImage(path);
+}
@@ -0,0 +1,449 @@
+// `minesweeper-server [socket]` hosts a game per connection for bots, see server.h for the protocol
+#define _GNU_SOURCE
+#include "server.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "game.h"
+
+static enum move_kind const kinds[] = {
+    [SERVER_OPEN] = MOVE_REVEAL,
+    [SERVER_FLAG] = MOVE_MARK,
+    [SERVER_CHORD] = MOVE_CHORD,
+};
+
+enum server_local_size {
+  EVENTS = 256,           // handled per wait
+  READ_SIZE = 64 * 1024,  // read at once, so pipelined requests are handled in batches
+  OUT_CAPACITY = 256,     // a connection's first output buffer
+  SLAB_CAPACITY = 64,     // the slab's first allocation
+  LISTENER = UINT32_MAX,  // the epoll data of the listening socket, connections have their slot's index
+};
+
+struct connection {
+  int fd;  // -1 while the slot is free
+  uint32_t next_free;
+  bool writing;  // the socket didn't take the whole output, it's waited on for writing rather than reading
+
+  struct game game;
+  unsigned char *shown;  // the `enum server_cell` the client was last sent for every cell
+  size_t shown_capacity;
+
+  // the start of a request split across reads
+  unsigned char partial[sizeof(struct server_request)];
+  size_t partial_size;
+
+  unsigned char *out;
+  size_t out_size;
+  size_t out_sent;
+  size_t out_capacity;
+};
+
+// the connections live in a single array, reused through a free list. they're referred to by index since growing the
+// slab moves them
+struct slab {
+  struct connection *connections;
+  uint32_t capacity;
+  uint32_t free;  // the first free slot, `capacity` if there's none
+};
+
+struct server_stats {
+  size_t connections;
+  size_t games;
+  size_t moves;
+};
+
+struct server {
+  int epoll;
+  int listener;
+  struct slab slab;
+  struct server_stats stats;
+  unsigned char in[READ_SIZE];
+};
+
+static volatile sig_atomic_t stopping = 0;
+
+static void stop(int signal) {
+  (void)signal;
+  stopping = 1;
+}
+
+static uint32_t slab_take(struct slab *restrict slab) {
+  if (slab->free == slab->capacity) {
+    uint32_t capacity = slab->capacity ? slab->capacity * 2 : SLAB_CAPACITY;
+    if (capacity <= slab->capacity || capacity == LISTENER) return LISTENER;
+
+    struct connection *connections = realloc(slab->connections, capacity * sizeof *connections);
+    if (!connections) return LISTENER;
+
+    for (uint32_t i = slab->capacity; i < capacity; i++) {
+      connections[i] = (struct connection){.fd = -1, .next_free = i + 1};
+    }
+    slab->connections = connections;
+    slab->free = slab->capacity;
+    slab->capacity = capacity;
+  }
+
+  uint32_t index = slab->free;
+  slab->free = slab->connections[index].next_free;
+  return index;
+}
+
+static void slab_give(struct slab *restrict slab, uint32_t index) {
+  slab->connections[index] = (struct connection){.fd = -1, .next_free = slab->free};
+  slab->free = index;
+}
+
+static enum server_cell cell_code(struct cell cell) {
+  if (cell.revealed) return cell.mine ? SERVER_CELL_MINE : SERVER_CELL_ZERO + cell.adjacent_mines;
+
+  switch (cell.mark) {
+    case MARK_MINE:
+      return SERVER_CELL_FLAG;
+    case MARK_QUESTION:
+      return SERVER_CELL_QUESTION;
+    default:
+      return SERVER_CELL_HIDDEN;
+  }
+}
+
+static bool reserve(struct connection *restrict connection, size_t size) {
+  if (connection->out_capacity - connection->out_size >= size) return true;
+
+  size_t capacity = connection->out_capacity ? connection->out_capacity : OUT_CAPACITY;
+  while (capacity - connection->out_size < size) capacity *= 2;
+
+  unsigned char *out = realloc(connection->out, capacity);
+  if (!out) return false;
+
+  connection->out = out;
+  connection->out_capacity = capacity;
+  return true;
+}
+
+// hides every cell of a new game from the client
+static bool hide_cells(struct connection *restrict connection) {
+  struct board const *board = &connection->game.board;
+  size_t cells = board_rows(board) * board_cols(board);
+
+  if (cells > connection->shown_capacity) {
+    unsigned char *shown = realloc(connection->shown, cells);
+    if (!shown) return false;
+
+    connection->shown = shown;
+    connection->shown_capacity = cells;
+  }
+
+  memset(connection->shown, SERVER_CELL_HIDDEN, cells);
+  return true;
+}
+
+// appends an update for the cell at `index` if it changed since the client was last told. returns false if the output
+// couldn't grow
+static bool update_cell(struct connection *restrict connection,
+                        size_t index,
+                        struct cell cell,
+                        uint32_t *restrict cells) {
+  enum server_cell code = cell_code(cell);
+  if (connection->shown[index] == code) return true;
+  if (!reserve(connection, sizeof(uint32_t))) return false;
+
+  uint32_t update = (uint32_t)index << SERVER_CODE_BITS | code;
+  memcpy(connection->out + connection->out_size, &update, sizeof update);
+  connection->out_size += sizeof update;
+  connection->shown[index] = code;
+  (*cells)++;
+  return true;
+}
+
+// updates the cells the last move changed. when the board's changes are stale every cell is compared against what
+// the client was last told instead
+static bool update_board(struct connection *restrict connection, uint32_t *restrict cells) {
+  struct board const *board = &connection->game.board;
+  struct board_delta const *delta = board_changes(board);
+
+  if (!delta->stale) {
+    for (size_t i = 0; i < delta->size; i++) {
+      if (!update_cell(connection, delta->changes[i].index, delta->changes[i].cell, cells)) return false;
+    }
+    return true;
+  }
+
+  for (size_t row = 0; row < board_rows(board); row++) {
+    for (size_t col = 0; col < board_cols(board); col++) {
+      if (!update_cell(connection, row * board_cols(board) + col, board_cell(board, row, col), cells)) return false;
+    }
+  }
+  return true;
+}
+
+// starts over on a board of the same size, or of the requested one. returns false if the game is lost for good
+static bool start_over(struct connection *restrict connection,
+                       struct server_request const *restrict request,
+                       enum server_status *restrict status) {
+  struct game *game = &connection->game;
+  size_t rows = request->args[0];
+  size_t cols = request->args[1];
+  size_t mines = request->args[2];
+
+  struct board const *board = &game->board;
+  bool same = rows == board_rows(board) && cols == board_cols(board) && mines == board_mines(board);
+  if (same || (!rows && !cols && !mines)) {
+    *game = game_reset(game);
+  } else {
+    // the current game goes on if the new one can't be created
+    struct game custom = rows && cols <= SERVER_MAX_CELLS / rows ? game_create_custom(rows, cols, mines)
+                                                                 : (struct game){.state = STATE_INVALID};
+    if (custom.state == STATE_INVALID) {
+      game_destroy(&custom);
+      *status = SERVER_ERROR;
+      return true;
+    }
+
+    game_destroy(game);
+    *game = custom;
+  }
+
+  return game->state != STATE_INVALID && hide_cells(connection);
+}
+
+// appends the response to `request`. returns false if the connection has to be closed
+static bool handle(struct server *restrict server,
+                   struct connection *restrict connection,
+                   struct server_request const *restrict request) {
+  if (!reserve(connection, sizeof(struct server_response))) return false;
+
+  // the header is filled in once the updates following it are counted
+  size_t header = connection->out_size;
+  connection->out_size += sizeof(struct server_response);
+
+  struct game *game = &connection->game;
+  enum server_status status = SERVER_OK;
+  uint32_t cells = 0;
+
+  switch (request->op) {
+    case SERVER_OPEN:
+    case SERVER_FLAG:
+    case SERVER_CHORD: {
+      struct game_action action = {.kind = kinds[request->op], .row = request->args[0], .col = request->args[1]};
+      if (!game_step(game, action)) {
+        status = SERVER_IGNORED;
+        break;
+      }
+      server->stats.moves++;
+
+      if (!update_board(connection, &cells)) return false;
+      break;
+    }
+    case SERVER_NEW:
+      if (!start_over(connection, request, &status)) return false;
+      if (status == SERVER_OK) server->stats.games++;
+      break;
+    default:
+      status = SERVER_ERROR;
+      break;
+  }
+
+  struct server_response response = {.status = status,
+                                     .state = game->state,
+                                     .mines = game->mines,
+                                     .rows = board_rows(&game->board),
+                                     .cols = board_cols(&game->board),
+                                     .cells = cells};
+  memcpy(connection->out + header, &response, sizeof response);
+  return true;
+}
+
+static bool watch(struct server *restrict server, uint32_t index, bool writing) {
+  struct connection *connection = &server->slab.connections[index];
+  if (connection->writing == writing) return true;
+
+  struct epoll_event event = {.events = writing ? EPOLLOUT : EPOLLIN, .data.u32 = index};
+  if (epoll_ctl(server->epoll, EPOLL_CTL_MOD, connection->fd, &event)) return false;
+
+  connection->writing = writing;
+  return true;
+}
+
+// sends as much of the output as the socket takes. the connection stops reading until the rest of it is sent, which
+// keeps a client that doesn't read its responses from growing the output without bound
+static bool flush(struct server *restrict server, uint32_t index) {
+  struct connection *connection = &server->slab.connections[index];
+
+  while (connection->out_sent < connection->out_size) {
+    ssize_t sent = send(connection->fd,
+                        connection->out + connection->out_sent,
+                        connection->out_size - connection->out_sent,
+                        MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR) continue;
+    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return watch(server, index, true);
+    if (sent < 0) return false;
+
+    connection->out_sent += (size_t)sent;
+  }
+
+  connection->out_size = 0;
+  connection->out_sent = 0;
+  return watch(server, index, false);
+}
+
+// handles every whole request a read brings in. returns false if the connection has to be closed
+static bool serve(struct server *restrict server, uint32_t index) {
+  struct connection *connection = &server->slab.connections[index];
+
+  memcpy(server->in, connection->partial, connection->partial_size);
+  ssize_t got = recv(connection->fd, server->in + connection->partial_size, READ_SIZE - connection->partial_size, 0);
+  if (got < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  if (!got) return false;
+
+  size_t size = connection->partial_size + (size_t)got;
+  size_t at = 0;
+  for (; size - at >= sizeof(struct server_request); at += sizeof(struct server_request)) {
+    struct server_request request;
+    memcpy(&request, server->in + at, sizeof request);
+    if (!handle(server, connection, &request)) return false;
+  }
+
+  connection->partial_size = size - at;
+  memcpy(connection->partial, server->in + at, connection->partial_size);
+  return flush(server, index);
+}
+
+static void disconnect(struct server *restrict server, uint32_t index) {
+  struct connection *connection = &server->slab.connections[index];
+
+  close(connection->fd);
+  game_destroy(&connection->game);
+  free(connection->shown);
+  free(connection->out);
+  slab_give(&server->slab, index);
+}
+
+// every connection starts with a classic game
+static bool connect_to(struct server *restrict server, int fd) {
+  uint32_t index = slab_take(&server->slab);
+  if (index == LISTENER) {
+    close(fd);
+    return false;
+  }
+
+  struct connection *connection = &server->slab.connections[index];
+  connection->fd = fd;
+  connection->game = game_create(MS_CLASSIC);
+  if (connection->game.state == STATE_INVALID || !hide_cells(connection)) goto connection_cleanup;
+
+  struct epoll_event event = {.events = EPOLLIN, .data.u32 = index};
+  if (epoll_ctl(server->epoll, EPOLL_CTL_ADD, fd, &event)) goto connection_cleanup;
+
+  server->stats.connections++;
+  server->stats.games++;
+  return true;
+
+connection_cleanup:
+  disconnect(server, index);
+  return false;
+}
+
+static void accept_all(struct server *restrict server) {
+  for (;;) {
+    int fd = accept4(server->listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+
+    connect_to(server, fd);
+  }
+}
+
+static int listen_at(char const *restrict path) {
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  if (strlen(path) >= sizeof address.sun_path) return -1;
+  strcpy(address.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+
+  // a socket left behind by a previous run
+  unlink(path);
+  if (bind(fd, (struct sockaddr *)&address, sizeof address) || listen(fd, SOMAXCONN)) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int main(int argc, char *argv[]) {
+  char const *path = argc > 1 ? argv[1] : SERVER_SOCKET;
+  int status = EXIT_FAILURE;
+
+  struct server *server = calloc(1, sizeof *server);
+  if (!server) goto end;
+
+  server->listener = listen_at(path);
+  if (server->listener < 0) {
+    fprintf(stderr, "failed to listen at '%s'\n", path);
+    goto server_cleanup;
+  }
+
+  server->epoll = epoll_create1(EPOLL_CLOEXEC);
+  if (server->epoll < 0) goto listener_cleanup;
+
+  struct epoll_event listening = {.events = EPOLLIN, .data.u32 = LISTENER};
+  if (epoll_ctl(server->epoll, EPOLL_CTL_ADD, server->listener, &listening)) goto epoll_cleanup;
+
+  // interrupted waits end the loop rather than being restarted
+  struct sigaction action = {.sa_handler = stop};
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  uint64_t started = game_clock_now();
+  struct epoll_event events[EVENTS];
+  while (!stopping) {
+    int ready = epoll_wait(server->epoll, events, EVENTS, -1);
+    if (ready < 0 && errno == EINTR) continue;
+    if (ready < 0) goto connections_cleanup;
+
+    for (int i = 0; i < ready; i++) {
+      uint32_t index = events[i].data.u32;
+      if (index == LISTENER) {
+        accept_all(server);
+        continue;
+      }
+
+      // a hang up is noticed by the read or the write it fails
+      bool open = events[i].events & EPOLLOUT ? flush(server, index) : serve(server, index);
+      if (!open || events[i].events & EPOLLERR) disconnect(server, index);
+    }
+  }
+
+  double seconds = (double)(game_clock_now() - started) / NSEC_PER_SEC;
+  fprintf(stderr,
+          "%zu connections, %zu games, %zu moves in %.1fs (%.0f games/s, %.0f moves/s)\n",
+          server->stats.connections,
+          server->stats.games,
+          server->stats.moves,
+          seconds,
+          server->stats.games / seconds,
+          server->stats.moves / seconds);
+  status = EXIT_SUCCESS;
+
+connections_cleanup:
+  for (uint32_t i = 0; i < server->slab.capacity; i++) {
+    if (server->slab.connections[i].fd >= 0) disconnect(server, i);
+  }
+  free(server->slab.connections);
+epoll_cleanup:
+  close(server->epoll);
+listener_cleanup:
+  close(server->listener);
+  unlink(path);
+server_cleanup:
+  free(server);
+end:
+  return status;
+}
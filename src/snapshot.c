@@ -0,0 +1,109 @@
+#include "snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the amount of bytes following the header of a board of that size, 0 if it doesn't fit in a size_t
+static size_t payload_size(size_t rows, size_t cols) {
+  size_t row = (cols / SNAPSHOT_WORD_BITS + (cols % SNAPSHOT_WORD_BITS != 0)) * SNAPSHOT_PLANES * sizeof(uint64_t);
+  return row && rows <= SIZE_MAX / row ? rows * row : 0;
+}
+
+// whether the header describes a board that can be played, before any of it is allocated
+static bool valid_header(struct snapshot_header const *restrict header, size_t payload) {
+  if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof header->magic) || header->version != SNAPSHOT_VERSION) return false;
+  if ((size_t)header->rows != header->rows || (size_t)header->cols != header->cols) return false;
+  if ((size_t)header->mines != header->mines || !board_valid_size(header->rows, header->cols, header->mines)) {
+    return false;
+  }
+  if (payload_size(header->rows, header->cols) != payload) return false;
+
+  // one of the difficulties, or a custom board
+  uint32_t difficulty = header->difficulty;
+  bool known = difficulty == MS_CLASSIC || difficulty == MS_ADVANCED || difficulty == MS_EXPERT;
+  return difficulty == MS_CUSTOM ||
+         (known && difficulty == (header->cols << OCTET * 2 | header->rows << OCTET | header->mines));
+}
+
+// the mines counter a board shows, as many mines as it holds minus its flags. the density's top block, a single one
+// covering the whole board, already counts the flags `board_unpack` found
+static int64_t mines_left(struct board const *restrict board) {
+  struct density const *density = &board->density;
+  return (int64_t)board_mines(board) - (int64_t)density->level[density->levels - 1].flagged[0];
+}
+
+bool snapshot_save(struct game const *restrict game, char const *restrict path) {
+  if (!game || !path || !board_rows(&game->board)) return false;
+
+  struct board const *board = &game->board;
+  size_t size = sizeof(struct snapshot_header) + payload_size(board->rows, board->cols);
+
+  unsigned char *buf = calloc(1, size);
+  if (!buf) return false;
+
+  struct snapshot_header header = {.version = SNAPSHOT_VERSION,
+                                   .rows = board->rows,
+                                   .cols = board->cols,
+                                   .mines = board->mines,
+                                   .seed = board->seed,
+                                   .elapsed = game_elapsed(game),
+                                   .mines_left = game->mines,
+                                   .difficulty = board->difficulty};
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof header.magic);
+  memcpy(buf, &header, sizeof header);
+  board_pack(board, (uint64_t *)(buf + sizeof header));
+
+  bool saved = false;
+  FILE *file = fopen(path, "wb");
+  if (!file) goto cleanup;
+
+  saved = fwrite(buf, size, 1, file) == 1;
+  saved = !fclose(file) && saved;
+
+cleanup:
+  free(buf);
+  return saved;
+}
+
+struct game snapshot_load(char const *restrict path) {
+  struct game game = {.state = STATE_INVALID};
+  if (!path) return game;
+
+  FILE *file = fopen(path, "rb");
+  if (!file) return game;
+
+  unsigned char *buf = NULL;
+  if (fseek(file, 0, SEEK_END)) goto close;
+
+  long size = ftell(file);
+  if (size < (long)sizeof(struct snapshot_header) || fseek(file, 0, SEEK_SET)) goto close;
+
+  buf = malloc(size);
+  if (!buf || fread(buf, size, 1, file) != 1) goto close;
+
+  // the file's size bounds the board's before it's allocated
+  struct snapshot_header header;
+  memcpy(&header, buf, sizeof header);
+  if (!valid_header(&header, (size_t)size - sizeof header)) goto close;
+
+  struct board board;
+  if (!board_create_custom(&board, header.rows, header.cols, header.mines)) goto close;
+  if (!board_unpack(&board, (uint64_t const *)(buf + sizeof header)) || mines_left(&board) != header.mines_left) {
+    board_destroy(&board);
+    goto close;
+  }
+
+  board.difficulty = header.difficulty;
+  board.seed = header.seed;
+
+  // the clock carries on from where it was saved. the moves made before aren't saved
+  game = (struct game){.state = STATE_PLAYING,
+                       .clock = {.resumed = game_clock_now(), .elapsed = header.elapsed, .running = true},
+                       .board = board,
+                       .mines = header.mines_left};
+
+close:
+  free(buf);
+  fclose(file);
+  return game;
+}
@@ -1,8 +1,13 @@
 #include "util.h"
+#include <limits.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include "colors.h"
+#include "hint.h"
 #include "properties.h"
+#include "resources.h"
+#include "viewport.h"
 
 #define ALERT_WIDTH 350
 #define ALERT_HEIGHT 200
@@ -15,6 +20,39 @@ enum stats_panel_components {
   SC_CLOCK,
 };
 
+// the values currently rendered onto the clock and mines counter assets. the assets outlive the panels (and the game)
+// so the cache lives alongside them
+static struct stats_cache {
+  int seconds;
+  int mines;
+} stats_cache = {.seconds = -1, .mines = INT_MIN};
+
+// the handles of the board assets (ASSET_TILE - ASSET_HINT) at every zoom level, filled by `create_assets`
+static asset_handle board_assets[ZOOM_LEVELS][ASSET_HINT + 1];
+
+// the part of the board on screen. the board panel is sized after it rather than after the board
+static struct viewport viewport;
+
+// the cell the keyboard acts on. hidden until the keyboard is used, and again once the mouse is
+static struct cursor {
+  size_t row;
+  size_t col;
+  bool visible;
+} cursor;
+
+// the safest cell to open, shown from the frame the hint is found on until the board changes. the engine finding them
+// starts with the first hint asked for
+static struct hint_overlay {
+  struct hints *engine;
+  size_t row;
+  size_t col;
+  bool visible;
+} hint;
+
+static asset_handle board_asset(int id) {
+  return board_assets[viewport.zoom][id];
+}
+
 static char *vsprintf_wrapper(char *buf, size_t size, char const *fmt, va_list args) {
   if (!buf || !size) return NULL;
 
@@ -89,34 +127,56 @@ static unsigned max_text_height(TigrFont *restrict font) {
   return tigrTextHeight(font, "a");
 }
 
+// the pixels available to the board. an expert board fits exactly, larger boards scroll
+static unsigned board_width(void) {
+  return (MS_EXPERT >> (OCTET * 2)) * TILE_SIZE;
+}
+
+static unsigned board_height(void) {
+  return ((MS_EXPERT >> OCTET) & 0xff) * TILE_SIZE;
+}
+
 static unsigned window_width(void) {
-  return (MS_EXPERT >> (OCTET * 2)) * TILE_SIZE + LEFT_MARGIN + RIGHT_MARGIN;
+  return board_width() + LEFT_MARGIN + RIGHT_MARGIN;
 }
 
 static unsigned window_height(void) {
-  return ((MS_EXPERT >> OCTET) & 0xff) * TILE_SIZE + HEIGHT_NAV_PANE + HEIGHT_STAT_PANE;
+  return board_height() + HEIGHT_NAV_PANE + HEIGHT_STAT_PANE;
 }
 
-static unsigned panel_width(struct board *restrict board) {
+// as wide as the visible part of the board, but never narrower than a classic board so the stats and the menu fit
+static unsigned panel_width(void) {
 #ifdef DEBUG
 #include <stdio.h>
-  printf("panel width: %zu\n", board_cols(board));
+  fprintf(stderr, "panel width: %zu\n", viewport.cols);
 #endif
-  return board_cols(board) * TILE_SIZE;
+  unsigned width = viewport.cols * viewport_cell_size(&viewport);
+  unsigned min_width = (MS_CLASSIC >> (OCTET * 2)) * TILE_SIZE;
+  return width > min_width ? width : min_width;
 }
 
-static unsigned panel_height(struct board *restrict board) {
-#ifdef DEBUG
-#include <stdio.h>
-  printf("panel height: %zu\n", board_rows(board));
-#endif
-  return board_rows(board) * TILE_SIZE;
+static void reset_viewport(struct board const *restrict board) {
+  viewport = viewport_create(board_rows(board), board_cols(board), board_width(), board_height(), viewport.zoom);
+  cursor = (struct cursor){0};
+}
+
+// scrolls the viewport just enough for the cell at (row, col) to be on screen
+static void follow(size_t row, size_t col) {
+  ptrdiff_t rows = 0;
+  ptrdiff_t cols = 0;
+  if (row < viewport.row) rows = (ptrdiff_t)row - (ptrdiff_t)viewport.row;
+  if (row >= viewport.row + viewport.rows) rows = (ptrdiff_t)(row - (viewport.row + viewport.rows - 1));
+  if (col < viewport.col) cols = (ptrdiff_t)col - (ptrdiff_t)viewport.col;
+  if (col >= viewport.col + viewport.cols) cols = (ptrdiff_t)(col - (viewport.col + viewport.cols - 1));
+
+  // the board panel is rebound to the new cells by the next `draw_board`
+  viewport_scroll(&viewport, rows, cols);
 }
 
 TigrFont *load_font(char const *restrict font_path) {
   if (!font_path) return NULL;
 
-  Tigr *font_png = tigrLoadImage(font_path);
+  Tigr *font_png = resource_load(font_path);
   if (!font_png) return NULL;
 
   return tigrLoadFont(font_png, TCP_ASCII);
@@ -173,6 +233,78 @@ static Tigr *create_mines_asset(TigrFont *restrict font) {
   return tigrBitmap(width, height > TILE_SIZE ? height : TILE_SIZE);
 }
 
+static Tigr *create_glyph_asset(TigrFont *restrict font, char glyph) {
+  char const text[] = {glyph, '\0'};
+
+  Tigr *bmp = tigrBitmap(tigrTextWidth(font, text), tigrTextHeight(font, text));
+  if (!bmp) return NULL;
+
+  tigrClear(bmp, tigrRGBA(BOARD_COLOR));
+  tigrPrint(bmp, font, 0, 0, tigrRGB(RED), text);
+  return bmp;
+}
+
+// box filters `bmp` down by `factor`. colors are weighted by their alpha so transparent pixels don't bleed into the
+// edges
+static Tigr *downscale(Tigr const *restrict bmp, int factor) {
+  Tigr *scaled = tigrBitmap(bmp->w / factor, bmp->h / factor);
+  if (!scaled) return NULL;
+
+  for (int y = 0; y < scaled->h; y++) {
+    for (int x = 0; x < scaled->w; x++) {
+      unsigned r = 0;
+      unsigned g = 0;
+      unsigned b = 0;
+      unsigned a = 0;
+      for (int sy = y * factor; sy < (y + 1) * factor; sy++) {
+        for (int sx = x * factor; sx < (x + 1) * factor; sx++) {
+          TPixel pixel = bmp->pix[sy * bmp->w + sx];
+          r += pixel.r * pixel.a;
+          g += pixel.g * pixel.a;
+          b += pixel.b * pixel.a;
+          a += pixel.a;
+        }
+      }
+
+      if (a) scaled->pix[y * scaled->w + x] = tigrRGBA(r / a, g / a, b / a, a / (factor * factor));
+    }
+  }
+
+  return scaled;
+}
+
+static bool is_board_asset(int id) {
+  return id <= ASSET_MINE || (id >= ASSET_ZERO && id <= ASSET_HINT);
+}
+
+// pushes a downscaled copy of every board asset per zoom level past the first
+static struct assets_manager *create_zoomed_assets(struct assets_manager *restrict am) {
+  for (int id = 0; id <= ASSET_HINT; id++) {
+    board_assets[0][id] = id;
+  }
+
+  for (int zoom = 1; zoom < ZOOM_LEVELS; zoom++) {
+    for (int id = 0; id <= ASSET_HINT; id++) {
+      board_assets[zoom][id] = ASSET_HANDLE_NONE;
+      if (!is_board_asset(id)) continue;
+
+      Tigr *source = am_bitmap(am, id);
+      if (!source) return am;
+
+      Tigr *bmp = downscale(source, 1 << zoom);
+      if (!bmp) return am;
+
+      size_t size = am->size;
+      am = am_push(am, asset_create(ASSET_ZOOMED * zoom + id, bmp));
+      if (am->size == size) return am;
+
+      board_assets[zoom][id] = size;
+    }
+  }
+
+  return am;
+}
+
 struct assets_manager *create_assets(struct assets_manager *restrict am, TigrFont *restrict font) {
   if (!am) return NULL;
 
@@ -216,6 +348,35 @@ struct assets_manager *create_assets(struct assets_manager *restrict am, TigrFon
     am = am_push(am, asset_create(i, bmp));
   }
 
+  // create the cursor, a border drawn over a cell. it stays off the see through pixels of the tile, which nothing
+  // would paint over once the cursor moves on
+  Tigr *tile = am_bitmap(am, ASSET_TILE);
+  Tigr *cursor_asset = tile ? tigrBitmap(tile->w, tile->h) : NULL;
+  if (!cursor_asset) return am;
+
+  for (int y = 0; y < tile->h; y++) {
+    for (int x = 0; x < tile->w; x++) {
+      bool border = x < 2 || y < 2 || x >= tile->w - 2 || y >= tile->h - 2;
+      bool opaque = tile->pix[y * tile->w + x].a == 255;
+      cursor_asset->pix[y * tile->w + x] = border && opaque ? tigrRGB(RED) : tigrRGBA(0, 0, 0, 0);
+    }
+  }
+  am = am_push(am, asset_create(ASSET_CURSOR, cursor_asset));
+
+  // create the hint, a ring within the cursor's so a cell may show both
+  Tigr *hint_asset = tigrBitmap(tile->w, tile->h);
+  if (!hint_asset) return am;
+
+  for (int y = 0; y < tile->h; y++) {
+    for (int x = 0; x < tile->w; x++) {
+      bool outer = x >= 3 && y >= 3 && x < tile->w - 3 && y < tile->h - 3;
+      bool inner = x >= 5 && y >= 5 && x < tile->w - 5 && y < tile->h - 5;
+      bool opaque = tile->pix[y * tile->w + x].a == 255;
+      hint_asset->pix[y * tile->w + x] = outer && !inner && opaque ? tigrRGB(GREEN) : tigrRGBA(0, 0, 0, 0);
+    }
+  }
+  am = am_push(am, asset_create(ASSET_HINT, hint_asset));
+
   // create an asset for the clock
   Tigr *clock_asset = create_clock_asset(font);
   if (!clock_asset) return am;
@@ -228,6 +389,15 @@ struct assets_manager *create_assets(struct assets_manager *restrict am, TigrFon
 
   am = am_push(am, asset_create(ASSET_MINES_COUNTER, mines_asset));
 
+  // create the glyphs the clock and the mines counter are made of
+  char const glyphs[] = "0123456789:-";
+  for (int i = ASSET_GLYPH_ZERO; i < ASSET_GLYPH_MINUS + 1; i++) {
+    Tigr *bmp = create_glyph_asset(font, glyphs[i - ASSET_GLYPH_ZERO]);
+    if (!bmp) return am;
+
+    am = am_push(am, asset_create(i, bmp));
+  }
+
   // create 3 emtpy assets for the menu
   for (unsigned i = 0; i < MS_DIFFICULTIES; i++) {
     Tigr *bmp = tigrBitmap(max_text_width(font), max_text_height(font));
@@ -236,13 +406,13 @@ struct assets_manager *create_assets(struct assets_manager *restrict am, TigrFon
     am = am_push(am, asset_create(ASSET_EMPTY, bmp));
   }
 
-  return am;
+  return create_zoomed_assets(am);
 }
 
 static struct panel *create_navbar(struct assets_manager *restrict am, size_t width, size_t height) {
   if (!am) return NULL;
 
-  struct component *humburger = component_create(0, 0, 0, ALIGN_LEFT, 1, am_get_at(am, ASSET_HUMBURGER));
+  struct component *humburger = component_create(0, 0, 0, ALIGN_LEFT, am, 1, ASSET_HUMBURGER);
   if (!humburger) return NULL;
 
   return panel_create(PANEL_NAVBAR, 0, 0, ALIGN_CENTER, width, height, 1, humburger);
@@ -260,33 +430,47 @@ static struct panel *create_stats_panel(struct assets_manager *restrict am, size
     width,
     height,
     3,
-    component_create(SC_MINES_COUNTER, 0, 0, ALIGN_LEFT, 1, am_get_at(am, ASSET_MINES_COUNTER)),
-    component_create(SC_BUTTON, 0, 0, ALIGN_CENTER, 2, am_get_at(am, ASSET_TILE), am_get_at(am, ASSET_HAPPY)),
-    component_create(SC_CLOCK, 0, 0, ALIGN_RIGHT, 1, am_get_at(am, ASSET_CLOCK)));
+    component_create(SC_MINES_COUNTER, 0, 0, ALIGN_LEFT, am, 1, ASSET_MINES_COUNTER),
+    component_create(SC_BUTTON, 0, 0, ALIGN_CENTER, am, 2, ASSET_TILE, ASSET_HAPPY),
+    component_create(SC_CLOCK, 0, 0, ALIGN_RIGHT, am, 1, ASSET_CLOCK));
 }
 
-// assumes component creation never fails
-static struct panel *create_main_panel(struct assets_manager *restrict am,
-                                       struct game *restrict game,
-                                       size_t width,
-                                       size_t height) {
-  if (!am || !game) return NULL;
-
-  struct panel *panel =
-    panel_create(PANEL_BOARD, 0, HEIGHT_NAV_PANE + HEIGHT_STAT_PANE, ALIGN_CENTER, width, height, 0);
-  if (!panel) return NULL;
+// one component per visible cell, see `struct viewport`
+static struct panel *create_main_panel(struct assets_manager *restrict am) {
+  if (!am) return NULL;
 
-  for (size_t row = 0; row < board_rows(&game->board); row++) {
-    for (size_t col = 0; col < board_cols(&game->board); col++) {
-      unsigned pos = row * board_cols(&game->board) + col;
+  return panel_create_grid(PANEL_BOARD,
+                           0,
+                           HEIGHT_NAV_PANE + HEIGHT_STAT_PANE,
+                           ALIGN_CENTER,
+                           viewport.rows,
+                           viewport.cols,
+                           viewport_cell_size(&viewport),
+                           viewport_cell_size(&viewport),
+                           am,
+                           board_asset(ASSET_TILE));
+}
 
-      panel =
-        panel_add(panel,
-                  1,
-                  component_create(pos, col * TILE_SIZE, row * TILE_SIZE, ALIGN_LEFT, 1, am_get_at(am, ASSET_TILE)));
-    }
-  }
+// one pixel per block of the finest density level that fits, plus a border
+static struct panel *create_minimap(struct board *restrict board) {
+  if (!board) return NULL;
+
+  size_t level = density_fitting_level(&board->density, MINIMAP_HEIGHT - 2, MINIMAP_WIDTH - 2);
+  struct density_level const *blocks = &board->density.level[level];
+
+  unsigned width = blocks->cols + 2;
+  unsigned height = blocks->rows + 2;
+  struct panel *panel = panel_create(PANEL_MINIMAP,
+                                     RIGHT_MARGIN,
+                                     HEIGHT_NAV_PANE + HEIGHT_STAT_PANE + board_height() - height,
+                                     ALIGN_RIGHT,
+                                     width,
+                                     height,
+                                     0);
+  if (!panel) return NULL;
 
+  panel->visible = false;
+  panel->blend = false;
   return panel;
 }
 
@@ -303,11 +487,12 @@ static struct panel *create_menu(struct assets_manager *restrict *am, TigrFont *
   panel_clear(panel, tigrRGB(192, 192, 192));
 
   for (unsigned i = 0; i < MS_DIFFICULTIES; i++) {
-    struct asset *empty = am_get_free(*am, ASSET_EMPTY);
-    if (!empty) { continue; }
+    asset_handle empty = am_find_free(*am, ASSET_EMPTY);
+    if (empty == ASSET_HANDLE_NONE) { continue; }
 
-    print_difficulty(empty->bmp, font, difficulties[i]);
-    panel = panel_add(panel, 1, component_create(difficulties[i], 0, i * menu_height, ALIGN_CENTER, 1, empty));
+    print_difficulty(am_bitmap(*am, empty), font, difficulties[i]);
+    am_refresh(*am, empty);
+    panel = panel_add(panel, 1, component_create(difficulties[i], 0, i * menu_height, ALIGN_CENTER, *am, 1, empty));
   }
 
   panel->visible = false;
@@ -322,19 +507,21 @@ static bool create_panels(struct panel **restrict panels,
                           TigrFont *restrict font) {
   if (!panels || !am || !game) return false;
 
-  if (PANEL_MENU >= size) return false;
+  if (PANEL_MENU >= size || PANEL_MINIMAP >= size) return false;
 
   if (!font) font = tfont;
 
-  panels[PANEL_NAVBAR] = create_navbar(am, panel_width(&game->board), HEIGHT_NAV_PANE);
-  panels[PANEL_STATS] = create_stats_panel(am, panel_width(&game->board), HEIGHT_STAT_PANE);
-  panels[PANEL_BOARD] = create_main_panel(am, game, panel_width(&game->board), panel_height(&game->board));
-  panels[PANEL_MENU] = create_menu(&am, font, panel_width(&game->board));
+  panels[PANEL_NAVBAR] = create_navbar(am, panel_width(), HEIGHT_NAV_PANE);
+  panels[PANEL_STATS] = create_stats_panel(am, panel_width(), HEIGHT_STAT_PANE);
+  panels[PANEL_BOARD] = create_main_panel(am);
+  panels[PANEL_MINIMAP] = create_minimap(&game->board);
+  panels[PANEL_MENU] = create_menu(&am, font, panel_width());
 
   for (size_t i = 0; i < size; i++) {
     if (!panels[i]) {
-      for (size_t j = 0; j < i; j++) {
-        panel_destroy(panels[i]);
+      for (size_t j = 0; j < size; j++) {
+        panel_destroy(panels[j], am);
+        panels[j] = NULL;
       }
       return false;
     }
@@ -343,24 +530,41 @@ static bool create_panels(struct panel **restrict panels,
   return true;
 }
 
-static void destroy_panels(struct panel **restrict panels, size_t amount) {
+static void destroy_panels(struct panel **restrict panels, size_t amount, struct assets_manager *restrict am) {
   if (!panels) return;
 
   for (size_t i = 0; i < amount; i++) {
-    panel_destroy(panels[i]);
+    panel_destroy(panels[i], am);
   }
 }
 
+static void print_memory_usage(struct window const *restrict window, struct assets_manager const *restrict am) {
+#ifdef DEBUG
+  struct memory_usage usage = window_memory_usage(window, am);
+  fprintf(stderr, "memory usage: {window: %zu, panels: %zu, components: %zu, assets: %zu, total: %zu}\n",
+          usage.window,
+          usage.panels,
+          usage.components,
+          usage.assets,
+          usage.total);
+#else
+  (void)window;
+  (void)am;
+#endif
+}
+
 struct window *create_window(struct game *restrict game, struct assets_manager *restrict am, TigrFont *restrict font) {
   if (!game || !am || !font) return NULL;
 
   struct window *window = window_create(window_width(), window_height(), "Minesweeper", TIGR_FIXED, 0);
   if (!window) { return NULL; }
 
+  reset_viewport(&game->board);
+
   // panels
   struct panel *panels[PANEL_AMOUNT] = {0};
   if (!create_panels(panels, sizeof panels / sizeof *panels, am, game, font)) {
-    window_destroy(window);
+    window_destroy(window, am);
     return NULL;
   }
 
@@ -370,26 +574,55 @@ struct window *create_window(struct game *restrict game, struct assets_manager *
 
   // sort of a hack. make the menu align with the navbar button
   window->panels[PANEL_MENU]->x_offset = window_x_panel(window, panels[PANEL_NAVBAR]);
+
+  print_memory_usage(window, am);
   return window;
 }
 
-void reveal_mines(struct board *restrict board) {
-  if (!board) return;
+static int glyph_id(char glyph) {
+  if (glyph >= '0' && glyph <= '9') return ASSET_GLYPH_ZERO + glyph - '0';
+  if (glyph == ':') return ASSET_GLYPH_COLON;
+  if (glyph == '-') return ASSET_GLYPH_MINUS;
+  return -1;
+}
+
+// composites the prebuilt glyphs of `text` centered onto `bmp`. characters without a glyph are skipped
+static void print_glyphs(Tigr *restrict bmp, struct assets_manager *restrict am, char const *restrict text) {
+  if (!bmp || !am || !text) return;
 
-  for (size_t row = 0; row < board_rows(board); row++) {
-    for (size_t col = 0; col < board_cols(board); col++) {
-      struct cell *current = board_cell(board, row, col);
-      if (!current) continue;
+  int width = 0;
+  int height = 0;
+  for (char const *curr = text; *curr; curr++) {
+    int id = glyph_id(*curr);
+    if (id < 0) continue;
 
-      if (current->mine) current->revealed = true;
-    }
+    Tigr *glyph = am_bitmap(am, id);
+    width += glyph->w;
+    if (glyph->h > height) height = glyph->h;
+  }
+
+  tigrClear(bmp, tigrRGBA(BOARD_COLOR));
+
+  int x = bmp->w / 2 - width / 2;
+  int y = bmp->h / 2 - height / 2;
+  for (char const *curr = text; *curr; curr++) {
+    int id = glyph_id(*curr);
+    if (id < 0) continue;
+
+    Tigr *glyph = am_bitmap(am, id);
+    tigrBlit(bmp, glyph, x, y, 0, 0, glyph->w, glyph->h);
+    x += glyph->w;
   }
 }
 
-static void draw_clock(struct panel *restrict panel, struct game *restrict game, TigrFont *restrict font) {
-  if (!panel || !game) return;
+static void draw_clock(struct panel *restrict panel, struct game *restrict game, struct assets_manager *restrict am) {
+  if (!panel || !game || !am) return;
 
-  if (!font) font = tfont;
+  int seconds = (int)(game_elapsed(game) / NSEC_PER_SEC);
+
+  // the clock displays whole seconds. nothing to do until the next one
+  if (seconds == stats_cache.seconds) return;
+  stats_cache.seconds = seconds;
 
   struct component *clock_component = panel->components[SC_CLOCK];
 
@@ -398,25 +631,22 @@ static void draw_clock(struct panel *restrict panel, struct game *restrict game,
   };
   char time_as_str[SIZE] = "00:00";
 
-  double seconds = difftime(game->clock.end, game->clock.start);
-  sprintf_wrapper(time_as_str, sizeof time_as_str, "%02d:%02d", ((int)seconds / 60) % 60, (int)seconds % 60);
+  sprintf_wrapper(time_as_str, sizeof time_as_str, "%02d:%02d", (seconds / 60) % 60, seconds % 60);
 
-  struct asset *asset = clock_component->assets;
-  tigrClear(asset->bmp, tigrRGBA(BOARD_COLOR));
-  tigrPrint(asset->bmp,
-            font,
-            asset->bmp->w / 2 - tigrTextWidth(font, time_as_str) / 2,
-            asset->bmp->h / 2 - tigrTextHeight(font, time_as_str) / 2,
-            tigrRGB(RED),
-            time_as_str);
+  asset_handle clock = component_asset_at(clock_component, 0);
+  print_glyphs(am_bitmap(am, clock), am, time_as_str);
+  am_refresh(am, clock);
 }
 
-static void draw_mines_counter(struct panel *restrict panel, struct game *restrict game, TigrFont *restrict font) {
-  if (!panel || !game) return;
+static void draw_mines_counter(struct panel *restrict panel,
+                               struct game *restrict game,
+                               struct assets_manager *restrict am) {
+  if (!panel || !game || !am) return;
 
-  if (!font) font = tfont;
+  if (game->mines == stats_cache.mines) return;
+  stats_cache.mines = game->mines;
 
-  struct component *clock_component = panel->components[SC_MINES_COUNTER];
+  struct component *mines_component = panel->components[SC_MINES_COUNTER];
 
   enum str_local_size {
     SIZE = 64,
@@ -425,14 +655,9 @@ static void draw_mines_counter(struct panel *restrict panel, struct game *restri
 
   sprintf_wrapper(mines_count_as_str, sizeof mines_count_as_str, "%02d", game->mines);
 
-  struct asset *asset = clock_component->assets;
-  tigrClear(asset->bmp, tigrRGBA(BOARD_COLOR));
-  tigrPrint(asset->bmp,
-            font,
-            asset->bmp->w / 2 - tigrTextWidth(font, mines_count_as_str) / 2,
-            asset->bmp->h / 2 - tigrTextHeight(font, mines_count_as_str) / 2,
-            tigrRGB(RED),
-            mines_count_as_str);
+  asset_handle mines = component_asset_at(mines_component, 0);
+  print_glyphs(am_bitmap(am, mines), am, mines_count_as_str);
+  am_refresh(am, mines);
 }
 
 static void reset_board(struct panel *restrict panel, struct assets_manager *restrict am) {
@@ -441,38 +666,135 @@ static void reset_board(struct panel *restrict panel, struct assets_manager *res
   for (size_t i = 0; i < panel->components_amount; i++) {
     struct component *current = panel_component_at(panel, i);
 
-    component_clear(current);
-    component_push(current, am_get_at(am, ASSET_TILE));
+    component_clear(current, am);
+    component_push(current, am, board_asset(ASSET_TILE));
+  }
+}
+
+// makes `component` hold exactly `assets`. components are rebound to other cells as the viewport scrolls, so what they
+// held before says nothing about the cell they now show
+static void show_assets(struct component *restrict component,
+                        struct assets_manager *restrict am,
+                        size_t count,
+                        asset_handle const *restrict assets) {
+  if (!component) return;
+
+  bool same = component->size == count;
+  for (size_t i = 0; same && i < count; i++) {
+    same = component_asset_at(component, i) == assets[i];
+  }
+  if (same) return;
+
+  component_clear(component, am);
+  for (size_t i = 0; i < count; i++) {
+    component_push(component, am, assets[i]);
   }
 }
 
 static void draw_board(struct panel *restrict panel, struct game *restrict game, struct assets_manager *restrict am) {
   if (!panel || !game || !am) { return; }
 
-  for (size_t row = 0; row < board_rows(&game->board); row++) {
-    for (size_t col = 0; col < board_cols(&game->board); col++) {
-      struct cell *cell = board_cell(&game->board, row, col);
-      if (!cell) continue;
-
-      struct component *component = panel_component_at(panel, row * board_cols(&game->board) + col);
-      if (cell->mark == MARK_MINE) {  // cells marked as mines should not be revealed
-        component_remove(component, ASSET_FLAG);
-        component_push(component, am_get(am, ASSET_FLAG));
-      } else if (cell->mine && cell->revealed) {
-        component_clear(component);
-        component_push(component, am_get(am, ASSET_MINE));
-      } else if (cell->revealed) {
-        component_clear(component);
-        component_push(component, am_get(am, ASSET_ZERO + cell->adjacent_mines));
-      } else if (cell->mark == MARK_QUESTION) {
-        component_pop(component);
-        component_push(component, am_get(am, ASSET_QUESTION));
-      } else {
-        component_clear(component);
-        component_push(component, am_get(am, ASSET_TILE));
-      }
+  for (size_t idx = 0; idx < panel->components_amount; idx++) {
+    size_t row = 0;
+    size_t col = 0;
+    if (!viewport_cell(&viewport, idx, &row, &col)) continue;
+
+    struct cell cell = board_cell(&game->board, row, col);
+
+    asset_handle assets[4] = {0};
+    size_t count = 0;
+    if (cell.mark == MARK_MINE) {  // cells marked as mines should not be revealed
+      assets[count++] = board_asset(ASSET_TILE);
+      assets[count++] = board_asset(ASSET_FLAG);
+    } else if (cell.mine && cell.revealed) {
+      assets[count++] = board_asset(ASSET_MINE);
+    } else if (cell.revealed) {
+      assets[count++] = board_asset(ASSET_ZERO + cell.adjacent_mines);
+    } else if (cell.mark == MARK_QUESTION) {
+      assets[count++] = board_asset(ASSET_TILE);
+      assets[count++] = board_asset(ASSET_QUESTION);
+    } else {
+      assets[count++] = board_asset(ASSET_TILE);
+    }
+
+    if (hint.visible && hint.row == row && hint.col == col) assets[count++] = board_asset(ASSET_HINT);
+    if (cursor.visible && cursor.row == row && cursor.col == col) assets[count++] = board_asset(ASSET_CURSOR);
+
+    show_assets(panel_component_at(panel, idx), am, count, assets);
+  }
+}
+
+static unsigned char mix(unsigned char unknown,
+                         unsigned char revealed,
+                         unsigned char flagged,
+                         size_t revealed_cells,
+                         size_t flagged_cells,
+                         size_t cells) {
+  size_t unknown_cells = cells - revealed_cells - flagged_cells;
+  return (unknown * unknown_cells + revealed * revealed_cells + flagged * flagged_cells) / cells;
+}
+
+// shades every block by how much of it is revealed or flagged and outlines the viewport. reads the board's density
+// pyramid, so it costs the same regardless of the board's size
+static void draw_minimap(struct panel *restrict panel, struct game *restrict game) {
+  if (!panel || !game) { return; }
+
+  struct board *board = &game->board;
+  panel->visible = viewport.rows < board_rows(board) || viewport.cols < board_cols(board);
+  if (!panel->visible) { return; }
+
+  size_t level = density_fitting_level(&board->density, panel->bmp->h - 2, panel->bmp->w - 2);
+  struct density_level const *blocks = &board->density.level[level];
+  size_t block = density_block_size(level);
+
+  TPixel unknown = tigrRGB(GREY);
+  TPixel revealed = tigrRGBA(BOARD_COLOR);
+  TPixel flagged = tigrRGB(RED);
+
+  tigrClear(panel->bmp, tigrRGB(BLACK));
+  for (size_t row = 0; row < blocks->rows; row++) {
+    size_t height = board_rows(board) - row * block < block ? board_rows(board) - row * block : block;
+
+    for (size_t col = 0; col < blocks->cols; col++) {
+      size_t width = board_cols(board) - col * block < block ? board_cols(board) - col * block : block;
+
+      size_t cells = width * height;
+      size_t revealed_cells = blocks->revealed[row * blocks->cols + col];
+      size_t flagged_cells = blocks->flagged[row * blocks->cols + col];
+      // flagged mines remain flagged once revealed
+      if (revealed_cells + flagged_cells > cells) flagged_cells = cells - revealed_cells;
+
+      panel->bmp->pix[(row + 1) * panel->bmp->w + col + 1] =
+        tigrRGB(mix(unknown.r, revealed.r, flagged.r, revealed_cells, flagged_cells, cells),
+                mix(unknown.g, revealed.g, flagged.g, revealed_cells, flagged_cells, cells),
+                mix(unknown.b, revealed.b, flagged.b, revealed_cells, flagged_cells, cells));
     }
   }
+
+  size_t top = viewport.row / block;
+  size_t left = viewport.col / block;
+  size_t bottom = (viewport.row + viewport.rows - 1) / block;
+  size_t right = (viewport.col + viewport.cols - 1) / block;
+  tigrRect(panel->bmp, left + 1, top + 1, right - left + 1, bottom - top + 1, tigrRGB(WHITE));
+}
+
+// centers the viewport on the block clicked on the minimap
+static void jump_to(struct window *restrict window,
+                    struct panel *restrict minimap,
+                    struct game *restrict game,
+                    struct mouse_event mouse_event) {
+  struct board *board = &game->board;
+  size_t level = density_fitting_level(&board->density, minimap->bmp->h - 2, minimap->bmp->w - 2);
+  size_t block = density_block_size(level);
+
+  ptrdiff_t x = (ptrdiff_t)mouse_event.x - window_x_panel(window, minimap) - 1;
+  ptrdiff_t y = (ptrdiff_t)mouse_event.y - window_y_panel(minimap) - 1;
+  if (x < 0 || y < 0) { return; }
+
+  ptrdiff_t size = (ptrdiff_t)block;
+  ptrdiff_t row = y * size + size / 2 - (ptrdiff_t)(viewport.rows / 2);
+  ptrdiff_t col = x * size + size / 2 - (ptrdiff_t)(viewport.cols / 2);
+  viewport_scroll(&viewport, row - (ptrdiff_t)viewport.row, col - (ptrdiff_t)viewport.col);
 }
 
 static void draw_button(struct panel *restrict panel, struct game *restrict game, struct assets_manager *restrict am) {
@@ -483,12 +805,12 @@ static void draw_button(struct panel *restrict panel, struct game *restrict game
 
   switch (game->state) {
     case STATE_WON:
-      component_pop(button);
-      component_push(button, am_get_at(am, ASSET_CHAD));
+      component_pop(button, am);
+      component_push(button, am, ASSET_CHAD);
       break;
     case STATE_LOST:
-      component_pop(button);
-      component_push(button, am_get_at(am, ASSET_SAD));
+      component_pop(button, am);
+      component_push(button, am, ASSET_SAD);
       break;
     case STATE_PLAYING:
     default:  // fallthrough
@@ -496,6 +818,15 @@ static void draw_button(struct panel *restrict panel, struct game *restrict game
   }
 }
 
+// shows the hint found since the last frame, if any. boards larger than the window scroll to it
+static void collect_hint(struct game const *restrict game) {
+  struct hint found;
+  if (!hints_poll(hint.engine, &found) || game->state != STATE_PLAYING) return;
+
+  hint = (struct hint_overlay){.engine = hint.engine, .row = found.row, .col = found.col, .visible = true};
+  follow(hint.row, hint.col);
+}
+
 void draw_window(struct window *restrict window,
                  struct game *restrict game,
                  struct assets_manager *restrict am,
@@ -507,12 +838,14 @@ void draw_window(struct window *restrict window,
   window_clear(window, tigrRGBA(BOARD_COLOR));
 
   struct panel *stats = window_panel_at(window, PANEL_STATS);
-  draw_clock(stats, game, font);
-  draw_mines_counter(stats, game, font);
+  draw_clock(stats, game, am);
+  draw_mines_counter(stats, game, am);
   draw_button(stats, game, am);
+  collect_hint(game);
   draw_board(window_panel_at(window, PANEL_BOARD), game, am);
+  draw_minimap(window_panel_at(window, PANEL_MINIMAP), game);
 
-  window_draw(window, ALPHA);
+  window_draw(window, am, ALPHA);
 }
 
 static void toggle_menu(struct window *restrict window) {
@@ -533,143 +866,94 @@ static void toggle_menu_off(struct window *restrict window) {
   if (menu->visible) menu->visible = false;
 }
 
-static size_t sum_adjacent_flags(struct cell const *restrict cells, size_t row, size_t col, size_t rows, size_t cols) {
-  size_t prev_row = row - 1;
-  size_t last_row = row + 1;
-  size_t prev_col = col - 1;
-  size_t last_col = col + 1;
-
-  if (row == 0) { prev_row = row; }
-  if (row == rows - 1) { last_row = row; }
-
-  if (col == 0) { prev_col = col; }
-  if (col == cols - 1) { last_col = col; }
-
-  size_t adjacent_flags = 0;
-  for (size_t curr_row = prev_row; curr_row <= last_row; curr_row++) {
-    for (size_t curr_col = prev_col; curr_col <= last_col; curr_col++) {
-      if (cells[curr_row * cols + curr_col].mark == MARK_MINE) adjacent_flags++;
-    }
-  }
-  return adjacent_flags;
+// the hint shown no longer holds. publishing the board cancels the one in flight, and lets the next one follow the
+// board's changes rather than copy it whole
+static void board_changed(struct game const *restrict game) {
+  hint.visible = false;
+  if (hint.engine) hints_publish(hint.engine, &game->board);
 }
 
-static void reveal_next_cell(struct game *restrict game, unsigned row, unsigned col) {
-  if (!game) return;
-
-  if (game->state == STATE_LOST) return;
-
-  // boundry check
-  size_t rows = board_rows(&game->board);
-  size_t cols = board_cols(&game->board);
-  if (row >= rows) return;
-  if (col >= cols) return;
-
-  struct cell *current_cell = board_cell(&game->board, row, col);
-  if (!current_cell) return;
-  if (current_cell->revealed || current_cell->mark == MARK_MINE) return;
-
-  board_reveal_cell(&game->board, row, col);
-  if (current_cell->mine) game->state = STATE_LOST;
-
-  size_t adjacent_flags = sum_adjacent_flags(game->board.cells, row, col, rows, cols);
-  if (adjacent_flags < current_cell->adjacent_mines) return;
-
-  // try to go up
-  reveal_next_cell(game, row - 1, col);
-  // try to go top right
-  reveal_next_cell(game, row - 1, col + 1);
-  // try to go right
-  reveal_next_cell(game, row, col + 1);
-  // try to go bottom right
-  reveal_next_cell(game, row + 1, col + 1);
-  // try to go down
-  reveal_next_cell(game, row + 1, col);
-  // try to go bottom left
-  reveal_next_cell(game, row + 1, col - 1);
-  // try to go left
-  reveal_next_cell(game, row, col - 1);
-  // try to go top left
-  reveal_next_cell(game, row - 1, col - 1);
+// makes a move on the cell at (row, col), the mouse and the keyboard alike
+static void act(struct game *restrict game, enum move_kind kind, size_t row, size_t col) {
+  if (game_step(game, (struct game_action){.kind = kind, .row = row, .col = col})) board_changed(game);
 }
 
-static int flag(struct cell *restrict cell, int mines) {
-  if (!cell) return mines;
+// the hint is found on another thread, `collect_hint` shows it once it is
+static void ask_hint(struct game const *restrict game) {
+  if (game->state != STATE_PLAYING) return;
 
-  if (cell->revealed) return mines;
+  if (!hint.engine) hint.engine = hints_create();
+  if (!hint.engine || !hints_publish(hint.engine, &game->board)) return;
 
-  cell->mark = (cell->mark + 1) % MARK_AMOUNT;
-  switch (cell->mark) {
-    case MARK_MINE:
-      return mines - 1;
-    case MARK_QUESTION:
-      return mines + 1;
-    case MARK_NONE:
-    default:  // fallthrough
-      return mines;
-  }
+  hints_request(hint.engine);
 }
 
-static void react(struct window *window, struct game *restrict game, struct mouse_event mouse_event) {
+static void react(struct window *window,
+                  struct game *restrict game,
+                  struct assets_manager const *restrict am,
+                  struct mouse_event mouse_event) {
   if (!window || !game) { return; }
 
-  if (game->state != STATE_PLAYING) { return; }
-
-  struct component *clicked = window_get_component(window, mouse_event.x, mouse_event.y);
+  struct component *clicked = window_get_component(window, am, mouse_event.x, mouse_event.y);
   if (!clicked) { return; }
 
-  /*
-    id = row * board::cols + col
+  // the component's id is its index within the viewport
+  size_t row = 0;
+  size_t col = 0;
+  if (!viewport_cell(&viewport, clicked->id, &row, &col)) { return; }
 
-    col = id % board::cols
-    row = id / board::cols
-  */
-  unsigned col = clicked->id % board_cols(&game->board);
-  unsigned row = clicked->id / board_cols(&game->board);
-
-  struct cell *cell = board_cell(&game->board, row, col);
-  if (!cell) { return; }
+  cursor.visible = false;
 
   switch (mouse_event.button) {
     case MOUSE_LEFT:
-      if (cell->mark != MARK_NONE) break;
-
-      if (cell->mine) {
-        game->state = STATE_LOST;
-      } else if (!cell->adjacent_mines) {
-        reveal_next_cell(game, row, col);
-      } else {
-        board_reveal_cell(&game->board, row, col);
-      }
+      act(game, MOVE_REVEAL, row, col);
       break;
     case MOUSE_RIGHT:
-      game->mines = flag(cell, game->mines);
+      act(game, MOVE_MARK, row, col);
       break;
     case MOUSE_MIDDLE:
-      if (!cell->revealed) { break; }
-      // hack
-      cell->revealed = false;
-      game->board.revealed_cells--;
-      // end of hack
-
-      reveal_next_cell(game, row, col);
+      act(game, MOVE_CHORD, row, col);
       break;
     default:
       break;
   }
+}
 
-  // check win condition
-  if (board_revealed_cells(&game->board) && game->state == STATE_PLAYING) {
-    game->state = STATE_WON;
-    game->mines = 0;
+// recreates all the panels to accommodate a change of the board's size or of the viewport. destroying the menu gives
+// its assets back, the new menu picks them up again
+static void recreate_panels(struct window *restrict window,
+                            struct game *restrict game,
+                            struct assets_manager *restrict am,
+                            TigrFont *restrict font) {
+  destroy_panels(window->panels, window->panels_amount, am);
+  if (!create_panels(window->panels, PANEL_AMOUNT, am, game, font)) {
+    game->state = STATE_INVALID;
+    return;
   }
+
+  // sort of a hack. make the menu align with the navbar button
+  window->panels[PANEL_MENU]->x_offset = window_x_panel(window, window->panels[PANEL_NAVBAR]);
+
+  print_memory_usage(window, am);
+}
+
+static void toggle_emoji(struct component *restrict component,
+                         struct assets_manager *restrict am,
+                         asset_handle asset) {
+  if (!component || !am) return;
+
+  component_pop(component, am);
+  component_push(component, am, asset);
 }
 
-static void toggle_emoji(struct component *restrict component, struct asset *restrict asset) {
-  if (!component || !asset) return;
+// starts over on a board of the same size
+static void new_game(struct window *restrict window, struct game *restrict game, struct assets_manager *restrict am) {
+  struct panel *stats = window_panel_at(window, PANEL_STATS);
+  if (stats) toggle_emoji(panel_component_at(stats, SC_BUTTON), am, ASSET_HAPPY);
 
-  component_pop(component);
-  component_push(component, asset);
+  reset_board(window_panel_at(window, PANEL_BOARD), am);
+  *game = game_reset(game);
+  board_changed(game);
 }
 
 void on_mouse_click(struct window *restrict window,
@@ -688,23 +972,27 @@ void on_mouse_click(struct window *restrict window,
     struct panel *stats = window_panel_at(window, PANEL_STATS);
     if (!STATE_LOST) { return; }
 
-    toggle_emoji(panel_component_at(stats, SC_BUTTON), am_get_at(am, ASSET_HAPPY));
+    toggle_emoji(panel_component_at(stats, SC_BUTTON), am, ASSET_HAPPY);
     return;
   }
 
   // change the smiley when mouse button down
   struct panel *stats = window_panel_at(window, PANEL_STATS);
   if (!stats) { return; }
-  toggle_emoji(panel_component_at(stats, SC_BUTTON), am_get_at(am, ASSET_SHOCK));
-
-  // prevent mouse button hold down
-  if (game->prev_buttons != MOUSE_NONE) { return; }
+  toggle_emoji(panel_component_at(stats, SC_BUTTON), am, ASSET_SHOCK);
 
   // get the components one clicked on
   struct panel *clicked_panel = window_get_panel(window, mouse_event.x, mouse_event.y);
   if (!clicked_panel) { return; }
 
-  struct component *clicked_component = window_get_component(window, mouse_event.x, mouse_event.y);
+  // the minimap has no components to click on
+  if (clicked_panel->id == PANEL_MINIMAP) {
+    jump_to(window, clicked_panel, game, mouse_event);
+    toggle_menu_off(window);
+    return;
+  }
+
+  struct component *clicked_component = window_get_component(window, am, mouse_event.x, mouse_event.y);
   if (!clicked_component) { return; }
 
   switch (clicked_panel->id) {
@@ -714,50 +1002,159 @@ void on_mouse_click(struct window *restrict window,
       toggle_menu(window);
       break;
     case PANEL_BOARD:
-      react(window, game, mouse_event);
+      react(window, game, am, mouse_event);
       toggle_menu_off(window);
       break;
     case PANEL_STATS:
       toggle_menu_off(window);
 
       // reset button was clicked
-      if (clicked_component->id == SC_BUTTON) {
-        toggle_emoji(clicked_component, am_get_at(am, ASSET_HAPPY));
-
-        reset_board(window_panel_at(window, PANEL_BOARD), am);
-        *game = game_restart(game, game->board.difficulty);
-      }
+      if (clicked_component->id == SC_BUTTON) new_game(window, game, am);
       break;
     case PANEL_MENU:
-      // 'destroy' the assets the menu consist of
-      for (size_t i = 0; i < clicked_panel->components_amount; i++) {
-        struct component *current = panel_component_at(clicked_panel, i);
-        if (!current) continue;
+      // change the game difficulty
+      *game = game_restart(game, clicked_component->id);
+      board_changed(game);
 
-        for (size_t j = 0; j < current->size; j++) {
-          am_return(am, &current->assets[j]);
+      reset_viewport(&game->board);
+      recreate_panels(window, game, am, font);
+      break;
+  }
+}
 
-#ifdef DEBUG
-#include <stdio.h>
-          printf("asset: {id: %s, ref_count: %d}\n",
-                 current->assets[j].id == ASSET_EMPTY ? "empty" : "?",
-                 current->assets[j].ref_count);
-#endif
-        }
-      }
+void on_game_replaced(struct window *restrict window,
+                      struct game *restrict game,
+                      struct assets_manager *restrict am,
+                      TigrFont *restrict font) {
+  if (!window || !game || !am) return;
 
-      // change the game difficulty
-      *game = game_restart(game, clicked_component->id);
+  if (!font) font = tfont;
 
-      // recreate all the panels to accommodate the above change
-      destroy_panels(window->panels, window->panels_amount);
-      if (!create_panels(window->panels, PANEL_AMOUNT, am, game, font)) {
-        game->state = STATE_INVALID;
-        return;
-      }
+  struct panel *stats = window_panel_at(window, PANEL_STATS);
+  if (stats) toggle_emoji(panel_component_at(stats, SC_BUTTON), am, ASSET_HAPPY);
+
+  board_changed(game);
+  reset_viewport(&game->board);
+  recreate_panels(window, game, am, font);
+}
+
+// scrolls the viewport just enough for the cursor to be on screen
+static void follow_cursor(void) {
+  if (cursor.visible) follow(cursor.row, cursor.col);
+}
+
+// a hidden cursor shows up at the top left corner of the viewport. returns whether it was visible already
+static bool show_cursor(void) {
+  if (cursor.visible) return true;
+
+  cursor = (struct cursor){.row = viewport.row, .col = viewport.col, .visible = true};
+  return false;
+}
+
+// moves the cursor by `rows` and `cols` cells, clamped to the board
+static void move_cursor(struct board const *restrict board, ptrdiff_t rows, ptrdiff_t cols) {
+  if (!show_cursor()) return;
+
+  ptrdiff_t row = (ptrdiff_t)cursor.row + rows;
+  ptrdiff_t col = (ptrdiff_t)cursor.col + cols;
+  cursor.row = row < 0 ? 0 : (size_t)row >= board_rows(board) ? board_rows(board) - 1 : (size_t)row;
+  cursor.col = col < 0 ? 0 : (size_t)col >= board_cols(board) ? board_cols(board) - 1 : (size_t)col;
+
+  follow_cursor();
+}
+
+void on_key(struct window *restrict window,
+            struct game *restrict game,
+            struct assets_manager *restrict am,
+            TigrFont *restrict font,
+            int key) {
+  if (!window || !game || !am) { return; }
+
+  Tigr *bmp = window->window;
+  struct board const *board = &game->board;
+
+  // arrows move the cursor a cell at a time, a page with shift held
+  ptrdiff_t rows = tigrKeyHeld(bmp, TK_SHIFT) ? (ptrdiff_t)viewport.rows : 1;
+  ptrdiff_t cols = tigrKeyHeld(bmp, TK_SHIFT) ? (ptrdiff_t)viewport.cols : 1;
+
+  unsigned zoom = viewport.zoom;
+  switch (key) {
+    case TK_UP:
+      move_cursor(board, -rows, 0);
+      break;
+    case TK_DOWN:
+      move_cursor(board, rows, 0);
+      break;
+    case TK_LEFT:
+      move_cursor(board, 0, -cols);
+      break;
+    case TK_RIGHT:
+      move_cursor(board, 0, cols);
+      break;
+    case TK_PAGEUP:
+      move_cursor(board, -(ptrdiff_t)viewport.rows, 0);
+      break;
+    case TK_PAGEDN:
+      move_cursor(board, (ptrdiff_t)viewport.rows, 0);
+      break;
+    case TK_HOME:
+      move_cursor(board, -(ptrdiff_t)cursor.row, -(ptrdiff_t)cursor.col);
+      break;
+    // the first press only shows where the cursor is
+    case TK_SPACE:
+    case TK_RETURN:
+      if (show_cursor()) act(game, MOVE_REVEAL, cursor.row, cursor.col);
+      break;
+    case 'F':
+      if (show_cursor()) act(game, MOVE_MARK, cursor.row, cursor.col);
+      break;
+    case 'C':
+      if (show_cursor()) act(game, MOVE_CHORD, cursor.row, cursor.col);
+      break;
+    case TK_F2:
+      new_game(window, game, am);
+      break;
+    case 'H':
+      ask_hint(game);
+      break;
+    case TK_MINUS:
+    case TK_PADSUB:
+      if (zoom + 1 < ZOOM_LEVELS) zoom++;
+      break;
+    case TK_EQUALS:
+    case TK_PADADD:
+      if (zoom > 0) zoom--;
+      break;
+    default:
+      break;
+  }
 
-      // sort of a hack. make the menu align with the navbar button
-      window->panels[PANEL_MENU]->x_offset = window_x_panel(window, window->panels[PANEL_NAVBAR]);
+  // the amount of visible cells and their size changed, the board panel has to be recreated
+  if (viewport_zoom(&viewport, zoom)) {
+    follow_cursor();
+    recreate_panels(window, game, am, font);
+  }
+}
+
+void on_input(struct window *restrict window,
+              struct game *restrict game,
+              struct assets_manager *restrict am,
+              TigrFont *restrict font,
+              struct input_event const *restrict event) {
+  if (!event) return;
+
+  switch (event->kind) {
+    case INPUT_PRESS:
+      on_mouse_click(window, game, am, font, event->mouse);
+      break;
+    case INPUT_RELEASE:
+      on_mouse_click(window, game, am, font, mouse_event_create(event->mouse.x, event->mouse.y, MOUSE_NONE));
+      break;
+    case INPUT_KEY_DOWN:
+      on_key(window, game, am, font, event->key);
+      break;
+    case INPUT_KEY_UP:
+    default:  // fallthrough
       break;
   }
 }
@@ -775,21 +1172,27 @@ void on_mouse_hover(struct window *restrict window,
   struct panel *hovered_panel = window_get_panel(window, mouse_event.x, mouse_event.y);
   if (!hovered_panel || hovered_panel->id != PANEL_MENU) { return; }
 
-  struct component *hovered_component = window_get_component(window, mouse_event.x, mouse_event.y);
+  struct component *hovered_component = window_get_component(window, am, mouse_event.x, mouse_event.y);
   if (!hovered_component) { return; }
 
   for (size_t i = 0; i < hovered_panel->components_amount; i++) {
     if (hovered_panel->components[i] == hovered_component) continue;
 
-    print_difficulty(hovered_panel->components[i]->assets->bmp, font, hovered_panel->components[i]->id);
+    struct component *current = hovered_panel->components[i];
+    print_difficulty(am_bitmap(am, component_asset_at(current, 0)), font, current->id);
+    am_refresh(am, component_asset_at(current, 0));
   }
 
-  tigrRect(hovered_component->assets->bmp,
-           0,
-           0,
-           hovered_component->assets->bmp->w,
-           hovered_component->assets->bmp->h,
-           tigrRGB(BLACK));
+  Tigr *hovered = am_bitmap(am, component_asset_at(hovered_component, 0));
+  if (!hovered) { return; }
+
+  tigrRect(hovered, 0, 0, hovered->w, hovered->h, tigrRGB(BLACK));
+  am_refresh(am, component_asset_at(hovered_component, 0));
+}
+
+void destroy_hints(void) {
+  hints_destroy(hint.engine);
+  hint = (struct hint_overlay){0};
 }
 
 void alert(TigrFont *restrict font, char const *fmt, ...) {
@@ -804,14 +1207,19 @@ void alert(TigrFont *restrict font, char const *fmt, ...) {
   va_start(args, fmt);
 
   if (!vsprintf_wrapper(buf, sizeof buf, fmt, args)) {
-    vprintf(fmt, args);
+    vfprintf(stderr, fmt, args);
     va_end(args);
     return;
   }
 
+#ifdef TIGR_HEADLESS
+  // nobody would ever close an offscreen alert
+  Tigr *alert_window = NULL;
+#else
   Tigr *alert_window = tigrWindow(ALERT_WIDTH, ALERT_HEIGHT, "Alert", TIGR_AUTO | TIGR_2X);
+#endif
   if (!alert_window) {
-    printf("%s\n", buf);
+    fprintf(stderr, "%s\n", buf);
     return;
   }
 
@@ -0,0 +1,84 @@
+#include "viewport.h"
+#include "properties.h"
+
+static size_t fit(size_t cells, unsigned pixels, unsigned cell_size) {
+  size_t fitting = pixels / cell_size;
+  return cells < fitting ? cells : fitting;
+}
+
+static size_t clamp(ptrdiff_t value, size_t max) {
+  if (value < 0) return 0;
+  return (size_t)value > max ? max : (size_t)value;
+}
+
+// recomputes the amount of visible cells and pulls the origin back onto the board
+static void viewport_fit(struct viewport *restrict viewport) {
+  unsigned cell_size = viewport_cell_size(viewport);
+
+  viewport->rows = fit(viewport->board_rows, viewport->height, cell_size);
+  viewport->cols = fit(viewport->board_cols, viewport->width, cell_size);
+
+  if (viewport->row > viewport->board_rows - viewport->rows) viewport->row = viewport->board_rows - viewport->rows;
+  if (viewport->col > viewport->board_cols - viewport->cols) viewport->col = viewport->board_cols - viewport->cols;
+}
+
+struct viewport viewport_create(size_t board_rows, size_t board_cols, unsigned width, unsigned height, unsigned zoom) {
+  struct viewport viewport = {.board_rows = board_rows,
+                              .board_cols = board_cols,
+                              .width = width,
+                              .height = height,
+                              .zoom = zoom < ZOOM_LEVELS ? zoom : ZOOM_LEVELS - 1};
+
+  viewport_fit(&viewport);
+  return viewport;
+}
+
+unsigned viewport_cell_size(struct viewport const *restrict viewport) {
+  if (!viewport) return TILE_SIZE;
+
+  return TILE_SIZE >> viewport->zoom;
+}
+
+bool viewport_scroll(struct viewport *restrict viewport, ptrdiff_t rows, ptrdiff_t cols) {
+  if (!viewport) return false;
+
+  size_t row = clamp((ptrdiff_t)viewport->row + rows, viewport->board_rows - viewport->rows);
+  size_t col = clamp((ptrdiff_t)viewport->col + cols, viewport->board_cols - viewport->cols);
+
+  if (row == viewport->row && col == viewport->col) return false;
+
+  viewport->row = row;
+  viewport->col = col;
+  return true;
+}
+
+bool viewport_zoom(struct viewport *restrict viewport, unsigned zoom) {
+  if (!viewport || zoom >= ZOOM_LEVELS || zoom == viewport->zoom) return false;
+
+  // nothing more to see
+  bool whole_board = viewport->rows == viewport->board_rows && viewport->cols == viewport->board_cols;
+  if (zoom > viewport->zoom && whole_board) return false;
+
+  size_t center_row = viewport->row + viewport->rows / 2;
+  size_t center_col = viewport->col + viewport->cols / 2;
+
+  viewport->zoom = zoom;
+  viewport_fit(viewport);
+
+  viewport->row = 0;
+  viewport->col = 0;
+  viewport_scroll(viewport,
+                  (ptrdiff_t)center_row - (ptrdiff_t)(viewport->rows / 2),
+                  (ptrdiff_t)center_col - (ptrdiff_t)(viewport->cols / 2));
+  return true;
+}
+
+bool viewport_cell(struct viewport const *restrict viewport, size_t idx, size_t *restrict row, size_t *restrict col) {
+  if (!viewport || !row || !col) return false;
+
+  if (!viewport->cols || idx >= viewport->rows * viewport->cols) return false;
+
+  *row = viewport->row + idx / viewport->cols;
+  *col = viewport->col + idx % viewport->cols;
+  return true;
+}
@@ -0,0 +1,14 @@
+# `cmake -DFIRST=<program> -DSECOND=<program> -P compare_outputs.cmake` fails unless both programs succeed and print
+# the same
+foreach(program IN ITEMS FIRST SECOND)
+  execute_process(COMMAND ${${program}} OUTPUT_VARIABLE ${program}_OUTPUT RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${${program}} failed: ${result}")
+  endif()
+endforeach()
+
+if(NOT FIRST_OUTPUT STREQUAL SECOND_OUTPUT)
+  file(WRITE ${FIRST}.out "${FIRST_OUTPUT}")
+  file(WRITE ${SECOND}.out "${SECOND_OUTPUT}")
+  message(FATAL_ERROR "${FIRST} and ${SECOND} differ, see ${FIRST}.out and ${SECOND}.out")
+endif()
@@ -0,0 +1,204 @@
+/*
+  plays the same random moves on seeded boards and prints what every move did: the changes it recorded and a hash of
+  every cell. it's built once per engine, `engines_agree` checks both print the same. along the way it checks the
+  changes against the cells that actually changed, and that a board survives `board_pack` and `board_unpack`
+
+  usage: engine_trace
+*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board.h"
+
+#define MOVES 300
+
+struct trace_size {
+  size_t rows;
+  size_t cols;
+  size_t mines;
+};
+
+static struct trace_size const sizes[] = {
+    {9, 9, 10},
+    {16, 16, 40},
+    {16, 30, 99},
+    {1, 1, 0},
+    {1, 40, 5},
+    {37, 65, 400},   // rows a bitset word and a bit wide
+    {100, 100, 20},  // floods more cells than the changes hold
+};
+
+#define SEEDS 8
+
+static bool failed = false;
+
+static void fail(char const *what, size_t size, uint64_t seed, size_t move) {
+  fprintf(stderr, "size %zu, seed %llu, move %zu: %s\n", size, (unsigned long long)seed, move, what);
+  failed = true;
+}
+
+// the trace's own generator, the same on both engines whatever they draw from theirs
+static uint64_t next(uint64_t *restrict state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15u);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+  return z ^ (z >> 31);
+}
+
+static unsigned char code(struct cell cell) {
+  return cell.mine | cell.revealed << 1 | cell.mark << 2 | cell.adjacent_mines << 4;
+}
+
+// fnv-1a over every cell
+static uint64_t hash_cells(struct board const *restrict board, unsigned char *restrict cells) {
+  uint64_t hash = 0xcbf29ce484222325u;
+  for (size_t row = 0; row < board_rows(board); row++) {
+    for (size_t col = 0; col < board_cols(board); col++) {
+      unsigned char cell = code(board_cell(board, row, col));
+      cells[row * board_cols(board) + col] = cell;
+      hash = (hash ^ cell) * 0x100000001b3u;
+    }
+  }
+  return hash;
+}
+
+static int by_index(void const *a, void const *b) {
+  size_t left = ((struct board_change const *)a)->index;
+  size_t right = ((struct board_change const *)b)->index;
+  return (left > right) - (left < right);
+}
+
+/* the changes must list every cell that changed, no other, each with what it is now. the engines may find them in a
+ * different order, so they're printed sorted */
+static void trace_changes(struct board *restrict board,
+                          unsigned char const *restrict before,
+                          unsigned char const *restrict after,
+                          size_t size,
+                          uint64_t seed,
+                          size_t move) {
+  struct board_delta const *delta = board_changes(board);
+  printf(" stale %d", delta->stale);
+  if (delta->stale) return;
+
+  struct board_change *changes = malloc((delta->size ? delta->size : 1) * sizeof *changes);
+  if (!changes) {
+    fail("out of memory", size, seed, move);
+    return;
+  }
+  memcpy(changes, delta->changes, delta->size * sizeof *changes);
+  qsort(changes, delta->size, sizeof *changes, by_index);
+
+  size_t listed = 0;
+  for (size_t i = 0; i < delta->size; i++) {
+    size_t index = changes[i].index;
+    if (i + 1 < delta->size && changes[i + 1].index == index) continue;
+
+    listed++;
+    printf(" %zu:%u", index, code(changes[i].cell));
+    if (code(changes[i].cell) != after[index]) fail("a change isn't what the cell is now", size, seed, move);
+  }
+
+  size_t changed = 0;
+  for (size_t index = 0; index < board_rows(board) * board_cols(board); index++) {
+    changed += before[index] != after[index];
+  }
+  if (changed != listed) fail("the changes miss a cell", size, seed, move);
+
+  free(changes);
+}
+
+static void check_pack(struct board *restrict board, unsigned char const *restrict cells, size_t size, uint64_t seed) {
+  size_t words = board_rows(board) * board_row_words(board) * 4;
+  uint64_t *bits = calloc(words, sizeof *bits);
+  struct board copy;
+  if (!bits || !board_create_custom(&copy, board_rows(board), board_cols(board), board_mines(board))) {
+    free(bits);
+    fail("out of memory", size, seed, MOVES);
+    return;
+  }
+
+  board_pack(board, bits);
+  if (!board_unpack(&copy, bits)) fail("a packed board doesn't unpack", size, seed, MOVES);
+
+  // unpacking counts the safe cells revealed, the moves above revealed mines as well
+  size_t safe = 0;
+  for (size_t row = 0; row < board_rows(board); row++) {
+    for (size_t col = 0; col < board_cols(board); col++) {
+      struct cell cell = board_cell(&copy, row, col);
+      if (code(cell) != cells[row * board_cols(board) + col]) {
+        fail("a cell differs once unpacked", size, seed, MOVES);
+        goto cleanup;
+      }
+      safe += cell.revealed && !cell.mine;
+    }
+  }
+  if (copy.revealed_cells != safe) fail("unpacking miscounts the revealed cells", size, seed, MOVES);
+
+cleanup:
+  board_destroy(&copy);
+  free(bits);
+}
+
+static void trace(size_t size, uint64_t seed) {
+  struct trace_size const *dims = &sizes[size];
+  struct board board;
+  unsigned char *before = malloc(dims->rows * dims->cols);
+  unsigned char *after = malloc(dims->rows * dims->cols);
+  if (!before || !after || !board_create_custom(&board, dims->rows, dims->cols, dims->mines)) {
+    free(before);
+    free(after);
+    fail("out of memory", size, seed, 0);
+    return;
+  }
+
+  board_reset_seeded(&board, seed);
+  printf("size %zu seed %llu hash %016llx\n",
+         size,
+         (unsigned long long)seed,
+         (unsigned long long)hash_cells(&board, before));
+
+  uint64_t state = seed;
+  for (size_t move = 0; move < MOVES; move++) {
+    size_t row = next(&state) % dims->rows;
+    size_t col = next(&state) % dims->cols;
+    unsigned kind = next(&state) % 8;
+
+    board_clear_changes(&board);
+    if (kind < 5) {
+      board_open(&board, row, col);
+    } else if (kind < 7) {
+      board_mark_cell(&board, row, col);
+    } else {
+      board_reveal_cell(&board, row, col);
+    }
+
+    uint64_t hash = hash_cells(&board, after);
+    printf("%zu %u (%zu, %zu) revealed %zu hash %016llx",
+           move,
+           kind,
+           row,
+           col,
+           board.revealed_cells,
+           (unsigned long long)hash);
+    trace_changes(&board, before, after, size, seed, move);
+    putchar('\n');
+
+    unsigned char *swap = before;
+    before = after;
+    after = swap;
+  }
+
+  check_pack(&board, before, size, seed);
+  board_destroy(&board);
+  free(before);
+  free(after);
+}
+
+int main(void) {
+  for (size_t size = 0; size < sizeof sizes / sizeof *sizes; size++) {
+    for (uint64_t seed = 1; seed <= SEEDS; seed++) trace(size, seed);
+  }
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
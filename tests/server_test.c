@@ -0,0 +1,185 @@
+/*
+  starts `minesweeper-server` and speaks its protocol (see server.h): pipelined and split requests, moves, new games,
+  and requests it has to refuse. the server has to stop cleanly on SIGTERM afterwards
+
+  usage: server_test <server binary> <socket path>
+*/
+#define _POSIX_C_SOURCE 200809L
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "game.h"
+#include "server.h"
+
+enum server_test_size {
+  CONNECT_ATTEMPTS = 200,  // 10ms apart
+  MAX_UPDATES = 1 << 16,
+};
+
+static bool failed = false;
+
+static void check(bool ok, char const *what) {
+  if (ok) return;
+
+  fprintf(stderr, "%s\n", what);
+  failed = true;
+}
+
+// the server's answer to a request, with the updates that followed it
+struct reply {
+  struct server_response response;
+  uint32_t updates[MAX_UPDATES];
+};
+
+static bool send_all(int fd, void const *buf, size_t size) {
+  for (size_t sent = 0; sent < size;) {
+    ssize_t got = send(fd, (char const *)buf + sent, size - sent, MSG_NOSIGNAL);
+    if (got <= 0) return false;
+    sent += (size_t)got;
+  }
+  return true;
+}
+
+static bool recv_all(int fd, void *buf, size_t size) {
+  for (size_t received = 0; received < size;) {
+    ssize_t got = recv(fd, (char *)buf + received, size - received, 0);
+    if (got <= 0) return false;
+    received += (size_t)got;
+  }
+  return true;
+}
+
+static bool receive(int fd, struct reply *restrict reply) {
+  if (!recv_all(fd, &reply->response, sizeof reply->response)) return false;
+  if (reply->response.cells > MAX_UPDATES) return false;
+  return recv_all(fd, reply->updates, reply->response.cells * sizeof *reply->updates);
+}
+
+static struct server_request request(enum server_op op, uint32_t first, uint32_t second, uint32_t third) {
+  return (struct server_request){.op = op, .args = {first, second, third}};
+}
+
+// the code the updates gave the cell at `index`, hidden if they didn't mention it
+static enum server_cell updated(struct reply const *restrict reply, uint32_t index) {
+  enum server_cell code = SERVER_CELL_HIDDEN;
+  for (uint32_t i = 0; i < reply->response.cells; i++) {
+    if (reply->updates[i] >> SERVER_CODE_BITS == index) code = reply->updates[i] & ((1u << SERVER_CODE_BITS) - 1);
+  }
+  return code;
+}
+
+static int connect_to(char const *path) {
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  if (strlen(path) >= sizeof address.sun_path) return -1;
+  strcpy(address.sun_path, path);
+
+  struct timespec pause = {.tv_nsec = 10 * 1000 * 1000};
+  for (int attempt = 0; attempt < CONNECT_ATTEMPTS; attempt++) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (!connect(fd, (struct sockaddr *)&address, sizeof address)) return fd;
+
+    close(fd);
+    nanosleep(&pause, NULL);
+  }
+  return -1;
+}
+
+static void converse(int fd, struct reply *restrict reply) {
+  // an open and an unknown op in a single write, answered in order
+  struct server_request both[2] = {request(SERVER_OPEN, 4, 4, 0), request(SERVER_OPS, 0, 0, 0)};
+  check(send_all(fd, both, sizeof both) && receive(fd, reply), "no response to the open");
+  check(reply->response.status == SERVER_OK, "the open failed");
+  check(reply->response.rows == 9 && reply->response.cols == 9 && reply->response.mines == 10, "not a classic game");
+  check(reply->response.state != STATE_INVALID, "the game is invalid");
+  check(updated(reply, 4 * 9 + 4) != SERVER_CELL_HIDDEN, "the opened cell is still hidden");
+  for (uint32_t i = 0; i < reply->response.cells; i++) {
+    check(reply->updates[i] >> SERVER_CODE_BITS < 9 * 9, "an update past the board");
+    check((reply->updates[i] & ((1u << SERVER_CODE_BITS) - 1)) < SERVER_CELL_HIDDEN, "an update hides a cell");
+  }
+
+  check(receive(fd, reply), "no response to the unknown op");
+  check(reply->response.status == SERVER_ERROR && !reply->response.cells, "an unknown op isn't refused");
+
+  // the cell is revealed already, or the game is over
+  struct server_request reopen = request(SERVER_OPEN, 4, 4, 0);
+  check(send_all(fd, &reopen, sizeof reopen) && receive(fd, reply), "no response to the second open");
+  check(reply->response.status == SERVER_IGNORED && !reply->response.cells, "a second open isn't ignored");
+
+  // a new game, its request split over two writes
+  struct server_request custom = request(SERVER_NEW, 5, 6, 3);
+  size_t half = sizeof custom / 2;
+  check(send_all(fd, &custom, half), "the first half isn't sent");
+  check(send_all(fd, (char const *)&custom + half, sizeof custom - half) && receive(fd, reply),
+        "no response to the new game");
+  check(reply->response.status == SERVER_OK && reply->response.state == STATE_PLAYING, "the new game failed");
+  check(reply->response.rows == 5 && reply->response.cols == 6, "the new game has another size");
+  check(reply->response.mines == 3 && !reply->response.cells, "the new game isn't hidden");
+
+  // a flag, then a question mark
+  struct server_request flag = request(SERVER_FLAG, 0, 0, 0);
+  check(send_all(fd, &flag, sizeof flag) && receive(fd, reply), "no response to the flag");
+  check(reply->response.status == SERVER_OK && reply->response.mines == 2, "the flag isn't counted");
+  check(reply->response.cells == 1 && updated(reply, 0) == SERVER_CELL_FLAG, "the flag isn't shown");
+
+  check(send_all(fd, &flag, sizeof flag) && receive(fd, reply), "no response to the question mark");
+  check(reply->response.mines == 3 && updated(reply, 0) == SERVER_CELL_QUESTION, "the question mark isn't shown");
+
+  struct server_request outside = request(SERVER_OPEN, 5, 0, 0);
+  check(send_all(fd, &outside, sizeof outside) && receive(fd, reply), "no response to the open past the board");
+  check(reply->response.status == SERVER_IGNORED && !reply->response.cells, "an open past the board isn't ignored");
+
+  // as many mines as cells can't be dealt, the game goes on
+  struct server_request crowded = request(SERVER_NEW, 2, 2, 4);
+  check(send_all(fd, &crowded, sizeof crowded) && receive(fd, reply), "no response to the crowded game");
+  check(reply->response.status == SERVER_ERROR, "a crowded game isn't refused");
+  check(reply->response.rows == 5 && reply->response.cols == 6, "a refused game replaced the last one");
+
+  struct server_request again = request(SERVER_NEW, 0, 0, 0);
+  check(send_all(fd, &again, sizeof again) && receive(fd, reply), "no response to the reset");
+  check(reply->response.status == SERVER_OK && reply->response.rows == 5 && reply->response.mines == 3,
+        "the reset has another size");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <server binary> <socket path>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  struct reply *reply = malloc(sizeof *reply);
+  if (!reply) return EXIT_FAILURE;
+
+  pid_t server = fork();
+  if (server < 0) {
+    free(reply);
+    return EXIT_FAILURE;
+  }
+  if (!server) {
+    execl(argv[1], argv[1], argv[2], (char *)NULL);
+    _exit(127);
+  }
+
+  int fd = connect_to(argv[2]);
+  check(fd >= 0, "can't connect");
+  if (fd >= 0) {
+    converse(fd, reply);
+    close(fd);
+  }
+
+  int status = 0;
+  kill(server, SIGTERM);
+  check(waitpid(server, &status, 0) == server && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS,
+        "the server didn't stop cleanly");
+
+  free(reply);
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,245 @@
+/*
+  saves games part way through, checks they load back the same, then checks that broken copies of them don't load
+
+  usage: snapshot_test <scratch path>
+*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "snapshot.h"
+
+static bool failed = false;
+
+static void check(bool ok, char const *what, size_t rows, size_t cols) {
+  if (ok) return;
+
+  fprintf(stderr, "%zux%zu: %s\n", rows, cols, what);
+  failed = true;
+}
+
+static unsigned char *read_file(char const *path, size_t *size) {
+  FILE *file = fopen(path, "rb");
+  if (!file) return NULL;
+
+  unsigned char *buf = NULL;
+  long length;
+  if (fseek(file, 0, SEEK_END) || (length = ftell(file)) <= 0 || fseek(file, 0, SEEK_SET)) goto close;
+
+  *size = (size_t)length;
+  buf = malloc(*size);
+  if (buf && fread(buf, *size, 1, file) != 1) {
+    free(buf);
+    buf = NULL;
+  }
+
+close:
+  fclose(file);
+  return buf;
+}
+
+static bool write_file(char const *path, unsigned char const *buf, size_t size) {
+  FILE *file = fopen(path, "wb");
+  if (!file) return false;
+
+  bool written = fwrite(buf, size, 1, file) == 1;
+  return !fclose(file) && written;
+}
+
+// opens a few safe cells and flags a few mines, so every plane of the snapshot holds something
+static void play(struct game *restrict game) {
+  struct board const *board = &game->board;
+  size_t opened = 0, flagged = 0;
+
+  for (size_t row = 0; row < board_rows(board); row++) {
+    for (size_t col = 0; col < board_cols(board); col++) {
+      struct cell cell = board_cell(board, row, col);
+      if (cell.revealed || game->state != STATE_PLAYING) continue;
+
+      if (!cell.mine && opened < 3) {
+        opened += game_step(game, (struct game_action){.kind = MOVE_REVEAL, .row = row, .col = col});
+      } else if (cell.mine && flagged < 4) {
+        // once a flag, twice a question mark
+        size_t marks = flagged % 2 + 1;
+        for (size_t i = 0; i < marks; i++) {
+          game_step(game, (struct game_action){.kind = MOVE_MARK, .row = row, .col = col});
+        }
+        flagged++;
+      }
+    }
+  }
+}
+
+static void check_same(struct game const *restrict saved, struct game const *restrict loaded) {
+  struct board const *expected = &saved->board;
+  struct board const *board = &loaded->board;
+  size_t rows = board_rows(expected), cols = board_cols(expected);
+
+  check(loaded->state == STATE_PLAYING, "doesn't load", rows, cols);
+  if (loaded->state != STATE_PLAYING) return;
+
+  check(board_rows(board) == rows && board_cols(board) == cols, "the size differs", rows, cols);
+  check(board_mines(board) == board_mines(expected), "the mines differ", rows, cols);
+  check(board->seed == expected->seed && board->difficulty == expected->difficulty, "the deal differs", rows, cols);
+  check(board->revealed_cells == expected->revealed_cells, "the revealed cells differ", rows, cols);
+  check(loaded->mines == saved->mines, "the mines left differ", rows, cols);
+  check(game_elapsed(loaded) >= game_elapsed(saved), "the clock went back", rows, cols);
+
+  for (size_t row = 0; row < rows; row++) {
+    for (size_t col = 0; col < cols; col++) {
+      struct cell left = board_cell(board, row, col);
+      struct cell right = board_cell(expected, row, col);
+      if (memcmp(&left, &right, sizeof left)) {
+        check(false, "a cell differs", rows, cols);
+        return;
+      }
+    }
+  }
+}
+
+// a copy of the snapshot in `buf` broken by `breaking` mustn't load
+static void check_rejected(char const *path,
+                           unsigned char const *buf,
+                           size_t size,
+                           void (*breaking)(unsigned char *restrict copy, size_t *restrict size),
+                           char const *what) {
+  struct snapshot_header header;
+  memcpy(&header, buf, sizeof header);
+
+  unsigned char *copy = malloc(size);
+  if (!copy) {
+    check(false, "out of memory", header.rows, header.cols);
+    return;
+  }
+  memcpy(copy, buf, size);
+  breaking(copy, &size);
+
+  struct game game = write_file(path, copy, size) ? snapshot_load(path) : (struct game){.state = STATE_PLAYING};
+  check(game.state == STATE_INVALID, what, header.rows, header.cols);
+  game_destroy(&game);
+  free(copy);
+}
+
+static struct snapshot_header *header_of(unsigned char *restrict copy) {
+  return (struct snapshot_header *)copy;
+}
+
+static uint64_t *plane(unsigned char *restrict copy, size_t index) {
+  struct snapshot_header const *header = header_of(copy);
+  uint64_t *planes = (uint64_t *)(copy + sizeof *header);
+  return planes + index * header->rows * ((header->cols + SNAPSHOT_WORD_BITS - 1) / SNAPSHOT_WORD_BITS);
+}
+
+static void truncate_one(unsigned char *restrict copy, size_t *restrict size) {
+  (void)copy;
+  (*size)--;
+}
+
+static void bad_magic(unsigned char *restrict copy, size_t *restrict size) {
+  (void)size;
+  header_of(copy)->magic[0] ^= 1;
+}
+
+static void bad_difficulty(unsigned char *restrict copy, size_t *restrict size) {
+  (void)size;
+  header_of(copy)->difficulty = header_of(copy)->difficulty == MS_CLASSIC ? MS_EXPERT : MS_CLASSIC;
+}
+
+static void bad_mines_left(unsigned char *restrict copy, size_t *restrict size) {
+  (void)size;
+  header_of(copy)->mines_left++;
+}
+
+// a mine moved past the last column of the first row, so there are as many as the header says
+static void padding_mine(unsigned char *restrict copy, size_t *restrict size) {
+  (void)size;
+  uint64_t *mines = plane(copy, 0);
+  size_t words = (header_of(copy)->cols + SNAPSHOT_WORD_BITS - 1) / SNAPSHOT_WORD_BITS;
+
+  size_t word = 0;
+  while (!mines[word]) word++;
+  mines[word] &= mines[word] - 1;
+  mines[words - 1] |= UINT64_C(1) << (SNAPSHOT_WORD_BITS - 1);
+}
+
+// more mines than the header says
+static void extra_mine(unsigned char *restrict copy, size_t *restrict size) {
+  (void)size;
+  uint64_t *mines = plane(copy, 0);
+  for (size_t bit = 0; bit < header_of(copy)->cols; bit++) {
+    if (!(mines[0] >> bit & 1)) {
+      mines[0] |= UINT64_C(1) << bit;
+      return;
+    }
+  }
+}
+
+// a mark of 3 on the first cell
+static void bad_mark(unsigned char *restrict copy, size_t *restrict size) {
+  (void)size;
+  plane(copy, 2)[0] |= 1;
+  plane(copy, 3)[0] |= 1;
+}
+
+// the first cell both revealed and flagged
+static void marked_revealed(unsigned char *restrict copy, size_t *restrict size) {
+  (void)size;
+  plane(copy, 1)[0] |= 1;
+  plane(copy, 2)[0] |= 1;
+  plane(copy, 3)[0] &= ~UINT64_C(1);
+}
+
+static void round_trip(struct game game, char const *path) {
+  struct board const *board = &game.board;
+  size_t rows = board_rows(board), cols = board_cols(board);
+  if (game.state != STATE_PLAYING || !board_reset_seeded(&game.board, rows * cols)) {
+    check(false, "out of memory", rows, cols);
+    game_destroy(&game);
+    return;
+  }
+
+  // a stopped clock, so the loaded game's can be compared to it
+  play(&game);
+  game_pause(&game);
+  check(snapshot_save(&game, path), "doesn't save", rows, cols);
+
+  struct game loaded = snapshot_load(path);
+  check_same(&game, &loaded);
+  game_destroy(&loaded);
+
+  size_t size = 0;
+  unsigned char *buf = read_file(path, &size);
+  check(buf != NULL, "can't be read back", rows, cols);
+  if (buf) {
+    check_rejected(path, buf, size, truncate_one, "loads truncated");
+    check_rejected(path, buf, size, bad_magic, "loads with another magic");
+    check_rejected(path, buf, size, bad_difficulty, "loads with a difficulty of another size");
+    check_rejected(path, buf, size, bad_mines_left, "loads with a wrong mines counter");
+    check_rejected(path, buf, size, padding_mine, "loads with a mine in the padding");
+    check_rejected(path, buf, size, extra_mine, "loads with more mines than it says");
+    check_rejected(path, buf, size, bad_mark, "loads with an unknown mark");
+    check_rejected(path, buf, size, marked_revealed, "loads with a revealed cell marked");
+  }
+
+  free(buf);
+  remove(path);
+  game_destroy(&game);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <scratch path>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  round_trip(game_create(MS_CLASSIC), argv[1]);
+  round_trip(game_create(MS_EXPERT), argv[1]);
+  round_trip(game_create_custom(70, 130, 900), argv[1]);
+
+  struct game missing = snapshot_load(argv[1]);
+  check(missing.state == STATE_INVALID, "loads a file that isn't there", 0, 0);
+  game_destroy(&missing);
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
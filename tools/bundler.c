@@ -0,0 +1,85 @@
+/*
+  build step: decodes the png resources once and emits them as a c source holding raw RGBA pixels, so the game can
+  start without touching the disk or inflating anything
+
+  usage: bundler <output.c> <resources root> <relative path>...
+*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "tigr.h"
+
+#define BYTES_PER_LINE 24
+
+static char path_buf[4096];
+
+static char const *join(char const *root, char const *relative) {
+  if (snprintf(path_buf, sizeof path_buf, "%s/%s", root, relative) >= (int)sizeof path_buf) return NULL;
+  return path_buf;
+}
+
+static bool emit_pixels(FILE *out, size_t idx, Tigr const *bmp) {
+  fprintf(out, "static unsigned char const pixels_%zu[] = {", idx);
+
+  unsigned char const *bytes = (unsigned char const *)bmp->pix;
+  size_t size = (size_t)bmp->w * bmp->h * sizeof *bmp->pix;
+  for (size_t i = 0; i < size; i++) {
+    if (i % BYTES_PER_LINE == 0) fputs("\n ", out);
+    fprintf(out, " %u,", bytes[i]);
+  }
+
+  return fputs("\n};\n\n", out) >= 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 4) {
+    fprintf(stderr, "usage: %s <output.c> <resources root> <relative path>...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  FILE *out = fopen(argv[1], "w");
+  if (!out) {
+    fprintf(stderr, "failed to open '%s'\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  fputs("// generated by tools/bundler.c. do not edit\n#include \"bundle.h\"\n\n", out);
+
+  size_t amount = argc - 3;
+  int *widths = calloc(amount + 1, sizeof *widths);
+  int *heights = calloc(amount + 1, sizeof *heights);
+  if (!widths || !heights) goto cleanup;
+
+  for (size_t i = 0; i < amount; i++) {
+    char const *path = join(argv[2], argv[i + 3]);
+    Tigr *bmp = path ? tigrLoadImage(path) : NULL;
+    if (!bmp) {
+      fprintf(stderr, "failed to decode '%s'\n", argv[i + 3]);
+      goto cleanup;
+    }
+
+    widths[i] = bmp->w;
+    heights[i] = bmp->h;
+    bool emitted = emit_pixels(out, i, bmp);
+    tigrFree(bmp);
+
+    if (!emitted) goto cleanup;
+  }
+
+  fputs("struct bundle_entry const bundle_entries[] = {\n", out);
+  for (size_t i = 0; i < amount; i++) {
+    fprintf(out, "  {\"%s\", %d, %d, pixels_%zu},\n", argv[i + 3], widths[i], heights[i], i);
+  }
+  fprintf(out, "};\n\nsize_t const bundle_entries_amount = %zu;\n", amount);
+
+  free(widths);
+  free(heights);
+  return fclose(out) ? EXIT_FAILURE : EXIT_SUCCESS;
+
+cleanup:
+  free(widths);
+  free(heights);
+  fclose(out);
+  remove(argv[1]);
+  return EXIT_FAILURE;
+}
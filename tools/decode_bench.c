@@ -0,0 +1,151 @@
+/*
+  times tigr's png decoder: the whole of `tigrLoadImageMem`, and `tigrInflate` alone on the image's joined IDAT
+  chunks. each is run `runs` times per file, the best and the average run are reported in microseconds
+
+  usage: decode_bench <runs> <png>...
+*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tigr.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define USEC_PER_SEC 1000000.0
+
+static double now_us(void) {
+#ifdef _WIN32
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (double)counter.QuadPart * USEC_PER_SEC / (double)frequency.QuadPart;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec * USEC_PER_SEC + (double)now.tv_nsec / 1000.0;
+#endif
+}
+
+static uint32_t get32(unsigned char const *bytes) {
+  return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | bytes[3];
+}
+
+static unsigned char *read_file(char const *path, long *size) {
+  FILE *file = fopen(path, "rb");
+  if (!file) return NULL;
+
+  unsigned char *buf = NULL;
+  if (fseek(file, 0, SEEK_END) || (*size = ftell(file)) <= 0 || fseek(file, 0, SEEK_SET)) goto close;
+
+  buf = malloc(*size);
+  if (buf && fread(buf, *size, 1, file) != 1) {
+    free(buf);
+    buf = NULL;
+  }
+
+close:
+  fclose(file);
+  return buf;
+}
+
+// the zlib stream of the png, its IDAT chunks joined, and the size of the filtered rows it inflates to
+struct stream {
+  unsigned char *data;
+  unsigned size;
+  unsigned inflated;
+};
+
+static bool join_idat(unsigned char const *png, long size, struct stream *restrict stream) {
+  static unsigned char const bits_per_pixel[] = {[0] = 1, [2] = 3, [3] = 1, [4] = 2, [6] = 4};
+
+  *stream = (struct stream){0};
+  for (long at = 8; at + 12 <= size;) {
+    uint32_t length = get32(png + at);
+    unsigned char const *type = png + at + 4;
+    unsigned char const *body = png + at + 8;
+    if (length > (uint32_t)(size - at - 12)) break;
+
+    if (!memcmp(type, "IHDR", 4) && length >= 13 && body[9] <= 6) {
+      uint32_t bits = bits_per_pixel[body[9]] * body[8];
+      stream->inflated = get32(body + 4) * (1 + (get32(body) * bits + 7) / 8);
+    } else if (!memcmp(type, "IDAT", 4)) {
+      unsigned char *data = realloc(stream->data, stream->size + length);
+      if (!data) break;
+
+      memcpy(data + stream->size, body, length);
+      stream->data = data;
+      stream->size += length;
+    }
+    at += 12 + (long)length;
+  }
+
+  // the zlib header and adler checksum aren't tigrInflate's
+  return stream->data && stream->size >= 6 && stream->inflated;
+}
+
+static void bench(char const *path, int runs) {
+  long size = 0;
+  unsigned char *png = read_file(path, &size);
+  struct stream stream = {0};
+  unsigned char *rows = NULL;
+  if (!png || !join_idat(png, size, &stream) || !(rows = malloc(stream.inflated))) {
+    fprintf(stderr, "failed to read '%s'\n", path);
+    goto cleanup;
+  }
+
+  double decode_best = 0, decode_total = 0;
+  double inflate_best = 0, inflate_total = 0;
+  for (int run = 0; run < runs; run++) {
+    double start = now_us();
+    Tigr *bmp = tigrLoadImageMem(png, (int)size);
+    double decode = now_us() - start;
+    if (!bmp) {
+      fprintf(stderr, "failed to decode '%s'\n", path);
+      goto cleanup;
+    }
+    tigrFree(bmp);
+
+    start = now_us();
+    int inflated = tigrInflate(rows, stream.inflated, stream.data + 2, stream.size - 6);
+    double inflate = now_us() - start;
+    if (!inflated) {
+      fprintf(stderr, "failed to inflate '%s'\n", path);
+      goto cleanup;
+    }
+
+    decode_total += decode;
+    inflate_total += inflate;
+    decode_best = !run || decode < decode_best ? decode : decode_best;
+    inflate_best = !run || inflate < inflate_best ? inflate : inflate_best;
+  }
+
+  printf("%s: decode %.1fus best, %.1fus average. inflate %.1fus best, %.1fus average\n",
+         path,
+         decode_best,
+         decode_total / runs,
+         inflate_best,
+         inflate_total / runs);
+
+cleanup:
+  free(rows);
+  free(stream.data);
+  free(png);
+}
+
+int main(int argc, char **argv) {
+  int runs = argc > 1 ? atoi(argv[1]) : 0;
+  if (argc < 3 || runs <= 0) {
+    fprintf(stderr, "usage: %s <runs> <png>...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  for (int i = 2; i < argc; i++) bench(argv[i], runs);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+/*
+  times following a board through its changes against rescanning it. random safe cells of a seeded board are opened
+  one at a time, after each the changes are applied onto a copy of the cells, then the whole board is rescanned with
+  `board_cell` into another and both copies are compared. the average milliseconds per move of either way are reported,
+  along with the moves whose changes were stale (rescanned either way) and the cells the copies disagreed on
+
+  usage: delta_bench <rows> <cols> <mines> <moves> [seed]
+*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "board.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define MSEC_PER_SEC 1000.0
+
+static double now_ms(void) {
+#ifdef _WIN32
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (double)counter.QuadPart * MSEC_PER_SEC / (double)frequency.QuadPart;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec * MSEC_PER_SEC + (double)now.tv_nsec / 1000000.0;
+#endif
+}
+
+// splitmix64, picks the cells to open
+static uint64_t next_random(uint64_t *restrict state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15u);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+  return z ^ (z >> 31);
+}
+
+static unsigned char code(struct cell cell) {
+  return cell.mine | cell.revealed << 1 | cell.mark << 2 | cell.adjacent_mines << 4;
+}
+
+static void rescan(struct board const *restrict board, unsigned char *restrict cells) {
+  for (size_t row = 0; row < board_rows(board); row++) {
+    for (size_t col = 0; col < board_cols(board); col++) {
+      cells[row * board_cols(board) + col] = code(board_cell(board, row, col));
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc < 5) {
+    fprintf(stderr, "usage: %s <rows> <cols> <mines> <moves> [seed]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  size_t rows = strtoull(argv[1], NULL, 10);
+  size_t cols = strtoull(argv[2], NULL, 10);
+  size_t mines = strtoull(argv[3], NULL, 10);
+  size_t moves = strtoull(argv[4], NULL, 10);
+  uint64_t seed = argc > 5 ? strtoull(argv[5], NULL, 10) : 1;
+
+  int status = EXIT_FAILURE;
+  struct board board;
+  if (!board_create_custom(&board, rows, cols, mines) || !board_reset_seeded(&board, seed)) {
+    fprintf(stderr, "can't create a %zux%zu board with %zu mines\n", rows, cols, mines);
+    return status;
+  }
+
+  unsigned char *followed = malloc(rows * cols);
+  unsigned char *scanned = malloc(rows * cols);
+  if (!followed || !scanned) goto cleanup;
+  rescan(&board, followed);
+
+  double delta_total = 0, rescan_total = 0;
+  size_t played = 0, stale = 0, mismatches = 0;
+  uint64_t state = seed;
+  for (size_t attempt = 0; played < moves && attempt < moves * 64; attempt++) {
+    size_t row = next_random(&state) % rows;
+    size_t col = next_random(&state) % cols;
+    struct cell cell = board_cell(&board, row, col);
+    if (cell.mine || cell.revealed) continue;
+
+    double start = now_ms();
+    board_clear_changes(&board);
+    board_open(&board, row, col);
+
+    struct board_delta const *delta = board_changes(&board);
+    if (delta->stale) {
+      stale++;
+      rescan(&board, followed);
+    } else {
+      for (size_t i = 0; i < delta->size; i++) followed[delta->changes[i].index] = code(delta->changes[i].cell);
+    }
+    delta_total += now_ms() - start;
+
+    start = now_ms();
+    rescan(&board, scanned);
+    rescan_total += now_ms() - start;
+
+    for (size_t i = 0; i < rows * cols; i++) mismatches += followed[i] != scanned[i];
+    played++;
+  }
+
+  printf("%zux%zu, %zu mines, %zu moves (%zu stale): delta %.3fms per move, rescan %.3fms per move, %zu mismatches\n",
+         rows,
+         cols,
+         mines,
+         played,
+         stale,
+         played ? delta_total / played : 0,
+         played ? rescan_total / played : 0,
+         mismatches);
+  status = mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+
+cleanup:
+  free(followed);
+  free(scanned);
+  board_destroy(&board);
+  return status;
+}